@@ -1,10 +1,12 @@
 #include <cuda.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "conserv_kernels.cu"
 #include "conserv_kernels_wrappers.cu"
 //#include "conserv_kernels_wrappers.cu"
 #include "time_integrator.cu"
+#include "conserv_mesh.cu"
 #include "../quadrature.cu"
 #include "../basis.cu"
 
@@ -115,6 +117,61 @@ void checkCudaError(const char *message)
     }
 }
 
+/* sort sides
+ *
+ * groups the sides into [interior | reflecting | outflow | inflow] without
+ * changing their order within each group, so the threads of a warp all take
+ * the same path through eval_left_right.
+ */
+void sort_sides(int num_elem, int num_sides,
+                int *left_side_number, int *right_side_number,
+                double *sides_x1, double *sides_y1,
+                double *sides_x2, double *sides_y2,
+                int *elem_s1, int *elem_s2, int *elem_s3,
+                int *left_elem, int *right_elem) {
+    int i, k, pos;
+    int *side_order = (int *) malloc(num_sides * sizeof(int));
+    int *new_side   = (int *) malloc(num_sides * sizeof(int));
+    double *tmp     = (double *) malloc(num_sides * sizeof(double));
+    int *itmp       = (int *) tmp;
+
+    double *side_doubles[4] = {sides_x1, sides_y1, sides_x2, sides_y2};
+    int *side_ints[4] = {left_side_number, right_side_number, left_elem, right_elem};
+    int *elem_s[3] = {elem_s1, elem_s2, elem_s3};
+
+    pos = 0;
+    for (k = 0; k < 4; k++) {
+        for (i = 0; i < num_sides; i++) {
+            if ((k == 0 && right_elem[i] >= 0) || right_elem[i] == -k) {
+                side_order[pos] = i;
+                new_side[i] = pos++;
+            }
+        }
+    }
+
+    for (k = 0; k < 4; k++) {
+        for (i = 0; i < num_sides; i++) {
+            tmp[i] = side_doubles[k][side_order[i]];
+        }
+        memcpy(side_doubles[k], tmp, num_sides * sizeof(double));
+    }
+    for (k = 0; k < 4; k++) {
+        for (i = 0; i < num_sides; i++) {
+            itmp[i] = side_ints[k][side_order[i]];
+        }
+        memcpy(side_ints[k], itmp, num_sides * sizeof(int));
+    }
+    for (k = 0; k < 3; k++) {
+        for (i = 0; i < num_elem; i++) {
+            elem_s[k][i] = new_side[elem_s[k][i]];
+        }
+    }
+
+    free(side_order);
+    free(new_side);
+    free(tmp);
+}
+
 void read_mesh(FILE *mesh_file, 
               int *num_sides,
               int *num_elem,
@@ -131,6 +188,24 @@ void read_mesh(FILE *mesh_file,
     char line[1000];
     // stores the number of sides this element has.
 
+    // gmsh meshes are read directly, without genmesh.py
+    if (is_gmsh_mesh(mesh_file)) {
+        read_gmsh(mesh_file, num_elem, num_sides,
+                  V1x, V1y, V2x, V2y, V3x, V3y,
+                  left_side_number, right_side_number,
+                  sides_x1, sides_y1,
+                  sides_x2, sides_y2,
+                  elem_s1, elem_s2, elem_s3,
+                  left_elem, right_elem);
+        sort_sides(*num_elem, *num_sides,
+                   *left_side_number, *right_side_number,
+                   *sides_x1, *sides_y1,
+                   *sides_x2, *sides_y2,
+                   *elem_s1, *elem_s2, *elem_s3,
+                   *left_elem, *right_elem);
+        return;
+    }
+
     fgets(line, 1000, mesh_file);
     sscanf(line, "%i", num_elem);
     *V1x = (double *) malloc(*num_elem * sizeof(double));
@@ -381,6 +456,7 @@ void usage_error() {
     printf(" Options: [-n] Order of polynomial approximation.\n");
     printf("          [-t] Number of timesteps.\n");
     printf("          [-d] Debug.\n");
+    printf(" MESH may be a mesh made by genmesh.py or a gmsh 2.2 mesh (ascii or binary).\n");
 }
 
 int get_input(int argc, char *argv[],
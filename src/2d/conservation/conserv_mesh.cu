@@ -0,0 +1,425 @@
+/* conserv_mesh.cu
+ *
+ * reads gmsh 2.2 meshes (ascii or binary) directly, so they don't have to go
+ * through genmesh.py first. the sides are found by looking up each element
+ * side in a hash table keyed on its pair of node numbers. this is plain c and
+ * the cpu solver includes it from its mesh.c, so both read gmsh meshes the
+ * same way.
+ */
+
+/* hash key
+ *
+ * mixes the bits of a 64 bit key (splitmix64 finalizer).
+ */
+unsigned long long hash_key(unsigned long long key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+/* hash table size
+ *
+ * returns a power of two at least twice as big as n so the open addressing
+ * tables stay at most half full.
+ */
+int hash_table_size(int n) {
+    int size = 16;
+    while (size < 2 * n) {
+        size *= 2;
+    }
+    return size;
+}
+
+/* edge table
+ *
+ * open addressing hash table from a side (pair of vertex indices, in either
+ * order) to an int. empty slots have the value -1.
+ */
+typedef struct {
+    int size;
+    unsigned long long *keys;
+    int *values;
+} edge_table;
+
+void edge_table_init(edge_table *table, int num_edges) {
+    int i;
+
+    table->size   = hash_table_size(num_edges);
+    table->keys   = (unsigned long long *) malloc(table->size * sizeof(unsigned long long));
+    table->values = (int *) malloc(table->size * sizeof(int));
+
+    for (i = 0; i < table->size; i++) {
+        table->values[i] = -1;
+    }
+}
+
+void edge_table_free(edge_table *table) {
+    free(table->keys);
+    free(table->values);
+}
+
+/* edge key
+ *
+ * canonicalizes the side as (smaller vertex, larger vertex).
+ */
+unsigned long long edge_key(int a, int b) {
+    if (a > b) {
+        return ((unsigned long long) b << 32) | (unsigned int) a;
+    }
+    return ((unsigned long long) a << 32) | (unsigned int) b;
+}
+
+/* edge slot
+ *
+ * returns the slot holding side (a, b), or the empty slot where it goes.
+ * to insert, set both keys[slot] and values[slot].
+ */
+int edge_slot(edge_table *table, int a, int b) {
+    unsigned long long key = edge_key(a, b);
+    int slot = hash_key(key) & (table->size - 1);
+
+    // linear probing until we find this side or an empty slot
+    while (table->values[slot] != -1 && table->keys[slot] != key) {
+        slot = (slot + 1) & (table->size - 1);
+    }
+
+    return slot;
+}
+
+/* build sides
+ *
+ * creates the sides from the vertex indices of each element. elem_v holds
+ * the three vertex indices of each element (side 0 is v1 -> v2, side 1 is
+ * v2 -> v3 and side 2 is v3 -> v1) and elem_bc holds the right_elem value
+ * (-1, -2, -3) for boundary sides or 0 for everything else.
+ *
+ * sides are numbered in the same order the old linear scan produced them, so
+ * the first element to touch a side is its left element. returns num_sides.
+ */
+int build_sides(int num_elem, int *elem_v, int *elem_bc,
+                double *V1x, double *V1y,
+                double *V2x, double *V2y,
+                double *V3x, double *V3y,
+                int *left_side_number, int *right_side_number,
+                double *sides_x1, double *sides_y1,
+                double *sides_x2, double *sides_y2,
+                int *elem_s1, int *elem_s2, int *elem_s3,
+                int *left_elem, int *right_elem) {
+
+    int i, k, a, b, slot, side, numsides;
+    edge_table table;
+
+    double *x1[3] = {V1x, V2x, V3x};
+    double *y1[3] = {V1y, V2y, V3y};
+    double *x2[3] = {V2x, V3x, V1x};
+    double *y2[3] = {V2y, V3y, V1y};
+    int *elem_s[3] = {elem_s1, elem_s2, elem_s3};
+
+    edge_table_init(&table, 3 * num_elem);
+
+    numsides = 0;
+    for (i = 0; i < num_elem; i++) {
+        for (k = 0; k < 3; k++) {
+            a = elem_v[3 * i + k];
+            b = elem_v[3 * i + (k + 1) % 3];
+            slot = edge_slot(&table, a, b);
+
+            if (table.values[slot] != -1) {
+                // OK, we've added this side to some element before
+                side = table.values[slot];
+                right_elem[side] = i;
+                right_side_number[side] = k;
+                elem_s[k][i] = side;
+            } else {
+                // add it and make this the left element
+                table.keys[slot]   = edge_key(a, b);
+                table.values[slot] = numsides;
+
+                sides_x1[numsides] = x1[k][i];
+                sides_y1[numsides] = y1[k][i];
+                sides_x2[numsides] = x2[k][i];
+                sides_y2[numsides] = y2[k][i];
+
+                left_side_number[numsides] = k;
+                left_elem[numsides] = i;
+
+                // boundary sides never get a right element, but eval_surface
+                // still looks up the basis on the right side number
+                right_side_number[numsides] = 0;
+
+                // see if this is a boundary side
+                if (elem_bc[3 * i + k]) {
+                    right_elem[numsides] = elem_bc[3 * i + k];
+                }
+
+                elem_s[k][i] = numsides;
+                numsides++;
+            }
+        }
+    }
+
+    edge_table_free(&table);
+
+    return numsides;
+}
+
+/***********************
+ *
+ * GMSH MESHES
+ *
+ ***********************/
+
+/* number of nodes for each gmsh element type (1 through 15) */
+int gmsh_num_nodes[16] = {0, 2, 3, 4, 4, 8, 6, 5, 3, 6, 9, 10, 27, 18, 14, 1};
+
+/* is gmsh mesh
+ *
+ * checks whether the mesh file starts with a gmsh $MeshFormat section and
+ * rewinds it.
+ */
+int is_gmsh_mesh(FILE *mesh_file) {
+    char line[100];
+    int gmsh = fgets(line, sizeof(line), mesh_file) != NULL
+            && strncmp(line, "$MeshFormat", 11) == 0;
+    rewind(mesh_file);
+
+    return gmsh;
+}
+
+/* gmsh boundary
+ *
+ * maps the physical tag of a boundary side to its right_elem value.
+ */
+int gmsh_boundary(int tag) {
+    switch (tag) {
+        case 10000: return -1;
+        case 20000: return -2;
+        case 30000: return -3;
+    }
+    return 0;
+}
+
+/* read gmsh
+ *
+ * streams the $Nodes and $Elements sections of a gmsh 2.2 mesh (ascii or
+ * binary) straight into the mesh arrays, which are allocated here. triangles
+ * become elements and lines tagged 10000, 20000 or 30000 mark the boundary
+ * sides; everything else is skipped. the connectivity is built on the node
+ * numbers, so no preprocessing with genmesh.py is needed.
+ */
+int read_gmsh(FILE *mesh_file, int *num_elem, int *num_sides,
+              double **V1x, double **V1y,
+              double **V2x, double **V2y,
+              double **V3x, double **V3y,
+              int **left_side_number, int **right_side_number,
+              double **sides_x1, double **sides_y1,
+              double **sides_x2, double **sides_y2,
+              int **elem_s1,  int **elem_s2, int **elem_s3,
+              int **left_elem, int **right_elem) {
+
+    int i, j, k, n, binary, data_size, num_nodes, num_entries, max_node;
+    int id, type, num_tags, num_follow, tag, slot, tmp;
+    int header[3], data[64];
+    double version, J, xyz[3];
+    char line[1024], *token;
+
+    double *x = NULL, *y = NULL;
+    int *elem_v = NULL, *elem_bc;
+    int num_bound = 0;
+    edge_table boundary;
+
+    binary   = 0;
+    max_node = 0;
+    *num_elem = 0;
+
+    while (fgets(line, sizeof(line), mesh_file) != NULL) {
+        if (strncmp(line, "$MeshFormat", 11) == 0) {
+            fgets(line, sizeof(line), mesh_file);
+            sscanf(line, "%lf %i %i", &version, &binary, &data_size);
+            if ((int) version != 2 || data_size != sizeof(double)) {
+                printf("error: only gmsh 2.2 meshes with 8 byte doubles are supported.\n");
+                exit(0);
+            }
+            if (binary) {
+                // one int to check the endianness
+                fread(&tmp, sizeof(int), 1, mesh_file);
+                if (tmp != 1) {
+                    printf("error: binary gmsh mesh has the wrong endianness.\n");
+                    exit(0);
+                }
+            }
+        } else if (strncmp(line, "$Nodes", 6) == 0) {
+            fgets(line, sizeof(line), mesh_file);
+            sscanf(line, "%i", &num_nodes);
+
+            // node numbers are usually 1 through num_nodes, but don't count on it
+            max_node = num_nodes + 1;
+            x = (double *) malloc(max_node * sizeof(double));
+            y = (double *) malloc(max_node * sizeof(double));
+
+            for (i = 0; i < num_nodes; i++) {
+                if (binary) {
+                    fread(&id, sizeof(int), 1, mesh_file);
+                    fread(xyz, sizeof(double), 3, mesh_file);
+                } else {
+                    fgets(line, sizeof(line), mesh_file);
+                    sscanf(line, "%i %lf %lf", &id, &xyz[0], &xyz[1]);
+                }
+                if (id >= max_node) {
+                    max_node = 2 * id;
+                    x = (double *) realloc(x, max_node * sizeof(double));
+                    y = (double *) realloc(y, max_node * sizeof(double));
+                }
+                x[id] = xyz[0];
+                y[id] = xyz[1];
+            }
+        } else if (strncmp(line, "$Elements", 9) == 0) {
+            fgets(line, sizeof(line), mesh_file);
+            sscanf(line, "%i", &num_entries);
+
+            // every entry could be a triangle or a boundary side
+            elem_v = (int *) malloc(3 * num_entries * sizeof(int));
+            edge_table_init(&boundary, num_entries);
+
+            i = 0;
+            while (i < num_entries) {
+                if (binary) {
+                    // elements come in blocks of the same type
+                    fread(header, sizeof(int), 3, mesh_file);
+                    type       = header[0];
+                    num_follow = header[1];
+                    num_tags   = header[2];
+                    if (type < 1 || type > 15) {
+                        printf("error: unknown gmsh element type %i.\n", type);
+                        exit(0);
+                    }
+                    n = 1 + num_tags + gmsh_num_nodes[type];
+                    if (num_tags < 0 || n > 64) {
+                        printf("error: gmsh element with %i tags is too big.\n", num_tags);
+                        exit(0);
+                    }
+                } else {
+                    num_follow = 1;
+                }
+
+                for (j = 0; j < num_follow; j++, i++) {
+                    if (binary) {
+                        fread(data, sizeof(int), n, mesh_file);
+                    } else {
+                        // id type num_tags tags... nodes...
+                        fgets(line, sizeof(line), mesh_file);
+                        n = 0;
+                        for (token = strtok(line, " \t\r\n"); token && n < 64; 
+                             token = strtok(NULL, " \t\r\n")) {
+                            data[n++] = atoi(token);
+                        }
+                        type     = data[1];
+                        num_tags = data[2];
+                        // shift out the type and number of tags to match the binary layout
+                        for (k = 1; k + 2 < n; k++) {
+                            data[k] = data[k + 2];
+                        }
+                    }
+
+                    // the first tag is the physical tag
+                    tag = (num_tags > 0) ? data[1] : 0;
+
+                    if (type == 2) {
+                        for (k = 0; k < 3; k++) {
+                            elem_v[3 * *num_elem + k] = data[1 + num_tags + k];
+                        }
+                        (*num_elem)++;
+                    } else if (type == 1 && gmsh_boundary(tag)) {
+                        slot = edge_slot(&boundary, data[1 + num_tags], data[2 + num_tags]);
+                        boundary.keys[slot]   = edge_key(data[1 + num_tags], data[2 + num_tags]);
+                        boundary.values[slot] = tag;
+                        num_bound++;
+                    }
+                }
+            }
+        } else if (line[0] == '$' && strncmp(line, "$End", 4) != 0) {
+            // skip any other section
+            while (fgets(line, sizeof(line), mesh_file) != NULL && strncmp(line, "$End", 4) != 0);
+        }
+    }
+
+    if (!x || !elem_v) {
+        printf("error: no $Nodes or $Elements section in gmsh mesh.\n");
+        exit(0);
+    }
+
+    *V1x = (double *) malloc(*num_elem * sizeof(double));
+    *V1y = (double *) malloc(*num_elem * sizeof(double));
+    *V2x = (double *) malloc(*num_elem * sizeof(double));
+    *V2y = (double *) malloc(*num_elem * sizeof(double));
+    *V3x = (double *) malloc(*num_elem * sizeof(double));
+    *V3y = (double *) malloc(*num_elem * sizeof(double));
+
+    *elem_s1 = (int *) malloc(*num_elem * sizeof(int));
+    *elem_s2 = (int *) malloc(*num_elem * sizeof(int));
+    *elem_s3 = (int *) malloc(*num_elem * sizeof(int));
+
+    *left_side_number  = (int *) malloc(3 * *num_elem * sizeof(int));
+    *right_side_number = (int *) malloc(3 * *num_elem * sizeof(int));
+
+    *sides_x1   = (double *) malloc(3 * *num_elem * sizeof(double));
+    *sides_x2   = (double *) malloc(3 * *num_elem * sizeof(double));
+    *sides_y1   = (double *) malloc(3 * *num_elem * sizeof(double));
+    *sides_y2   = (double *) malloc(3 * *num_elem * sizeof(double));
+    *left_elem  = (int *) malloc(3 * *num_elem * sizeof(int));
+    *right_elem = (int *) malloc(3 * *num_elem * sizeof(int));
+
+    elem_bc = (int *) malloc(3 * *num_elem * sizeof(int));
+
+    for (i = 0; i < 3 * *num_elem; i++) {
+        (*right_elem)[i] = -1;
+    }
+
+    for (i = 0; i < *num_elem; i++) {
+        // enforce strictly positive jacobian by swapping vertices 1 and 2
+        J = (x[elem_v[3*i+1]] - x[elem_v[3*i]]) * (y[elem_v[3*i+2]] - y[elem_v[3*i]]) 
+          - (x[elem_v[3*i+2]] - x[elem_v[3*i]]) * (y[elem_v[3*i+1]] - y[elem_v[3*i]]);
+        if (J < 0) {
+            tmp = elem_v[3*i];
+            elem_v[3*i] = elem_v[3*i+1];
+            elem_v[3*i+1] = tmp;
+        }
+
+        (*V1x)[i] = x[elem_v[3*i+0]];
+        (*V1y)[i] = y[elem_v[3*i+0]];
+        (*V2x)[i] = x[elem_v[3*i+1]];
+        (*V2y)[i] = y[elem_v[3*i+1]];
+        (*V3x)[i] = x[elem_v[3*i+2]];
+        (*V3y)[i] = y[elem_v[3*i+2]];
+
+        // see which sides are boundaries
+        for (k = 0; k < 3; k++) {
+            elem_bc[3*i+k] = 0;
+            if (num_bound) {
+                slot = edge_slot(&boundary, elem_v[3*i+k], elem_v[3*i+(k+1)%3]);
+                if (boundary.values[slot] != -1) {
+                    elem_bc[3*i+k] = gmsh_boundary(boundary.values[slot]);
+                }
+            }
+        }
+    }
+
+    *num_sides = build_sides(*num_elem, elem_v, elem_bc,
+                             *V1x, *V1y, *V2x, *V2y, *V3x, *V3y,
+                             *left_side_number, *right_side_number,
+                             *sides_x1, *sides_y1,
+                             *sides_x2, *sides_y2,
+                             *elem_s1, *elem_s2, *elem_s3,
+                             *left_elem, *right_elem);
+
+    free(x);
+    free(y);
+    free(elem_v);
+    free(elem_bc);
+    edge_table_free(&boundary);
+
+    return 0;
+}
@@ -0,0 +1,337 @@
+#include <time.h>
+#include "euler.c"
+
+/* benchmark.h
+ *
+ * helpers shared by the benchmark_*.c programs. each of them includes this
+ * instead of euler.c.
+ */
+
+/* wall time
+ *
+ * seconds on the monotonic clock.
+ */
+double wall_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* benchmark args
+ *
+ * reads the -X VALUE options whose letters are in flags into the same place
+ * in values, which holds the defaults, and then the one mesh after them.
+ * returns 1 if there's an option that isn't in flags or not exactly one
+ * mesh, after printing usage, or if the mesh can't be read.
+ */
+int benchmark_args(int argc, char *argv[], char *flags, int *values, char *usage,
+                   int *num_elem, int *num_sides, double *min_r) {
+    int first;
+    char *flag;
+
+    for (first = 1; first + 1 < argc && argv[first][0] == '-'; first += 2) {
+        flag = argv[first][1] ? strchr(flags, argv[first][1]) : NULL;
+        if (!flag || argv[first][2]) {
+            break;
+        }
+        values[flag - flags] = atoi(argv[first + 1]);
+    }
+
+    if (first != argc - 1) {
+        printf("\nUsage: %s\n", usage);
+        return 1;
+    }
+
+    return read_mesh_file(argv[first], num_elem, num_sides, min_r);
+}
+
+/* benchmark order
+ *
+ * the rule for one order and its sizes, from start_order.
+ */
+typedef struct {
+    int n, n_p, n_quad, n_quad1d;
+    double *r1, *r2, *w, *s_r, *oned_w;
+} benchmark_order;
+
+/* start order
+ *
+ * sets the rule for order n, the collapsed one from set_tensor_quadrature
+ * if collapsed is set, and evaluates the basis on it. end_order frees it.
+ */
+void start_order(benchmark_order *order, int n, int collapsed) {
+    order->n   = n;
+    order->n_p = (n + 1) * (n + 2) / 2;
+
+    if (collapsed) {
+        set_tensor_quadrature(n, &order->r1, &order->r2, &order->w,
+                              &order->s_r, &order->oned_w, &order->n_quad, &order->n_quad1d);
+    } else {
+        set_quadrature(n, &order->r1, &order->r2, &order->w,
+                       &order->s_r, &order->oned_w, &order->n_quad, &order->n_quad1d);
+    }
+    preval_basis(order->r1, order->r2, order->s_r, order->w, order->oned_w,
+                 order->n_quad, order->n_quad1d, order->n_p);
+    if (collapsed) {
+        preval_tensor_basis(n);
+    }
+}
+
+/* init order
+ *
+ * allocates the solution arrays for the order and sets the initial
+ * conditions. free_gpu frees them.
+ */
+void init_order(benchmark_order *order, int num_elem, int num_sides) {
+    init_gpu(num_elem, num_sides, order->n_p);
+    init_conditions(d_c, d_J, d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                    order->n_quad, order->n_p, num_elem);
+}
+
+void end_order(benchmark_order *order) {
+    free(order->r1);
+    free(order->r2);
+    free(order->w);
+    free(order->s_r);
+    free(order->oned_w);
+}
+
+/* the largest difference from a reference the checks let through, relative
+ * for residuals and absolute for coefficients, which are all about 1 */
+#define BENCHMARK_TOLERANCE 1e-12
+
+// set by check when a difference is over the tolerance; main returns it
+int benchmark_failed = 0;
+
+// the residuals or solutions the benchmarks compare against
+#define NUM_REFERENCES 2
+double *references[NUM_REFERENCES];
+int reference_sizes[NUM_REFERENCES];
+
+/* reference buffer
+ *
+ * references[which], with room for at least size doubles. the buffers only
+ * grow, so a benchmark going up through the orders allocates them about
+ * once; free_references releases them.
+ */
+double *reference_buffer(int which, int size) {
+    if (size > reference_sizes[which]) {
+        free(references[which]);
+        references[which] = (double *) malloc(size * sizeof(double));
+        reference_sizes[which] = size;
+    }
+    return references[which];
+}
+
+void free_references() {
+    int i;
+
+    for (i = 0; i < NUM_REFERENCES; i++) {
+        free(references[i]);
+        references[i] = NULL;
+        reference_sizes[i] = 0;
+    }
+}
+
+/* check
+ *
+ * "  FAILED" for the end of a row if diff is over BENCHMARK_TOLERANCE (or
+ * isn't a number), which also sets benchmark_failed, and "" otherwise.
+ */
+char *check(double diff) {
+    if (!(diff <= BENCHMARK_TOLERANCE)) {
+        benchmark_failed = 1;
+        return "  FAILED";
+    }
+    return "";
+}
+
+/* residual
+ *
+ * one residual evaluation into d_quad_rhs.
+ */
+void residual(double *c, int n_quad, int n_quad1d, int n_p, int num_elem, int num_sides) {
+    eval_volume(c, d_quad_rhs,
+                d_xr, d_yr, d_xs, d_ys,
+                n_quad, n_p, num_elem);
+
+    eval_surface(c, d_quad_rhs,
+                 d_s_length,
+                 d_V1x, d_V1y,
+                 d_V2x, d_V2y,
+                 d_V3x, d_V3y,
+                 d_left_elem, d_right_elem,
+                 d_left_side_number, d_right_side_number,
+                 d_Nx, d_Ny,
+                 n_quad1d, n_quad, n_p, num_sides, num_elem, 0.);
+}
+
+/* rk4 step
+ *
+ * the same stages as time_integrate_rk4 with a fixed timestep.
+ */
+void rk4_step(double dt, int n_quad, int n_quad1d, int n_p, int num_elem, int num_sides) {
+    residual(d_c, n_quad, n_quad1d, n_p, num_elem, num_sides);
+    rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, 1, n_p, num_elem, NULL, NULL);
+    residual(d_kstar, n_quad, n_quad1d, n_p, num_elem, num_sides);
+    rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, 2, n_p, num_elem, NULL, NULL);
+    residual(d_kstar, n_quad, n_quad1d, n_p, num_elem, num_sides);
+    rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, 3, n_p, num_elem, NULL, NULL);
+    residual(d_kstar, n_quad, n_quad1d, n_p, num_elem, num_sides);
+    rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, 4, n_p, num_elem, NULL, NULL);
+}
+
+/* relative difference
+ *
+ * the largest difference between d_quad_rhs and reference, relative to the
+ * largest entry of reference.
+ */
+double relative_difference(double *reference) {
+    int i;
+    double diff, max_diff, max_rhs;
+
+    max_diff = 0.;
+    max_rhs  = 0.;
+    for (i = 0; i < num_coeffs; i++) {
+        diff = fabs(d_quad_rhs[i] - reference[i]);
+        max_diff = (diff > max_diff) ? diff : max_diff;
+        max_rhs  = (fabs(reference[i]) > max_rhs) ? fabs(reference[i]) : max_rhs;
+    }
+
+    return max_diff / ((max_rhs > 0.) ? max_rhs : 1.);
+}
+
+/* max difference
+ *
+ * the largest difference between the first size entries of a and b.
+ */
+double max_difference(double *a, double *b, int size) {
+    int i;
+    double diff, max_diff = 0.;
+
+    for (i = 0; i < size; i++) {
+        diff = fabs(a[i] - b[i]);
+        max_diff = (diff > max_diff) ? diff : max_diff;
+    }
+
+    return max_diff;
+}
+
+/* time volume
+ *
+ * the best time of repeats calls of volume.
+ */
+double time_volume(volume_ftn volume, int n_quad, int n_p, int num_elem, int repeats) {
+    int repeat;
+    double start, time;
+
+    time = 1e30;
+    for (repeat = 0; repeat < repeats; repeat++) {
+        start = wall_time();
+        volume(d_c, d_quad_rhs, d_xr, d_yr, d_xs, d_ys, n_quad, n_p, num_elem);
+        time = fmin(time, wall_time() - start);
+    }
+
+    return time;
+}
+
+/* time surface
+ *
+ * the best time of repeats calls of surface.
+ */
+double time_surface(surface_ftn surface, int n_quad, int n_quad1d, int n_p,
+                    int num_elem, int num_sides, int repeats) {
+    int repeat;
+    double start, time;
+
+    time = 1e30;
+    for (repeat = 0; repeat < repeats; repeat++) {
+        start = wall_time();
+        surface(d_c, d_quad_rhs, d_s_length,
+                d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                d_left_elem, d_right_elem,
+                d_left_side_number, d_right_side_number,
+                d_Nx, d_Ny, n_quad1d, n_quad, n_p, num_sides, num_elem, 0.);
+        time = fmin(time, wall_time() - start);
+    }
+
+    return time;
+}
+
+/* save residuals
+ *
+ * the residuals of volume and surface on d_c, into reference buffers 0 and
+ * 1, to check the other kernels against.
+ */
+void save_residuals(volume_ftn volume, surface_ftn surface,
+                    int n_quad, int n_quad1d, int n_p, int num_elem, int num_sides) {
+    volume(d_c, d_quad_rhs, d_xr, d_yr, d_xs, d_ys, n_quad, n_p, num_elem);
+    memcpy(reference_buffer(0, num_coeffs), d_quad_rhs, num_coeffs * sizeof(double));
+
+    memset(d_quad_rhs, 0, num_coeffs * sizeof(double));
+    surface(d_c, d_quad_rhs, d_s_length,
+            d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+            d_left_elem, d_right_elem,
+            d_left_side_number, d_right_side_number,
+            d_Nx, d_Ny, n_quad1d, n_quad, n_p, num_sides, num_elem, 0.);
+    memcpy(reference_buffer(1, num_coeffs), d_quad_rhs, num_coeffs * sizeof(double));
+}
+
+/* kernel differences
+ *
+ * runs volume and surface once on d_c, either of them can be NULL, and
+ * returns how far their residuals are from the ones save_residuals saved,
+ * relative to the largest entries of those.
+ */
+void kernel_differences(volume_ftn volume, surface_ftn surface,
+                        int n_quad, int n_quad1d, int n_p, int num_elem, int num_sides,
+                        double *volume_diff, double *surface_diff) {
+    if (volume) {
+        volume(d_c, d_quad_rhs, d_xr, d_yr, d_xs, d_ys, n_quad, n_p, num_elem);
+        *volume_diff = relative_difference(references[0]);
+    }
+
+    if (surface) {
+        memset(d_quad_rhs, 0, num_coeffs * sizeof(double));
+        surface(d_c, d_quad_rhs, d_s_length,
+                d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                d_left_elem, d_right_elem,
+                d_left_side_number, d_right_side_number,
+                d_Nx, d_Ny, n_quad1d, n_quad, n_p, num_sides, num_elem, 0.);
+        *surface_diff = relative_difference(references[1]);
+    }
+}
+
+/* grade point
+ *
+ * moves x, y from angle theta to angle pi / 2 * (ratio^f - 1) / (ratio - 1),
+ * f = theta / (pi / 2), keeping its radius.
+ */
+void grade_point(double *x, double *y, double ratio) {
+    double r     = sqrt(*x * *x + *y * *y);
+    double f     = atan2(*y, *x) / (M_PI / 2.);
+    double theta = M_PI / 2. * (pow(ratio, f) - 1.) / (ratio - 1.);
+
+    *x = r * cos(theta);
+    *y = r * sin(theta);
+}
+
+/* grade mesh
+ *
+ * grades every element and side vertex and redoes the precomputations.
+ */
+void grade_mesh(double ratio, int num_elem, int num_sides, double *min_r) {
+    int i;
+
+    for (i = 0; i < num_elem; i++) {
+        grade_point(&d_V1x[i], &d_V1y[i], ratio);
+        grade_point(&d_V2x[i], &d_V2y[i], ratio);
+        grade_point(&d_V3x[i], &d_V3y[i], ratio);
+    }
+    for (i = 0; i < num_sides; i++) {
+        grade_point(&d_s_V1x[i], &d_s_V1y[i], ratio);
+        grade_point(&d_s_V2x[i], &d_s_V2y[i], ratio);
+    }
+
+    preval_mesh(num_elem, num_sides, min_r);
+}
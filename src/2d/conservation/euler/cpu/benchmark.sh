@@ -26,3 +26,41 @@ time ./cpueuler -T 10 -n 2 mesh/sv1refined2.pmsh output/uniform.out
 time ./cpueuler -T 10 -n 3 mesh/sv1refined2.pmsh output/uniform.out 
 time ./cpueuler -T 10 -n 4 mesh/sv1refined2.pmsh output/uniform.out 
 time ./cpueuler -T 10 -n 5 mesh/sv1refined2.pmsh output/uniform.out 
+
+# strong scaling on sv1refined2: the same run with more and more threads.
+# prints the wall time, speedup and parallel efficiency against one thread.
+SCALING_MESH=${SCALING_MESH:-../supersonic/mesh/sv1refined2.msh}
+SCALING_THREADS=${SCALING_THREADS:-"1 2 4 8 16 32"}
+for n in 1 3 5; do
+    echo "strong scaling, n = $n, $SCALING_MESH"
+    printf "%8s %12s %9s %11s\n" "threads" "time (s)" "speedup" "efficiency"
+    t1=
+    for p in $SCALING_THREADS; do
+        start=$(date +%s.%N)
+        ./cpueuler -p $p -T 0.1 -n $n $SCALING_MESH output/uniform.out > /dev/null
+        t=$(awk -v a=$start -v b=$(date +%s.%N) 'BEGIN { print b - a }')
+        t1=${t1:-$t}
+        awk -v p=$p -v t=$t -v t1=$t1 \
+            'BEGIN { printf "%8i %12.3f %8.2fx %10.0f%%\n", p, t, t1 / t, 100 * t1 / t / p }'
+    done
+    echo
+done
+
+# cost to solution for each time integrator: wall time and number of steps
+# to reach the same end time, with the time relative to rk4.
+INTEGRATOR_MESH=${INTEGRATOR_MESH:-../supersonic/mesh/sv1refined2.msh}
+INTEGRATORS=${INTEGRATORS:-"rk4 lsrk3 lsrk4 rk2 ssprk3 fe lts"}
+for n in 1 3 5; do
+    echo "time integrators, n = $n, $INTEGRATOR_MESH"
+    printf "%8s %12s %8s %9s\n" "scheme" "time (s)" "steps" "vs rk4"
+    t1=
+    for I in $INTEGRATORS; do
+        start=$(date +%s.%N)
+        steps=$(./cpueuler -I $I -T 0.1 -n $n $INTEGRATOR_MESH output/uniform.out | grep -c "^ > (")
+        t=$(awk -v a=$start -v b=$(date +%s.%N) 'BEGIN { print b - a }')
+        t1=${t1:-$t}
+        awk -v I=$I -v t=$t -v t1=$t1 -v s=$steps \
+            'BEGIN { printf "%8s %12.3f %8i %8.2fx\n", I, t, s, t / t1 }'
+    done
+    echo
+done
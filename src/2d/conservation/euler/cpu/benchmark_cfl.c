@@ -0,0 +1,136 @@
+#include "benchmark.h"
+
+/* benchmark_cfl.c
+ *
+ * compares the rk4 timestep from the smallest inscribed radius over the
+ * largest wave speed anywhere (eval_global_lambda then find_max_lambda) with
+ * the one from eval_global_cfl, which holds each element to its own radius
+ * and wave speed, for each mesh. the initial conditions are run with rk4 to
+ * the end time and both timesteps are sampled every step, and the two ways
+ * of finding them are timed on the final solution. -g RATIO grades the mesh
+ * like benchmark_lts.
+ *
+ * Usage: benchmark_cfl [-n ORDER] [-T ENDTIME] [-g RATIO] [-r REPEATS] MESH...
+ */
+
+int main(int argc, char *argv[]) {
+    int i, n, n_p, n_quad, n_quad1d, first, mesh, steps, repeat, repeats;
+    int num_elem, num_sides;
+    double min_r, endtime, ratio, t, dt, max_l, min_dt, gain, min_gain, sum_gain;
+    double start, old_time, new_time;
+    double *r1_local, *r2_local, *w_local, *s_r, *oned_w_local;
+
+    n       = 1;
+    endtime = 0.1;
+    ratio   = 1.;
+    repeats = 100;
+    for (first = 1; first + 1 < argc && argv[first][0] == '-'; first += 2) {
+        if (strcmp(argv[first], "-n") == 0) {
+            n = atoi(argv[first + 1]);
+        } else if (strcmp(argv[first], "-T") == 0) {
+            endtime = atof(argv[first + 1]);
+        } else if (strcmp(argv[first], "-g") == 0) {
+            ratio = atof(argv[first + 1]);
+        } else if (strcmp(argv[first], "-r") == 0) {
+            repeats = atoi(argv[first + 1]);
+        }
+    }
+
+    if (first >= argc || n < 0 || n > 5 || endtime <= 0. || ratio < 1. || repeats < 1) {
+        printf("\nUsage: benchmark_cfl [-n ORDER] [-T ENDTIME] [-g RATIO] [-r REPEATS] MESH...\n");
+        return 1;
+    }
+
+    n_p = (n + 1) * (n + 2) / 2;
+    set_quadrature(n, &r1_local, &r2_local, &w_local,
+                   &s_r, &oned_w_local, &n_quad, &n_quad1d);
+    preval_basis(r1_local, r2_local, s_r, w_local, oned_w_local, n_quad, n_quad1d, n_p);
+
+    printf("n = %i, T = %g, graded %g:1, best of %i\n", n, endtime, ratio, repeats);
+    printf("%-24s %8s %12s %12s %9s %9s %9s %11s %11s\n", "mesh", "elements",
+           "global dt", "local dt", "gain", "min gain", "mean gain",
+           "global (us)", "local (us)");
+
+    // so init_gpu allocates d_kstar and d_k1
+    time_integrator = INTEGRATOR_RK4;
+
+    for (mesh = first; mesh < argc; mesh++) {
+        if (read_mesh_file(argv[mesh], &num_elem, &num_sides, &min_r)) {
+            return 1;
+        }
+        if (ratio > 1.) {
+            grade_mesh(ratio, num_elem, num_sides, &min_r);
+        }
+
+        init_gpu(num_elem, num_sides, n_p);
+        init_conditions(d_c, d_J, d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                        n_quad, n_p, num_elem);
+
+        // rk4 steps at the local dt, comparing it with the global one as
+        // the solution evolves
+        t        = 0.;
+        steps    = 0;
+        min_gain = 1e30;
+        sum_gain = 0.;
+        while (t < endtime) {
+            min_dt = eval_global_cfl(d_c, d_radius, &max_l, n_p, num_elem);
+            gain   = min_dt / (min_r / max_l);
+            if (!steps) {
+                printf("%-24s %8i %12.4e %12.4e %8.3fx", argv[mesh], num_elem,
+                       0.7 * min_r / max_l / order_scale(n), 0.7 * min_dt / order_scale(n), gain);
+            }
+            min_gain  = (gain < min_gain) ? gain : min_gain;
+            sum_gain += gain;
+
+            dt = 0.7 * min_dt / order_scale(n);
+            dt = (t + dt > endtime) ? endtime - t : dt;
+
+            for (i = 1; i <= 4; i++) {
+                eval_volume(i > 1 ? d_kstar : d_c, d_quad_rhs,
+                            d_xr, d_yr, d_xs, d_ys,
+                            n_quad, n_p, num_elem);
+                eval_surface(i > 1 ? d_kstar : d_c, d_quad_rhs,
+                             d_s_length,
+                             d_V1x, d_V1y,
+                             d_V2x, d_V2y,
+                             d_V3x, d_V3y,
+                             d_left_elem, d_right_elem,
+                             d_left_side_number, d_right_side_number,
+                             d_Nx, d_Ny,
+                             n_quad1d, n_quad, n_p, num_sides, num_elem, t);
+                rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, i, n_p, num_elem, NULL, NULL);
+            }
+
+            t += dt;
+            steps++;
+        }
+
+        // both ways of finding the timestep on the final solution
+        old_time = new_time = 1e30;
+        for (repeat = 0; repeat < repeats; repeat++) {
+            start = wall_time();
+            eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
+            max_l = find_max_lambda(d_lambda, num_elem);
+            old_time = fmin(old_time, wall_time() - start);
+
+            start = wall_time();
+            min_dt = eval_global_cfl(d_c, d_radius, &max_l, n_p, num_elem);
+            new_time = fmin(new_time, wall_time() - start);
+        }
+
+        printf(" %8.3fx %8.3fx %11.2f %11.2f  (%i steps)\n", min_gain, sum_gain / steps,
+               old_time * 1e6, new_time * 1e6, steps);
+        fflush(stdout);
+
+        free_gpu();
+        free_gpu_mesh();
+    }
+
+    free(r1_local);
+    free(r2_local);
+    free(w_local);
+    free(s_r);
+    free(oned_w_local);
+
+    return 0;
+}
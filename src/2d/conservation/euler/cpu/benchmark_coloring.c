@@ -0,0 +1,259 @@
+#include "benchmark.h"
+
+/* benchmark_coloring.c
+ *
+ * times one right hand side evaluation for each order with the riemann
+ * contributions added straight into the element residual one side color at
+ * a time, against the two buffer scheme it replaced: every side writes its
+ * contributions to a left and a right riemann vector in one parallel pass,
+ * and a second pass over the elements gathers them. both run the generic
+ * kernels on the given number of threads. exits with 1 if the two residuals
+ * are further than BENCHMARK_TOLERANCE apart, relative to the terms summed.
+ *
+ * Usage: benchmark_coloring [-r REPEATS] [-p THREADS] MESH
+ */
+
+/* two buffer surface
+ *
+ * the riemann problems for every side in one parallel pass, each writing its
+ * own entries of left_riemann_rhs and right_riemann_rhs.
+ */
+void eval_surface_two_buffer(double *c,
+                             double *left_riemann_rhs, double *right_riemann_rhs,
+                             int n_quad1d, int n_p, int num_sides) {
+    int idx;
+
+    #pragma omp parallel for
+    for (idx = 0; idx < num_sides; idx++) {
+        int left_idx   = d_left_elem[idx];
+        int left_side  = d_left_side_number[idx];
+        int right_idx  = d_right_elem[idx];
+        int right_side = d_right_side_number[idx];
+        int left_base  = coeff_base(left_idx, n_p);
+        int right_base = (right_idx >= 0) ? coeff_base(right_idx, n_p) : 0;
+
+        double c_rho_left[n_p], c_u_left[n_p], c_v_left[n_p], c_E_left[n_p];
+        double c_rho_right[n_p], c_u_right[n_p], c_v_right[n_p], c_E_right[n_p];
+        double s[n_quad1d][4];
+
+        int i, j, k;
+        double left_sum[4], right_sum[4];
+        double rho_left, u_left, v_left, E_left;
+        double rho_right, u_right, v_right, E_right;
+
+        for (i = 0; i < n_p; i++) {
+            c_rho_left[i] = c[left_base + (0 * n_p + i) * elem_block];
+            c_u_left[i]   = c[left_base + (1 * n_p + i) * elem_block];
+            c_v_left[i]   = c[left_base + (2 * n_p + i) * elem_block];
+            c_E_left[i]   = c[left_base + (3 * n_p + i) * elem_block];
+
+            if (right_idx >= 0) {
+                c_rho_right[i] = c[right_base + (0 * n_p + i) * elem_block];
+                c_u_right[i]   = c[right_base + (1 * n_p + i) * elem_block];
+                c_v_right[i]   = c[right_base + (2 * n_p + i) * elem_block];
+                c_E_right[i]   = c[right_base + (3 * n_p + i) * elem_block];
+            }
+        }
+
+        for (j = 0; j < n_quad1d; j++) {
+            eval_left(c_rho_left, c_u_left, c_v_left, c_E_left,
+                      &rho_left, &u_left, &v_left, &E_left,
+                      j, left_side, n_p, n_quad1d);
+            if (right_idx >= 0) {
+                eval_right(c_rho_right, c_u_right, c_v_right, c_E_right,
+                           &rho_right, &u_right, &v_right, &E_right,
+                           j, right_side, n_p, n_quad1d);
+            } else {
+                eval_boundary(rho_left, &rho_right, u_left, &u_right,
+                              v_left, &v_right, E_left, &E_right,
+                              d_Nx[idx], d_Ny[idx],
+                              d_V1x[left_idx], d_V1y[left_idx],
+                              d_V2x[left_idx], d_V2y[left_idx],
+                              d_V3x[left_idx], d_V3y[left_idx],
+                              j, left_side, right_idx, n_quad1d, 0.);
+            }
+
+            eval_riemann_flux(rho_left,  u_left,  v_left,  E_left,
+                              rho_right, u_right, v_right, E_right,
+                              d_Nx[idx], d_Ny[idx], left_side, right_side, idx, s[j]);
+
+            for (k = 0; k < 4; k++) {
+                s[j][k] = w_oned[j] * s[j][k];
+            }
+        }
+
+        for (i = 0; i < n_p; i++) {
+            for (k = 0; k < 4; k++) {
+                left_sum[k]  = 0.;
+                right_sum[k] = 0.;
+            }
+            for (j = 0; j < n_quad1d; j++) {
+                for (k = 0; k < 4; k++) {
+                    left_sum[k] += s[j][k] * basis_side[left_side * n_p * n_quad1d + i * n_quad1d + j];
+                    if (right_idx >= 0) {
+                        right_sum[k] += s[j][k] * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
+                    }
+                }
+            }
+
+            for (k = 0; k < 4; k++) {
+                left_riemann_rhs[num_sides * n_p * k + i * num_sides + idx] = -d_s_length[idx] / 2. * left_sum[k];
+                if (right_idx >= 0) {
+                    right_riemann_rhs[num_sides * n_p * k + i * num_sides + idx] = d_s_length[idx] / 2. * right_sum[k];
+                }
+            }
+        }
+    }
+}
+
+/* two buffer rhs
+ *
+ * the gather pass: each element sums the volume integral and its three
+ * sides' entries from the riemann vectors, k = dt / J * (...).
+ */
+void eval_rhs_two_buffer(double *k, double *quad_rhs,
+                         double *left_riemann_rhs, double *right_riemann_rhs,
+                         double dt, int n_p, int num_sides, int num_elem) {
+    int idx;
+
+    #pragma omp parallel for
+    for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
+        int s1_idx = d_elem_s1[idx];
+        int s2_idx = d_elem_s2[idx];
+        int s3_idx = d_elem_s3[idx];
+
+        double *s1_rhs = (idx == d_left_elem[s1_idx]) ? left_riemann_rhs : right_riemann_rhs;
+        double *s2_rhs = (idx == d_left_elem[s2_idx]) ? left_riemann_rhs : right_riemann_rhs;
+        double *s3_rhs = (idx == d_left_elem[s3_idx]) ? left_riemann_rhs : right_riemann_rhs;
+
+        int i;
+
+        for (i = 0; i < 4 * n_p; i++) {
+            k[base + i * elem_block] =
+                1. / d_J[idx] * dt * (quad_rhs[base + i * elem_block]
+                                      + s1_rhs[i * num_sides + s1_idx]
+                                      + s2_rhs[i * num_sides + s2_idx]
+                                      + s3_rhs[i * num_sides + s3_idx]);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int i, k, n, idx, side, base, n_p, n_quad, n_quad1d, repeats, threads, num_elem, num_sides;
+    int options[2] = {5, 0};
+    double start, min_r, diff, max_diff, scale;
+    double colored_time, buffer_time;
+    double *left_riemann_rhs, *right_riemann_rhs, *k_colored, *k_buffer;
+    benchmark_order order;
+
+    if (benchmark_args(argc, argv, "rp", options,
+                       "benchmark_coloring [-r REPEATS] [-p THREADS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    repeats = options[0];
+    threads = options[1];
+
+    if (repeats < 1) {
+        printf("\nUsage: benchmark_coloring [-r REPEATS] [-p THREADS] MESH\n");
+        return 1;
+    }
+
+#ifdef _OPENMP
+    if (threads > 0) {
+        omp_set_num_threads(threads);
+    }
+    threads = omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    printf("%i elements, %i sides, %i threads, best of %i\n",
+           num_elem, num_sides, threads, repeats);
+    printf("side colors:");
+    for (k = 0; k < 4; k++) {
+        printf(" %i", num_colors[k]);
+    }
+    printf(" (interior, reflecting, outflow, inflow)\n");
+
+    printf("%4s %6s %14s %14s %9s %14s %12s\n", "n", "n_p",
+           "buffers (ms)", "colored (ms)", "speedup", "saved (MB)", "max diff");
+
+    for (n = 0; n <= 5; n++) {
+        start_order(&order, n, 0);
+        init_order(&order, num_elem, num_sides);
+        n_p      = order.n_p;
+        n_quad   = order.n_quad;
+        n_quad1d = order.n_quad1d;
+
+        left_riemann_rhs  = (double *) calloc(4 * num_sides * n_p, sizeof(double));
+        right_riemann_rhs = (double *) calloc(4 * num_sides * n_p, sizeof(double));
+        k_colored = reference_buffer(0, num_coeffs);
+        k_buffer  = reference_buffer(1, num_coeffs);
+
+        buffer_time = colored_time = 1e30;
+        for (i = 0; i < repeats; i++) {
+            start = wall_time();
+            eval_volume(d_c, d_quad_rhs, d_xr, d_yr, d_xs, d_ys, n_quad, n_p, num_elem);
+            eval_surface_two_buffer(d_c, left_riemann_rhs, right_riemann_rhs,
+                                    n_quad1d, n_p, num_sides);
+            eval_rhs_two_buffer(k_buffer, d_quad_rhs, left_riemann_rhs, right_riemann_rhs,
+                                1., n_p, num_sides, num_elem);
+            buffer_time = fmin(buffer_time, wall_time() - start);
+
+            start = wall_time();
+            eval_volume(d_c, d_quad_rhs, d_xr, d_yr, d_xs, d_ys, n_quad, n_p, num_elem);
+            eval_surface(d_c, d_quad_rhs,
+                         d_s_length,
+                         d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                         d_left_elem, d_right_elem,
+                         d_left_side_number, d_right_side_number,
+                         d_Nx, d_Ny,
+                         n_quad1d, n_quad, n_p, num_sides, num_elem, 0.);
+            eval_rhs_rk4(k_colored, d_quad_rhs, d_J, 1., n_p, num_elem);
+            colored_time = fmin(colored_time, wall_time() - start);
+        }
+
+        // the sums are in a different order and the terms mostly cancel for
+        // the initial conditions (for n = 0 the volume integral is nothing
+        // but rounding), so compare relative to the size of the terms
+        eval_volume(d_c, d_quad_rhs, d_xr, d_yr, d_xs, d_ys, n_quad, n_p, num_elem);
+        max_diff = scale = 0.;
+        for (idx = 0; idx < num_elem; idx++) {
+            base = coeff_base(idx, n_p);
+            for (i = 0; i < 4 * n_p; i++) {
+                diff = fabs(k_colored[base + i * elem_block] - k_buffer[base + i * elem_block]);
+                max_diff = (diff > max_diff) ? diff : max_diff;
+                diff = fabs(d_quad_rhs[base + i * elem_block]);
+                for (k = 0; k < 3; k++) {
+                    side = (k == 0) ? d_elem_s1[idx] : (k == 1) ? d_elem_s2[idx] : d_elem_s3[idx];
+                    diff += fabs(((idx == d_left_elem[side]) ? left_riemann_rhs : right_riemann_rhs)
+                                 [i * num_sides + side]);
+                }
+                diff /= d_J[idx];
+                scale = (diff > scale) ? diff : scale;
+            }
+        }
+
+        if (scale > 0.) {
+            max_diff /= scale;
+        }
+
+        printf("%4i %6i %14.3f %14.3f %8.2fx %14.2f %12.2e%s\n", n, n_p,
+               buffer_time * 1e3, colored_time * 1e3, buffer_time / colored_time,
+               2. * 4 * n_p * num_sides * sizeof(double) / 1e6,
+               max_diff, check(max_diff));
+        fflush(stdout);
+
+        free(left_riemann_rhs);
+        free(right_riemann_rhs);
+        free_gpu();
+        end_order(&order);
+    }
+
+    free_references();
+    free_gpu_mesh();
+
+    return benchmark_failed;
+}
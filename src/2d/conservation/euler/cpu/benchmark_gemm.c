@@ -0,0 +1,142 @@
+#include "benchmark.h"
+
+/* benchmark_gemm.c
+ *
+ * times the gemm volume and surface kernels for each order with every
+ * vector instruction set this cpu has against the loop ones for the same
+ * instruction set, and reports the largest difference of each from the
+ * residual of the scalar kernels specialized for the order, relative to its
+ * largest entry. the volume GFLOP/s count the same arithmetic as
+ * benchmark_simd, and the peak they're a percentage of is gemm on a
+ * 24 x 32 x 64 product that stays in the l1 cache. exits with 1 if any
+ * residual, the loop kernels' too, is further than BENCHMARK_TOLERANCE from
+ * the scalar one.
+ *
+ * Usage: benchmark_gemm [-r REPEATS] MESH
+ */
+
+volume_ftn  loop_volume_ftns[]  = {NULL, eval_volume_avx2,       eval_volume_avx512};
+surface_ftn loop_surface_ftns[] = {NULL, eval_surface_avx2,      eval_surface_avx512};
+volume_ftn  gemm_volume_ftns[]  = {NULL, eval_volume_gemm_avx2,  eval_volume_gemm_avx512};
+surface_ftn gemm_surface_ftns[] = {NULL, eval_surface_gemm_avx2, eval_surface_gemm_avx512};
+
+/* peak
+ *
+ * the GFLOP/s of gemm for isa on a product that fits in the l1 cache.
+ */
+double peak(int isa) {
+    int m = 4 * GEMM_MR, n = 64, k = 32;
+    int i, repeat;
+    double a[gemm_packed_size(m, k)], b[k * n], c[m * n], time, start;
+
+    for (i = 0; i < gemm_packed_size(m, k); i++) {
+        a[i] = 1. / (i + 1);
+    }
+    for (i = 0; i < k * n; i++) {
+        b[i] = 1. / (i + 2);
+    }
+
+    time = 1e30;
+    for (repeat = 0; repeat < 100; repeat++) {
+        start = wall_time();
+        for (i = 0; i < 1000; i++) {
+            if (isa == ISA_AVX512) {
+                gemm_avx512(m, n, k, a, b, n, c, n);
+            } else {
+                gemm_avx2(m, n, k, a, b, n, c, n);
+            }
+            // so the products aren't optimized away
+            b[i % (k * n)] += c[i % (m * n)] * 1e-30;
+        }
+        time = fmin(time, wall_time() - start);
+    }
+
+    return 2. * m * n * k * 1000 / time / 1e9;
+}
+
+/* time kernels
+ *
+ * the best time of repeats calls of volume and surface, and how far their
+ * residuals are from the ones save_residuals saved.
+ */
+void time_kernels(volume_ftn volume, surface_ftn surface, benchmark_order *order,
+                  int num_elem, int num_sides, int repeats,
+                  double *volume_time, double *surface_time,
+                  double *volume_diff, double *surface_diff) {
+    kernel_differences(volume, surface,
+                       order->n_quad, order->n_quad1d, order->n_p, num_elem, num_sides,
+                       volume_diff, surface_diff);
+
+    *volume_time  = time_volume(volume, order->n_quad, order->n_p, num_elem, repeats);
+    *surface_time = time_surface(surface, order->n_quad, order->n_quad1d, order->n_p,
+                                 num_elem, num_sides, repeats);
+}
+
+int main(int argc, char *argv[]) {
+    int n, isa, best_isa;
+    int num_elem, num_sides;
+    int options[1] = {20};
+    double min_r, flops, peaks[3];
+    double loop_volume, loop_surface, gemm_volume, gemm_surface;
+    double loop_volume_diff, loop_surface_diff, gemm_volume_diff, gemm_surface_diff;
+    benchmark_order order;
+
+    best_isa = detect_isa();
+    if (best_isa == ISA_SCALAR) {
+        printf("the gemm kernels need avx2 or avx512\n");
+        return 1;
+    }
+
+    if (benchmark_args(argc, argv, "r", options, "benchmark_gemm [-r REPEATS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+
+    printf("%i elements, %i sides, best of %i\n", num_elem, num_sides, options[0]);
+    for (isa = ISA_AVX2; isa <= best_isa; isa++) {
+        peaks[isa] = peak(isa);
+        printf("%s gemm peak %.2f GFLOP/s\n", isa_names[isa], peaks[isa]);
+    }
+    printf("%4s %8s %10s %10s %8s %9s %7s %10s %10s %10s %10s %10s %10s\n", "n", "isa",
+           "loop (ms)", "gemm (ms)", "speedup", "GFLOP/s", "peak", "loop diff", "gemm diff",
+           "loop (ms)", "gemm (ms)", "speedup", "gemm diff");
+
+    for (n = 0; n <= 5; n++) {
+        start_order(&order, n, 0);
+        init_order(&order, num_elem, num_sides);
+
+        flops = (24. * order.n_p * order.n_quad + 49. * order.n_quad) * num_elem;
+
+        // the scalar kernels' residuals
+        save_residuals(volume_ftns[n], surface_ftns[n],
+                       order.n_quad, order.n_quad1d, order.n_p, num_elem, num_sides);
+
+        for (isa = ISA_AVX2; isa <= best_isa; isa++) {
+            time_kernels(loop_volume_ftns[isa], loop_surface_ftns[isa], &order,
+                         num_elem, num_sides, options[0],
+                         &loop_volume, &loop_surface, &loop_volume_diff, &loop_surface_diff);
+            time_kernels(gemm_volume_ftns[isa], gemm_surface_ftns[isa], &order,
+                         num_elem, num_sides, options[0],
+                         &gemm_volume, &gemm_surface, &gemm_volume_diff, &gemm_surface_diff);
+
+            printf("%4i %8s %10.3f %10.3f %7.2fx %9.2f %6.1f%% %10.2e %10.2e %10.3f %10.3f %9.2fx %10.2e%s\n",
+                   n, isa_names[isa], loop_volume * 1e3, gemm_volume * 1e3,
+                   loop_volume / gemm_volume, flops / gemm_volume / 1e9,
+                   100. * flops / gemm_volume / 1e9 / peaks[isa],
+                   loop_volume_diff, gemm_volume_diff,
+                   loop_surface * 1e3, gemm_surface * 1e3,
+                   loop_surface / gemm_surface, gemm_surface_diff,
+                   check(fmax(fmax(loop_volume_diff, gemm_volume_diff),
+                              fmax(loop_surface_diff, gemm_surface_diff))));
+            fflush(stdout);
+        }
+
+        free_gpu();
+        end_order(&order);
+    }
+
+    free_references();
+    free_gpu_mesh();
+
+    return benchmark_failed;
+}
@@ -0,0 +1,296 @@
+#include "benchmark.h"
+
+/* benchmark_kernels.c
+ *
+ * times the surface and volume kernels for each order against the way they
+ * used to be written, with the riemann problem and the volume flux evaluated
+ * again for every basis function, and checks they give the same answer. the
+ * old surface kernel stores each side's contributions in the left and right
+ * riemann vectors, which are gathered into the element residual to compare.
+ * exits with 1 if either old kernel is further than BENCHMARK_TOLERANCE from
+ * the new one.
+ *
+ * Usage: benchmark_kernels [-r REPEATS] MESH
+ */
+
+/* per basis surface
+ *
+ * the old surface kernel: the loop over the basis functions wraps the loop
+ * over the integration points, so the traces and the flux are recomputed
+ * n_p times.
+ */
+void eval_surface_per_basis(double *c,
+                            double *left_riemann_rhs, double *right_riemann_rhs,
+                            int n_quad1d, int n_p, int num_sides, int num_elem) {
+    int idx;
+
+    for (idx = 0; idx < num_sides; idx++) {
+        int left_idx   = d_left_elem[idx];
+        int left_side  = d_left_side_number[idx];
+        int right_idx  = d_right_elem[idx];
+        int right_side = d_right_side_number[idx];
+        int left_base  = coeff_base(left_idx, n_p);
+        int right_base = (right_idx >= 0) ? coeff_base(right_idx, n_p) : 0;
+
+        double c_rho_left[n_p], c_u_left[n_p], c_v_left[n_p], c_E_left[n_p];
+        double c_rho_right[n_p], c_u_right[n_p], c_v_right[n_p], c_E_right[n_p];
+
+        int i, j, k;
+        double s[4], left_sum[4], right_sum[4];
+        double rho_left, u_left, v_left, E_left;
+        double rho_right, u_right, v_right, E_right;
+
+        for (i = 0; i < n_p; i++) {
+            c_rho_left[i] = c[left_base + (0 * n_p + i) * elem_block];
+            c_u_left[i]   = c[left_base + (1 * n_p + i) * elem_block];
+            c_v_left[i]   = c[left_base + (2 * n_p + i) * elem_block];
+            c_E_left[i]   = c[left_base + (3 * n_p + i) * elem_block];
+
+            if (right_idx >= 0) {
+                c_rho_right[i] = c[right_base + (0 * n_p + i) * elem_block];
+                c_u_right[i]   = c[right_base + (1 * n_p + i) * elem_block];
+                c_v_right[i]   = c[right_base + (2 * n_p + i) * elem_block];
+                c_E_right[i]   = c[right_base + (3 * n_p + i) * elem_block];
+            }
+        }
+
+        for (i = 0; i < n_p; i++) {
+            for (k = 0; k < 4; k++) {
+                left_sum[k]  = 0.;
+                right_sum[k] = 0.;
+            }
+
+            for (j = 0; j < n_quad1d; j++) {
+                eval_left(c_rho_left, c_u_left, c_v_left, c_E_left,
+                          &rho_left, &u_left, &v_left, &E_left,
+                          j, left_side, n_p, n_quad1d);
+                if (right_idx >= 0) {
+                    eval_right(c_rho_right, c_u_right, c_v_right, c_E_right,
+                               &rho_right, &u_right, &v_right, &E_right,
+                               j, right_side, n_p, n_quad1d);
+                } else {
+                    eval_boundary(rho_left, &rho_right, u_left, &u_right,
+                                  v_left, &v_right, E_left, &E_right,
+                                  d_Nx[idx], d_Ny[idx],
+                                  d_V1x[left_idx], d_V1y[left_idx],
+                                  d_V2x[left_idx], d_V2y[left_idx],
+                                  d_V3x[left_idx], d_V3y[left_idx],
+                                  j, left_side, right_idx, n_quad1d, 0.);
+                }
+
+                eval_riemann_flux(rho_left,  u_left,  v_left,  E_left,
+                                  rho_right, u_right, v_right, E_right,
+                                  d_Nx[idx], d_Ny[idx], left_side, right_side, idx, s);
+
+                for (k = 0; k < 4; k++) {
+                    left_sum[k]  += w_oned[j] * s[k] * basis_side[left_side  * n_p * n_quad1d + i * n_quad1d + j];
+                    right_sum[k] += w_oned[j] * s[k] * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
+                }
+            }
+
+            for (k = 0; k < 4; k++) {
+                left_riemann_rhs[num_sides * n_p * k + i * num_sides + idx]  = -d_s_length[idx] / 2. * left_sum[k];
+                right_riemann_rhs[num_sides * n_p * k + i * num_sides + idx] =  d_s_length[idx] / 2. * right_sum[k];
+            }
+        }
+    }
+}
+
+/* per basis volume
+ *
+ * the old volume kernel: the solution and the flux at every integration
+ * point are recomputed for each basis function, O(n_p^2 * n_quad).
+ */
+void eval_volume_per_basis(double *c, double *quad_rhs,
+                           int n_quad, int n_p, int num_elem) {
+    int idx;
+
+    for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
+        double x_r = d_xr[idx];
+        double y_r = d_yr[idx];
+        double x_s = d_xs[idx];
+        double y_s = d_ys[idx];
+
+        double flux_x[4], flux_y[4];
+        double c_rho[n_p], c_u[n_p], c_v[n_p], c_E[n_p];
+
+        int i, j, k;
+        double rho, u, v, E, sum[4];
+
+        for (i = 0; i < n_p; i++) {
+            c_rho[i] = c[base + (0 * n_p + i) * elem_block];
+            c_u[i]   = c[base + (1 * n_p + i) * elem_block];
+            c_v[i]   = c[base + (2 * n_p + i) * elem_block];
+            c_E[i]   = c[base + (3 * n_p + i) * elem_block];
+        }
+
+        for (i = 0; i < n_p; i++) {
+            for (k = 0; k < 4; k++) {
+                sum[k] = 0.;
+            }
+
+            for (j = 0; j < n_quad; j++) {
+                rho = 0.;
+                u   = 0.;
+                v   = 0.;
+                E   = 0.;
+                for (k = 0; k < n_p; k++) {
+                    rho += c_rho[k] * basis[n_quad * k + j];
+                    u   += c_u[k]   * basis[n_quad * k + j];
+                    v   += c_v[k]   * basis[n_quad * k + j];
+                    E   += c_E[k]   * basis[n_quad * k + j];
+                }
+
+                u = u / rho;
+                v = v / rho;
+
+                eval_flux(rho, u, v, E, flux_x, flux_y, 1000, idx);
+
+                for (k = 0; k < 4; k++) {
+                    sum[k] +=   flux_x[k] * ( basis_grad_x[n_quad * i + j] * y_s
+                                             -basis_grad_y[n_quad * i + j] * y_r)
+                              + flux_y[k] * (-basis_grad_x[n_quad * i + j] * x_s
+                                             +basis_grad_y[n_quad * i + j] * x_r);
+                }
+            }
+
+            for (k = 0; k < 4; k++) {
+                quad_rhs[base + (k * n_p + i) * elem_block] = sum[k];
+            }
+        }
+    }
+}
+
+/* gather sides
+ *
+ * sums the riemann vectors written by eval_surface_per_basis into the
+ * element residual, the way eval_rhs_rk4 used to.
+ */
+void gather_sides(double *left_riemann_rhs, double *right_riemann_rhs, double *rhs,
+                  int n_p, int num_sides, int num_elem) {
+    int idx, i, k, s, base;
+    int sides[3];
+    double *riemann_rhs;
+
+    for (idx = 0; idx < num_elem; idx++) {
+        base = coeff_base(idx, n_p);
+        sides[0] = d_elem_s1[idx];
+        sides[1] = d_elem_s2[idx];
+        sides[2] = d_elem_s3[idx];
+
+        for (i = 0; i < 4 * n_p; i++) {
+            rhs[base + i * elem_block] = 0.;
+            for (k = 0; k < 3; k++) {
+                s = sides[k];
+                riemann_rhs = (idx == d_left_elem[s]) ? left_riemann_rhs : right_riemann_rhs;
+                rhs[base + i * elem_block] += riemann_rhs[i * num_sides + s];
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int i, n, n_p, n_quad, n_quad1d, repeats, num_elem, num_sides;
+    int options[1] = {5};
+    double start, min_r;
+    double *left_old, *right_old, *quad_old;
+    double surface_old[6], surface_new[6], surface_diff[6];
+    double volume_old[6], volume_new[6], volume_diff[6];
+    int n_quads[6], n_quad1ds[6];
+    benchmark_order order;
+
+    if (benchmark_args(argc, argv, "r", options, "benchmark_kernels [-r REPEATS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    repeats = options[0];
+
+    for (n = 0; n <= 5; n++) {
+        start_order(&order, n, 0);
+        init_order(&order, num_elem, num_sides);
+        n_p      = order.n_p;
+        n_quad   = order.n_quad;
+        n_quad1d = order.n_quad1d;
+        n_quads[n]   = n_quad;
+        n_quad1ds[n] = n_quad1d;
+
+        left_old  = (double *) malloc(4 * num_sides * n_p * sizeof(double));
+        right_old = (double *) malloc(4 * num_sides * n_p * sizeof(double));
+        quad_old  = reference_buffer(0, num_coeffs);
+
+        surface_old[n] = surface_new[n] = 1e30;
+        volume_old[n]  = volume_new[n]  = 1e30;
+        for (i = 0; i < repeats; i++) {
+            start = wall_time();
+            eval_surface_per_basis(d_c, left_old, right_old, n_quad1d, n_p, num_sides, num_elem);
+            surface_old[n] = fmin(surface_old[n], wall_time() - start);
+
+            memset(d_quad_rhs, 0, num_coeffs * sizeof(double));
+            start = wall_time();
+            eval_surface(d_c, d_quad_rhs,
+                         d_s_length,
+                         d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                         d_left_elem, d_right_elem,
+                         d_left_side_number, d_right_side_number,
+                         d_Nx, d_Ny,
+                         n_quad1d, n_quad, n_p, num_sides, num_elem, 0.);
+            surface_new[n] = fmin(surface_new[n], wall_time() - start);
+
+            start = wall_time();
+            eval_volume_per_basis(d_c, quad_old, n_quad, n_p, num_elem);
+            volume_old[n] = fmin(volume_old[n], wall_time() - start);
+
+            start = wall_time();
+            eval_volume(d_c, d_quad_rhs, d_xr, d_yr, d_xs, d_ys, n_quad, n_p, num_elem);
+            volume_new[n] = fmin(volume_new[n], wall_time() - start);
+        }
+
+        // d_quad_rhs holds the last volume integral
+        memset(quad_old, 0, num_coeffs * sizeof(double));
+        eval_volume_per_basis(d_c, quad_old, n_quad, n_p, num_elem);
+        volume_diff[n] = relative_difference(quad_old);
+
+        memset(d_quad_rhs, 0, num_coeffs * sizeof(double));
+        eval_surface(d_c, d_quad_rhs,
+                     d_s_length,
+                     d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                     d_left_elem, d_right_elem,
+                     d_left_side_number, d_right_side_number,
+                     d_Nx, d_Ny,
+                     n_quad1d, n_quad, n_p, num_sides, num_elem, 0.);
+        memset(quad_old, 0, num_coeffs * sizeof(double));
+        gather_sides(left_old, right_old, quad_old, n_p, num_sides, num_elem);
+        surface_diff[n] = relative_difference(quad_old);
+
+        free(left_old);
+        free(right_old);
+        free_gpu();
+        end_order(&order);
+    }
+
+    printf("%i elements, %i sides, best of %i\n", num_elem, num_sides, repeats);
+
+    printf("\nsurface\n");
+    printf("%4s %6s %9s %14s %14s %9s %12s\n", "n", "n_p", "n_quad1d",
+           "old (ms)", "new (ms)", "speedup", "rel diff");
+    for (n = 0; n <= 5; n++) {
+        printf("%4i %6i %9i %14.3f %14.3f %8.1fx %12.2e%s\n", n, (n + 1) * (n + 2) / 2, n_quad1ds[n],
+               surface_old[n] * 1e3, surface_new[n] * 1e3, surface_old[n] / surface_new[n],
+               surface_diff[n], check(surface_diff[n]));
+    }
+
+    printf("\nvolume\n");
+    printf("%4s %6s %9s %14s %14s %9s %12s\n", "n", "n_p", "n_quad",
+           "old (ms)", "new (ms)", "speedup", "rel diff");
+    for (n = 0; n <= 5; n++) {
+        printf("%4i %6i %9i %14.3f %14.3f %8.1fx %12.2e%s\n", n, (n + 1) * (n + 2) / 2, n_quads[n],
+               volume_old[n] * 1e3, volume_new[n] * 1e3, volume_old[n] / volume_new[n],
+               volume_diff[n], check(volume_diff[n]));
+    }
+
+    free_references();
+    free_gpu_mesh();
+
+    return benchmark_failed;
+}
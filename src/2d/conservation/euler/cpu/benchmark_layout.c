@@ -0,0 +1,79 @@
+#include "benchmark.h"
+
+/* benchmark_layout.c
+ *
+ * times rk4 steps for each order with the coefficients stored in the plain
+ * [eq][mode][element] layout and in element blocks ([block][eq][mode][lane]),
+ * and checks that both layouts give the same solution. exits with 1 if they
+ * end further than BENCHMARK_TOLERANCE apart.
+ *
+ * Usage: benchmark_layout [-s STEPS] MESH
+ */
+
+int main(int argc, char *argv[]) {
+    int i, n, n_p, n_quad, n_quad1d, steps, layout, num_elem, num_sides;
+    int options[1] = {10};
+    double start, min_r, max_l, dt;
+    double step_time[2], max_diff;
+    benchmark_order order;
+
+    if (benchmark_args(argc, argv, "s", options, "benchmark_layout [-s STEPS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    steps = options[0];
+
+    printf("%i elements, %i rk4 steps, blocks of %i elements\n",
+           num_elem, steps, AOSOA_BLOCK);
+    printf("%4s %6s %14s %14s %9s %12s\n", "n", "n_p",
+           "soa (ms)", "aosoa (ms)", "speedup", "max diff");
+
+    for (n = 0; n <= 5; n++) {
+        start_order(&order, n, 0);
+        n_p      = order.n_p;
+        n_quad   = order.n_quad;
+        n_quad1d = order.n_quad1d;
+
+        for (layout = LAYOUT_SOA; layout <= LAYOUT_AOSOA; layout++) {
+            coeff_layout = layout;
+            init_order(&order, num_elem, num_sides);
+
+            // the same timestep for both layouts
+            eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
+            max_l = d_lambda[0];
+            for (i = 0; i < num_elem; i++) {
+                max_l = (d_lambda[i] > max_l) ? d_lambda[i] : max_l;
+            }
+            dt = 0.1 * min_r / max_l / (2. * n + 1.);
+
+            // warm up
+            rk4_step(dt, n_quad, n_quad1d, n_p, num_elem, num_sides);
+
+            start = wall_time();
+            for (i = 0; i < steps; i++) {
+                rk4_step(dt, n_quad, n_quad1d, n_p, num_elem, num_sides);
+            }
+            step_time[layout] = (wall_time() - start) / steps;
+
+            // compare the solutions in the same ordering
+            unpack_coefficients(d_c, reference_buffer(layout, 4 * n_p * num_elem), n_p, num_elem);
+
+            free_gpu();
+        }
+
+        max_diff = max_difference(references[LAYOUT_SOA], references[LAYOUT_AOSOA],
+                                  4 * n_p * num_elem);
+
+        printf("%4i %6i %14.3f %14.3f %8.2fx %12.2e%s\n", n, n_p,
+               step_time[LAYOUT_SOA] * 1e3, step_time[LAYOUT_AOSOA] * 1e3,
+               step_time[LAYOUT_SOA] / step_time[LAYOUT_AOSOA], max_diff, check(max_diff));
+        fflush(stdout);
+
+        end_order(&order);
+    }
+
+    free_references();
+    free_gpu_mesh();
+
+    return benchmark_failed;
+}
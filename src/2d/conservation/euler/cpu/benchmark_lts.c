@@ -0,0 +1,175 @@
+#include "benchmark.h"
+
+/* benchmark_lts.c
+ *
+ * runs the same end time for each order with rk4, with third order
+ * adams-bashforth at one global timestep (lts with one dt class) and with
+ * multirate local time stepping, and reports the best wall time of a few runs, the speedup of
+ * local time stepping over both, the largest pressure error at the vertices
+ * against the exact supersonic vortex and the largest difference from the
+ * rk4 coefficients.
+ *
+ * the sv1 meshes are nearly uniform, so -g RATIO first moves every vertex
+ * along its arc to make the elements at one end of the quarter annulus
+ * RATIO times narrower than at the other, which spreads them over several
+ * dt classes.
+ *
+ * Usage: benchmark_lts [-n ORDER] [-T ENDTIME] [-L CLASSES] [-g RATIO] [-r REPEATS] MESH
+ */
+
+/* pressure error
+ *
+ * the largest difference between the pressure at the vertices and the
+ * exact solution.
+ */
+double pressure_error(int num_elem, int n_p) {
+    int idx, v;
+    double x, y, p, error, max_error;
+
+    measure_error(d_c, d_Uv1, d_Uv2, d_Uv3,
+                  d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                  num_elem, n_p);
+
+    max_error = 0.;
+    for (idx = 0; idx < num_elem; idx++) {
+        for (v = 0; v < 3; v++) {
+            x = (v == 0) ? d_V1x[idx] : (v == 1) ? d_V2x[idx] : d_V3x[idx];
+            y = (v == 0) ? d_V1y[idx] : (v == 1) ? d_V2y[idx] : d_V3y[idx];
+            p = (v == 0) ? d_Uv1[idx] : (v == 1) ? d_Uv2[idx] : d_Uv3[idx];
+
+            error = fabs(p - pressure(rho0(x, y), u0(x, y), v0(x, y), E0(x, y), 99, idx));
+            max_error = (error > max_error) ? error : max_error;
+        }
+    }
+
+    return max_error;
+}
+
+int main(int argc, char *argv[]) {
+    int i, n, n_p, n_quad, n_quad1d, first, scheme, classes, num_classes, out, null_out;
+    int first_n, last_n, repeat, repeats;
+    int num_elem, num_sides;
+    double start, min_r, endtime, ratio, diff, max_diff;
+    double run_time[3], error[3];
+    double *r1_local, *r2_local, *w_local, *s_r, *oned_w_local;
+    double *reference;
+    lts_state lts;
+
+    first_n = 0;
+    last_n  = 5;
+    endtime = 0.1;
+    classes = max_classes;
+    ratio   = 1.;
+    repeats = 3;
+    for (first = 1; first + 1 < argc && argv[first][0] == '-'; first += 2) {
+        if (strcmp(argv[first], "-n") == 0) {
+            first_n = last_n = atoi(argv[first + 1]);
+        } else if (strcmp(argv[first], "-T") == 0) {
+            endtime = atof(argv[first + 1]);
+        } else if (strcmp(argv[first], "-L") == 0) {
+            classes = atoi(argv[first + 1]);
+        } else if (strcmp(argv[first], "-g") == 0) {
+            ratio = atof(argv[first + 1]);
+        } else if (strcmp(argv[first], "-r") == 0) {
+            repeats = atoi(argv[first + 1]);
+        }
+    }
+
+    if (first != argc - 1 || first_n < 0 || last_n > 5 || endtime <= 0.
+        || classes < 1 || classes > MAX_CLASSES || ratio < 1. || repeats < 1) {
+        printf("\nUsage: benchmark_lts [-n ORDER] [-T ENDTIME] [-L CLASSES] [-g RATIO] [-r REPEATS] MESH\n");
+        return 1;
+    }
+
+    if (read_mesh_file(argv[first], &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    if (ratio > 1.) {
+        grade_mesh(ratio, num_elem, num_sides, &min_r);
+    }
+
+    printf("%i elements, graded %g:1, T = %g, up to %i dt classes, best of %i\n",
+           num_elem, ratio, endtime, classes, repeats);
+    printf("%4s %6s %10s %10s %10s %9s %9s %11s %11s %11s %11s\n", "n", "classes",
+           "rk4 (s)", "ab3 (s)", "lts (s)", "vs rk4", "vs ab3",
+           "rk4 error", "ab3 error", "lts error", "lts diff");
+
+    // the integrators print every step
+    null_out = open("/dev/null", O_WRONLY);
+
+    for (n = first_n; n <= last_n; n++) {
+        n_p = (n + 1) * (n + 2) / 2;
+        set_quadrature(n, &r1_local, &r2_local, &w_local,
+                       &s_r, &oned_w_local, &n_quad, &n_quad1d);
+        preval_basis(r1_local, r2_local, s_r, w_local, oned_w_local, n_quad, n_quad1d, n_p);
+
+        reference = NULL;
+        for (scheme = 0; scheme < 3; scheme++) {
+            time_integrator = scheme ? INTEGRATOR_LTS : INTEGRATOR_RK4;
+            max_classes     = (scheme == 1) ? 1 : classes;
+
+            run_time[scheme] = 1e30;
+            for (repeat = 0; repeat < repeats; repeat++) {
+                if (repeat) {
+                    free_gpu();
+                }
+                init_gpu(num_elem, num_sides, n_p);
+                init_conditions(d_c, d_J, d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                                n_quad, n_p, num_elem);
+
+                // the classes time_integrate_lts is about to make
+                if (scheme == 2) {
+                    eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
+                    init_lts(&lts, d_lambda, num_elem, num_sides);
+                    num_classes = lts.num_classes;
+                    free_lts(&lts);
+                }
+
+                fflush(stdout);
+                out = dup(1);
+                dup2(null_out, 1);
+
+                start = wall_time();
+                time_integrate(n_quad, n_quad1d, n_p, n, num_elem, num_sides, endtime, min_r);
+                run_time[scheme] = fmin(run_time[scheme], wall_time() - start);
+
+                fflush(stdout);
+                dup2(out, 1);
+                close(out);
+            }
+
+            error[scheme] = pressure_error(num_elem, n_p);
+
+            if (!reference) {
+                reference = (double *) malloc(num_coeffs * sizeof(double));
+                memcpy(reference, d_c, num_coeffs * sizeof(double));
+            }
+            max_diff = 0.;
+            for (i = 0; i < num_coeffs; i++) {
+                diff = fabs(d_c[i] - reference[i]);
+                max_diff = (diff > max_diff) ? diff : max_diff;
+            }
+
+            free_gpu();
+        }
+
+        printf("%4i %6i %10.3f %10.3f %10.3f %8.2fx %8.2fx %11.3e %11.3e %11.3e %11.3e\n",
+               n, num_classes, run_time[0], run_time[1], run_time[2],
+               run_time[0] / run_time[2], run_time[1] / run_time[2],
+               error[0], error[1], error[2], max_diff);
+        fflush(stdout);
+
+        free(reference);
+
+        free(r1_local);
+        free(r2_local);
+        free(w_local);
+        free(s_r);
+        free(oned_w_local);
+    }
+
+    close(null_out);
+    free_gpu_mesh();
+
+    return 0;
+}
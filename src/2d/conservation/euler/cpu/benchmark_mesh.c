@@ -0,0 +1,133 @@
+#include "benchmark.h"
+
+/* benchmark_mesh.c
+ *
+ * times the mesh startup against the number of elements, both for text
+ * meshes (read_mesh, connectivity and precomputations) and for the same mesh
+ * converted to the binary format. the meshes are structured triangulations of
+ * the unit square with the outer sides marked as boundaries.
+ *
+ * first checks that a vertex written as -0 in one element and 0 in the other
+ * is still one vertex, so the side between them is found; exits with 1 if
+ * it isn't.
+ *
+ * Usage: benchmark_mesh [max cells per side]
+ */
+
+/* write mesh
+ *
+ * splits each of the k x k cells into two triangles and writes them out.
+ */
+void write_mesh(char *filename, int k) {
+    int i, j;
+    double h = 1. / k;
+    double x0, y0, x1, y1;
+    FILE *mesh_file = fopen(filename, "w");
+
+    fprintf(mesh_file, "%i\n", 2 * k * k);
+    for (j = 0; j < k; j++) {
+        for (i = 0; i < k; i++) {
+            x0 = i * h;
+            y0 = j * h;
+            x1 = (i + 1) * h;
+            y1 = (j + 1) * h;
+
+            // lower triangle; side 0 is on the bottom boundary
+            fprintf(mesh_file, "%.17g %.17g %.17g %.17g %.17g %.17g %i %i\n",
+                    x0, y0, x1, y0, x1, y1,
+                    (j == 0) ? 0 : ((i == k - 1) ? 1 : -1), 20000);
+
+            // upper triangle; side 1 is on the top boundary
+            fprintf(mesh_file, "%.17g %.17g %.17g %.17g %.17g %.17g %i %i\n",
+                    x0, y0, x1, y1, x0, y1,
+                    (j == k - 1) ? 1 : ((i == 0) ? 2 : -1), 20000);
+        }
+    }
+
+    fclose(mesh_file);
+}
+
+/* check signed zero
+ *
+ * two triangles sharing the side from (0, 0) to (0, 1), written with 0 in
+ * the first and -0 in the second. returns 1 unless that side is one interior
+ * side.
+ */
+int check_signed_zero(char *filename) {
+    int num_elem, num_sides, interior, i;
+    double min_r;
+    FILE *mesh_file = fopen(filename, "w");
+
+    fprintf(mesh_file, "2\n");
+    fprintf(mesh_file, "-1 0 0 0 0 1 -1 20000\n");
+    fprintf(mesh_file, "-0 1 -0 0 1 0 -1 20000\n");
+    fclose(mesh_file);
+
+    if (read_mesh_file(filename, &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+
+    interior = 0;
+    for (i = 0; i < num_sides; i++) {
+        interior += d_right_elem[i] >= 0;
+    }
+    free_gpu_mesh();
+    remove(filename);
+
+    printf("signed zero: %i sides, %i interior%s\n", num_sides, interior,
+           (num_sides != 5 || interior != 1) ? "  FAILED" : "");
+
+    return num_sides != 5 || interior != 1;
+}
+
+int main(int argc, char *argv[]) {
+    int i, k, num_elem, num_sides, max_k;
+    double start, text_time, map_time, touch_time, min_r;
+    volatile double sum;
+    char text_filename[] = "/tmp/benchmark_mesh.pmsh";
+    char binary_filename[] = "/tmp/benchmark_mesh.bmsh";
+
+    max_k = (argc > 1) ? atoi(argv[1]) : 1024;
+
+    if (check_signed_zero(text_filename)) {
+        return 1;
+    }
+
+    printf("%10s %10s %12s %12s %12s %12s\n", "elements", "sides", 
+           "text (s)", "ns/elem", "mmap (s)", "+touch (s)");
+    for (k = 16; k <= max_k; k *= 2) {
+        write_mesh(text_filename, k);
+
+        // text mesh
+        start = wall_time();
+        read_mesh_file(text_filename, &num_elem, &num_sides, &min_r);
+        text_time = wall_time() - start;
+
+        write_binary_mesh(binary_filename, num_elem, num_sides, min_r);
+        free_gpu_mesh();
+
+        // binary mesh; the pages only get read once something touches them
+        start = wall_time();
+        read_binary_mesh(binary_filename, &num_elem, &num_sides, &min_r);
+        map_time = wall_time() - start;
+
+        sum = 0.;
+        for (i = 0; i < num_elem; i++) {
+            sum += d_J[i] + d_xr[i] + d_elem_s1[i];
+        }
+        for (i = 0; i < num_sides; i++) {
+            sum += d_Nx[i] + d_left_elem[i];
+        }
+        touch_time = wall_time() - start;
+        free_gpu_mesh();
+
+        printf("%10i %10i %12.4f %12.1f %12.6f %12.4f\n", num_elem, num_sides,
+                text_time, text_time / num_elem * 1e9, map_time, touch_time);
+        fflush(stdout);
+    }
+
+    remove(text_filename);
+    remove(binary_filename);
+
+    return 0;
+}
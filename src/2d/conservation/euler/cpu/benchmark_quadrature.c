@@ -0,0 +1,152 @@
+#include "benchmark.h"
+
+/* benchmark_quadrature.c
+ *
+ * checks the symmetric 2d rule set_quadrature picks for each order n, and
+ * times the volume kernels on it against the collapsed coordinate rule from
+ * set_tensor_quadrature, the only one there was past order 5 before. a rule
+ * for order n has to integrate every basis function of degree up to 2n
+ * exactly. the check integrates the orthonormal basis to degree 2n + 2,
+ * which should give 1 / sqrt(2) for phi_0 and 0 for the rest, and reports
+ * the largest error up to 2n and the highest degree with errors under 1e-13.
+ * it also reports the smallest weight and the smallest barycentric coordinate
+ * of any point, which are both positive for a rule with positive weights
+ * and all its points inside. the cost of the volume kernels is linear in the
+ * number of points, so the times should go down about as the points do.
+ * the generic scalar kernel runs for both rules, so the specialized ones
+ * up to order 5 don't skew the comparison.
+ *
+ * exits with 1 if any rule isn't exact to degree 2n, or has a weight or a
+ * point that isn't positive.
+ *
+ * Usage: benchmark_quadrature [-r REPEATS] MESH
+ */
+
+volume_ftn isa_volume_ftns[] = {eval_volume, eval_volume_avx2, eval_volume_avx512};
+
+/* moment error
+ *
+ * the largest error integrating the basis functions of degree d with the
+ * rule.
+ */
+double moment_error(double *r1_local, double *r2_local, double *w_local, int n_quad, int d) {
+    int i, j;
+    double sum, error, phi_r, phi_s;
+
+    error = 0.;
+    for (i = d * (d + 1) / 2; i < (d + 1) * (d + 2) / 2; i++) {
+        sum = (i == 0) ? -1. / sqrt(2.) : 0.;
+        for (j = 0; j < n_quad; j++) {
+            sum += w_local[j] * dubiner(i, r1_local[j], r2_local[j], &phi_r, &phi_s);
+        }
+        error = fmax(error, fabs(sum));
+    }
+
+    return error;
+}
+
+/* time rule volume
+ *
+ * the best time of repeats calls of volume, with the basis on the order's
+ * rule.
+ */
+double time_rule_volume(volume_ftn volume, benchmark_order *order,
+                        int num_elem, int num_sides, int repeats) {
+    double time;
+
+    preval_basis(order->r1, order->r2, order->s_r, order->w, order->oned_w,
+                 order->n_quad, order->n_quad1d, order->n_p);
+    init_order(order, num_elem, num_sides);
+
+    // warm up
+    volume(d_c, d_quad_rhs, d_xr, d_yr, d_xs, d_ys, order->n_quad, order->n_p, num_elem);
+
+    time = time_volume(volume, order->n_quad, order->n_p, num_elem, repeats);
+
+    free_gpu();
+
+    return time;
+}
+
+int main(int argc, char *argv[]) {
+    int n, d, i, isa, best_isa, repeats, exact;
+    int num_elem, num_sides;
+    int options[1] = {20};
+    double min_r, error, min_w, min_coord;
+    double symmetric_time, tensor_time;
+    benchmark_order symmetric, tensor;
+
+    if (benchmark_args(argc, argv, "r", options, "benchmark_quadrature [-r REPEATS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    repeats = options[0];
+
+    best_isa = detect_isa();
+
+    printf("exactness\n");
+    printf("%4s %8s %8s %12s %10s %10s %10s\n", "n", "points", "exact to",
+           "err to 2n", "min w", "min coord", "collapsed");
+
+    for (n = 0; n <= MAX_ORDER; n++) {
+        start_order(&symmetric, n, 0);
+
+        error = 0.;
+        for (d = 0; d <= 2 * n; d++) {
+            error = fmax(error, moment_error(symmetric.r1, symmetric.r2, symmetric.w,
+                                             symmetric.n_quad, d));
+        }
+        exact = -1;
+        while (exact < 2 * n + 2 && moment_error(symmetric.r1, symmetric.r2, symmetric.w,
+                                                 symmetric.n_quad, exact + 1) < 1e-13) {
+            exact++;
+        }
+
+        min_w     = symmetric.w[0];
+        min_coord = 1.;
+        for (i = 0; i < symmetric.n_quad; i++) {
+            min_w     = fmin(min_w, symmetric.w[i]);
+            min_coord = fmin(min_coord, fmin(fmin(symmetric.r1[i], symmetric.r2[i]),
+                                             1. - symmetric.r1[i] - symmetric.r2[i]));
+        }
+
+        printf("%4i %8i %8i %12.2e %10.2e %10.2e %10i%s\n", n, symmetric.n_quad, exact, error,
+               min_w, min_coord, (n + 1) * (n + 1),
+               (exact < 2 * n || min_w <= 0. || min_coord <= 0.) ? "  FAILED" : "");
+        if (exact < 2 * n || min_w <= 0. || min_coord <= 0.) {
+            benchmark_failed = 1;
+        }
+
+        end_order(&symmetric);
+    }
+
+    printf("volume (ms), %i elements, best of %i, this cpu has %s\n",
+           num_elem, repeats, isa_names[best_isa]);
+    printf("%4s %8s %8s %10s %10s %10s %8s\n", "n", "isa", "points", "collapsed",
+           "symmetric", "collapsed", "speedup");
+
+    for (n = 1; n <= MAX_ORDER; n++) {
+        start_order(&symmetric, n, 0);
+        start_order(&tensor, n, 1);
+
+        for (isa = ISA_SCALAR; isa <= best_isa; isa++) {
+            symmetric_time = time_rule_volume(isa_volume_ftns[isa], &symmetric,
+                                              num_elem, num_sides, repeats);
+            tensor_time    = time_rule_volume(isa_volume_ftns[isa], &tensor,
+                                              num_elem, num_sides, repeats);
+
+            printf("%4i %8s %8i %10i %10.3f %10.3f %7.2fx\n", n, isa_names[isa],
+                   symmetric.n_quad, tensor.n_quad, symmetric_time * 1e3, tensor_time * 1e3,
+                   tensor_time / symmetric_time);
+            fflush(stdout);
+        }
+
+        end_order(&symmetric);
+        end_order(&tensor);
+    }
+
+    free_gpu_mesh();
+    free_basis();
+
+    return benchmark_failed;
+}
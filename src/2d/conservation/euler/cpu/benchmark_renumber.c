@@ -0,0 +1,141 @@
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include "benchmark.h"
+
+/* benchmark_renumber.c
+ *
+ * times rk4 steps on each mesh with every element ordering. along with the
+ * step time it reports the mean distance in memory between the two elements
+ * of an interior side and, where the hardware counters can be read, the
+ * number of cache misses per step.
+ *
+ * Usage: benchmark_renumber [-n ORDER] [-s STEPS] MESH...
+ */
+
+/* open cache counter
+ *
+ * returns a perf event counting this process's cache misses, or -1 if the
+ * counters aren't available (virtual machines often don't have them).
+ */
+int open_cache_counter() {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+int main(int argc, char *argv[]) {
+    int i, m, first_mesh, ordering, steps, counter;
+    int n, n_p, n_quad, n_quad1d, num_elem, num_sides, num_interior;
+    long long misses;
+    double start, step_time, distance, min_r, max_l, dt;
+    double *r1_local, *r2_local, *w_local, *s_r, *oned_w_local;
+    char *name;
+
+    n = 2;
+    steps = 20;
+    for (first_mesh = 1; first_mesh + 1 < argc && argv[first_mesh][0] == '-'; first_mesh += 2) {
+        if (strcmp(argv[first_mesh], "-n") == 0) {
+            n = atoi(argv[first_mesh + 1]);
+        } else if (strcmp(argv[first_mesh], "-s") == 0) {
+            steps = atoi(argv[first_mesh + 1]);
+        }
+    }
+
+    if (first_mesh >= argc || n < 0 || n > 5 || steps < 1) {
+        printf("\nUsage: benchmark_renumber [-n ORDER] [-s STEPS] MESH...\n");
+        return 1;
+    }
+
+    n_p = (n + 1) * (n + 2) / 2;
+    set_quadrature(n, &r1_local, &r2_local, &w_local,
+                   &s_r, &oned_w_local, &n_quad, &n_quad1d);
+    preval_basis(r1_local, r2_local, s_r, w_local, oned_w_local, n_quad, n_quad1d, n_p);
+
+    counter = open_cache_counter();
+    if (counter < 0) {
+        printf("hardware cache counters aren't available; misses are n/a\n");
+    }
+
+    printf("n = %i, %i rk4 steps\n", n, steps);
+    printf("%-24s %8s %8s %12s %12s %14s\n", "mesh", "elements", "ordering",
+           "distance", "step (ms)", "misses/step");
+
+    for (m = first_mesh; m < argc; m++) {
+        for (ordering = ORDER_NONE; ordering <= ORDER_MORTON; ordering++) {
+            mesh_ordering = ordering;
+            if (read_mesh_file(argv[m], &num_elem, &num_sides, &min_r)) {
+                return 1;
+            }
+            init_gpu(num_elem, num_sides, n_p);
+            init_conditions(d_c, d_J, d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y,
+                            n_quad, n_p, num_elem);
+
+            // how far apart neighbors are in the coefficient arrays
+            distance = 0.;
+            num_interior = 0;
+            for (i = 0; i < num_sides; i++) {
+                if (d_right_elem[i] >= 0) {
+                    distance += abs(d_left_elem[i] - d_right_elem[i]);
+                    num_interior++;
+                }
+            }
+            distance /= (num_interior > 0) ? num_interior : 1;
+
+            // small enough to stay stable for the whole run
+            eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
+            max_l = d_lambda[0];
+            for (i = 0; i < num_elem; i++) {
+                max_l = (d_lambda[i] > max_l) ? d_lambda[i] : max_l;
+            }
+            dt = 0.1 * min_r / max_l / (2. * n + 1.);
+
+            // warm up
+            rk4_step(dt, n_quad, n_quad1d, n_p, num_elem, num_sides);
+
+            if (counter >= 0) {
+                ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+                ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+            }
+            start = wall_time();
+            for (i = 0; i < steps; i++) {
+                rk4_step(dt, n_quad, n_quad1d, n_p, num_elem, num_sides);
+            }
+            step_time = (wall_time() - start) / steps;
+            misses = -1;
+            if (counter >= 0) {
+                ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+                read(counter, &misses, sizeof(misses));
+            }
+
+            name = strrchr(argv[m], '/') ? strrchr(argv[m], '/') + 1 : argv[m];
+            printf("%-24.24s %8i %8s %12.1f %12.3f ", name, num_elem,
+                   ordering_names[ordering], distance, step_time * 1e3);
+            if (misses >= 0) {
+                printf("%14.0f\n", (double) misses / steps);
+            } else {
+                printf("%14s\n", "n/a");
+            }
+            fflush(stdout);
+
+            free_gpu();
+            free_gpu_mesh();
+        }
+    }
+
+    free(r1_local);
+    free(r2_local);
+    free(w_local);
+    free(s_r);
+    free(oned_w_local);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "benchmark.h"
+
+/* benchmark_simd.c
+ *
+ * times the volume and surface kernels for each order with every vector
+ * instruction set this cpu has against the scalar ones specialized for the
+ * order, and reports elements or sides per second and the largest difference
+ * from the scalar residual, relative to its largest entry. the volume kernel
+ * also gets GFLOP/s, counted from the arithmetic it does for each element, a
+ * multiply-add as two:
+ *
+ *      interpolation   8 * n_p * n_quad
+ *      flux            49 * n_quad
+ *      projection      16 * n_p * n_quad
+ *
+ * the surface rate counts the interior sides, which the vector kernels do
+ * LANES at a time; the boundary sides are the same scalar code either way.
+ * exits with 1 if any residual is further than BENCHMARK_TOLERANCE from the
+ * scalar one.
+ *
+ * Usage: benchmark_simd [-r REPEATS] MESH
+ */
+
+volume_ftn  isa_volume_ftns[]  = {NULL, eval_volume_avx2, eval_volume_avx512};
+surface_ftn isa_surface_ftns[] = {NULL, eval_surface_avx2, eval_surface_avx512};
+
+int main(int argc, char *argv[]) {
+    int n, isa, best_isa;
+    int num_elem, num_sides, num_interior;
+    int options[1] = {20};
+    double volume_time, surface_time, min_r, flops;
+    double volume_diff, surface_diff;
+    benchmark_order order;
+
+    if (benchmark_args(argc, argv, "r", options, "benchmark_simd [-r REPEATS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    num_interior = color_ranges[0][num_colors[0]];
+
+    best_isa = detect_isa();
+
+    printf("%i elements, %i interior sides, best of %i, this cpu has %s\n",
+           num_elem, num_interior, options[0], isa_names[best_isa]);
+    printf("%4s %8s %10s %10s %10s %10s %12s %10s %10s\n", "n", "isa",
+           "vol (ms)", "Melem/s", "GFLOP/s", "rel diff",
+           "surf (ms)", "Msides/s", "rel diff");
+
+    for (n = 0; n <= 5; n++) {
+        start_order(&order, n, 0);
+        init_order(&order, num_elem, num_sides);
+
+        flops = (24. * order.n_p * order.n_quad + 49. * order.n_quad) * num_elem;
+
+        // the scalar kernels specialized for the order, to compare against
+        save_residuals(volume_ftns[n], surface_ftns[n],
+                       order.n_quad, order.n_quad1d, order.n_p, num_elem, num_sides);
+
+        for (isa = ISA_SCALAR; isa <= best_isa; isa++) {
+            volume_ftn  volume  = isa ? isa_volume_ftns[isa]  : volume_ftns[n];
+            surface_ftn surface = isa ? isa_surface_ftns[isa] : surface_ftns[n];
+
+            // also warms up
+            kernel_differences(volume, surface,
+                               order.n_quad, order.n_quad1d, order.n_p, num_elem, num_sides,
+                               &volume_diff, &surface_diff);
+
+            volume_time  = time_volume(volume, order.n_quad, order.n_p, num_elem, options[0]);
+            surface_time = time_surface(surface, order.n_quad, order.n_quad1d, order.n_p,
+                                        num_elem, num_sides, options[0]);
+
+            printf("%4i %8s %10.3f %10.2f %10.2f %10.2e %12.3f %10.2f %10.2e%s\n", n, isa_names[isa],
+                   volume_time * 1e3, num_elem / volume_time / 1e6, flops / volume_time / 1e9,
+                   volume_diff,
+                   surface_time * 1e3, num_interior / surface_time / 1e6, surface_diff,
+                   check(fmax(volume_diff, surface_diff)));
+            fflush(stdout);
+        }
+
+        free_gpu();
+        end_order(&order);
+    }
+
+    free_references();
+    free_gpu_mesh();
+
+    return benchmark_failed;
+}
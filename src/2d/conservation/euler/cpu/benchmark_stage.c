@@ -0,0 +1,150 @@
+#include "benchmark.h"
+
+/* benchmark_stage.c
+ *
+ * times rk4 steps for each order with the fused stage update (rk4_stage)
+ * against the separate passes it replaced: eval_rhs_rk4 writing k_i,
+ * rk4_tempstorage forming k* and rk4 combining all four k_i at the end. the
+ * update passes are also timed on their own, with the residual held fixed,
+ * next to the number of bytes they read and write per step. exits with 1 if
+ * the two end further than BENCHMARK_TOLERANCE apart.
+ *
+ * Usage: benchmark_stage [-s STEPS] MESH
+ */
+
+// the k_i for the separate passes
+double *k[4];
+
+/* separate step
+ *
+ * the rk4 update passes as they were before rk4_stage. the residual is only
+ * evaluated if with_residual is set.
+ */
+void separate_step(double dt, int with_residual,
+                   int n_quad, int n_quad1d, int n_p, int num_elem, int num_sides) {
+    double alpha[3] = {0.5, 0.5, 1.0};
+    int s;
+
+    for (s = 0; s < 4; s++) {
+        if (with_residual) {
+            residual(s ? d_kstar : d_c, n_quad, n_quad1d, n_p, num_elem, num_sides);
+        }
+        eval_rhs_rk4(k[s], d_quad_rhs, d_J, dt, n_p, num_elem);
+        if (s < 3) {
+            rk4_tempstorage(d_c, d_kstar, k[s], alpha[s], n_p, num_elem);
+        }
+    }
+    rk4(d_c, k[0], k[1], k[2], k[3], n_p, num_elem);
+}
+
+/* fused step
+ *
+ * the rk4 update passes as time_integrate_rk4 does them.
+ */
+void fused_step(double dt, int with_residual,
+                int n_quad, int n_quad1d, int n_p, int num_elem, int num_sides) {
+    int s;
+
+    for (s = 0; s < 4; s++) {
+        if (with_residual) {
+            residual(s ? d_kstar : d_c, n_quad, n_quad1d, n_p, num_elem, num_sides);
+        }
+        rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, s + 1, n_p, num_elem, NULL, NULL);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int i, n, n_p, n_quad, n_quad1d, steps, fused, num_elem, num_sides;
+    int options[1] = {10};
+    double start, min_r, max_l, dt, max_diff;
+    double step_time[2], update_time[2], bytes[2];
+    benchmark_order order;
+
+    if (benchmark_args(argc, argv, "s", options, "benchmark_stage [-s STEPS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    steps = options[0];
+
+    printf("%i elements, %i rk4 steps\n", num_elem, steps);
+    printf("%4s %6s %12s %12s %12s %12s %12s %12s %12s\n", "n", "n_p",
+           "step (ms)", "fused (ms)", "update (ms)", "fused (ms)",
+           "MB/step", "fused MB", "max diff");
+
+    for (n = 0; n <= 5; n++) {
+        start_order(&order, n, 0);
+        n_p      = order.n_p;
+        n_quad   = order.n_quad;
+        n_quad1d = order.n_quad1d;
+
+        for (fused = 0; fused <= 1; fused++) {
+            init_order(&order, num_elem, num_sides);
+            for (i = 0; i < 4; i++) {
+                k[i] = (double *) calloc(num_coeffs, sizeof(double));
+            }
+
+            eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
+            max_l = d_lambda[0];
+            for (i = 0; i < num_elem; i++) {
+                max_l = (d_lambda[i] > max_l) ? d_lambda[i] : max_l;
+            }
+            dt = 0.1 * min_r / max_l / (2. * n + 1.);
+
+            // warm up
+            if (fused) {
+                fused_step(dt, 1, n_quad, n_quad1d, n_p, num_elem, num_sides);
+            } else {
+                separate_step(dt, 1, n_quad, n_quad1d, n_p, num_elem, num_sides);
+            }
+
+            start = wall_time();
+            for (i = 0; i < steps; i++) {
+                if (fused) {
+                    fused_step(dt, 1, n_quad, n_quad1d, n_p, num_elem, num_sides);
+                } else {
+                    separate_step(dt, 1, n_quad, n_quad1d, n_p, num_elem, num_sides);
+                }
+            }
+            step_time[fused] = (wall_time() - start) / steps;
+
+            memcpy(reference_buffer(fused, num_coeffs), d_c, num_coeffs * sizeof(double));
+
+            // just the update passes, on whatever residual is left over
+            start = wall_time();
+            for (i = 0; i < steps; i++) {
+                if (fused) {
+                    fused_step(dt, 0, n_quad, n_quad1d, n_p, num_elem, num_sides);
+                } else {
+                    separate_step(dt, 0, n_quad, n_quad1d, n_p, num_elem, num_sides);
+                }
+            }
+            update_time[fused] = (wall_time() - start) / steps;
+
+            for (i = 0; i < 4; i++) {
+                free(k[i]);
+            }
+            free_gpu();
+        }
+
+        // coefficient sized arrays read or written per step, plus J once for
+        // each pass over the residual. separate: eval_rhs_rk4 2 x 4,
+        // rk4_tempstorage 3 x 3, rk4 6. fused: 4 + 5 + 5 + 3.
+        bytes[0] = (23. * num_coeffs + 4. * num_elem) * sizeof(double);
+        bytes[1] = (17. * num_coeffs + 4. * num_elem) * sizeof(double);
+
+        max_diff = max_difference(references[0], references[1], num_coeffs);
+
+        printf("%4i %6i %12.3f %12.3f %12.3f %12.3f %12.2f %12.2f %12.2e%s\n", n, n_p,
+               step_time[0] * 1e3, step_time[1] * 1e3,
+               update_time[0] * 1e3, update_time[1] * 1e3,
+               bytes[0] / 1e6, bytes[1] / 1e6, max_diff, check(max_diff));
+        fflush(stdout);
+
+        end_order(&order);
+    }
+
+    free_references();
+    free_gpu_mesh();
+
+    return benchmark_failed;
+}
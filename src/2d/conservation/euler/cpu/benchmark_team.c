@@ -0,0 +1,118 @@
+#include "benchmark.h"
+
+/* benchmark_team.c
+ *
+ * runs rk4 for about STEPS timesteps for each order with the kernels forking
+ * and joining their own threads and with one pinned thread team for the
+ * whole run (-P team), and reports the best wall time per step of a few runs,
+ * the speedup of the team, and the largest difference between the
+ * coefficients the two end up with, which should be 0; it exits with 1 if
+ * that's over BENCHMARK_TOLERANCE. on a small mesh a step is only a few
+ * hundred microseconds of work, split over 4 stages of 2 + the number of
+ * side colors kernels each, so the cost of starting and stopping the threads
+ * for every kernel shows up here.
+ *
+ * Usage: benchmark_team [-n ORDER] [-s STEPS] [-r REPEATS] MESH
+ */
+
+int main(int argc, char *argv[]) {
+    int n, backend, out, null_out;
+    int first_n, last_n, repeat, repeats, steps, kernels;
+    int num_elem, num_sides;
+    // -n ORDER runs just that order
+    int options[3] = {-1, 200, 5};
+    long step_count[2];
+    double start, min_r, endtime, min_dt, max_l, max_diff;
+    double step_time[2];
+    benchmark_order order;
+
+    if (benchmark_args(argc, argv, "nsr", options,
+                       "benchmark_team [-n ORDER] [-s STEPS] [-r REPEATS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    first_n = (options[0] >= 0) ? options[0] : 0;
+    last_n  = (options[0] >= 0) ? options[0] : 5;
+    steps   = options[1];
+    repeats = options[2];
+
+    if (last_n > MAX_ORDER || steps < 1 || repeats < 1) {
+        printf("\nUsage: benchmark_team [-n ORDER] [-s STEPS] [-r REPEATS] MESH\n");
+        return 1;
+    }
+
+    kernels = 2 + num_colors[0] + num_colors[1] + num_colors[2] + num_colors[3];
+    printf("%i elements, %i sides, %i kernels a stage, %i threads, best of %i\n",
+           num_elem, num_sides, kernels,
+#ifdef _OPENMP
+           omp_get_max_threads(),
+#else
+           1,
+#endif
+           repeats);
+    printf("%4s %6s %16s %16s %9s %11s\n", "n", "steps",
+           "forkjoin (us)", "team (us)", "speedup", "max diff");
+
+    // the integrator prints every step
+    null_out = open("/dev/null", O_WRONLY);
+
+    for (n = first_n; n <= last_n; n++) {
+        start_order(&order, n, 0);
+
+        for (backend = THREADS_FORKJOIN; backend <= THREADS_TEAM; backend++) {
+            thread_backend  = backend;
+            time_integrator = INTEGRATOR_RK4;
+
+            step_time[backend] = 1e30;
+            for (repeat = 0; repeat < repeats; repeat++) {
+                if (repeat || backend) {
+                    free_gpu();
+                }
+                init_order(&order, num_elem, num_sides);
+
+                // the first step's dt; the rest are about the same
+                min_dt  = eval_global_cfl(d_c, d_radius, &max_l, order.n_p, num_elem);
+                endtime = steps * 0.7 * min_dt / order_scale(n);
+
+                fflush(stdout);
+                out = dup(1);
+                dup2(null_out, 1);
+
+                // the last stage of every rk4 step finds the next cfl limit
+                step_count[backend] = wave_speed_fused;
+                start = wall_time();
+                time_integrate(order.n_quad, order.n_quad1d, order.n_p, n,
+                               num_elem, num_sides, endtime, min_r);
+                step_time[backend]  = fmin(step_time[backend], wall_time() - start);
+                step_count[backend] = wave_speed_fused - step_count[backend];
+
+                fflush(stdout);
+                dup2(out, 1);
+                close(out);
+            }
+            step_time[backend] /= step_count[backend];
+
+            memcpy(reference_buffer(backend, num_coeffs), d_c, num_coeffs * sizeof(double));
+        }
+        free_gpu();
+
+        max_diff = max_difference(references[THREADS_FORKJOIN], references[THREADS_TEAM],
+                                  num_coeffs);
+
+        printf("%4i %6li %16.2f %16.2f %8.2fx %11.3e%s\n",
+               n, step_count[THREADS_TEAM],
+               step_time[THREADS_FORKJOIN] * 1e6, step_time[THREADS_TEAM] * 1e6,
+               step_time[THREADS_FORKJOIN] / step_time[THREADS_TEAM], max_diff,
+               check(max_diff));
+        fflush(stdout);
+
+        end_order(&order);
+    }
+
+    close(null_out);
+    free_references();
+    free_gpu_mesh();
+    free_basis();
+
+    return benchmark_failed;
+}
@@ -0,0 +1,113 @@
+#include "benchmark.h"
+
+/* benchmark_tensor.c
+ *
+ * times the sum factored volume and surface kernels for each order from 3 to
+ * MAX_ORDER against the dense generic ones on the same collapsed coordinate
+ * points, scalar and for the widest vector instruction set this cpu has, and
+ * reports the largest difference of the tensor residuals from the dense
+ * scalar ones, relative to its largest entry. the arithmetic each volume
+ * kernel does for each element, a multiply-add as two, with q = n + 1 points
+ * in each direction, is
+ *
+ *      dense   interpolation   8 * n_p * q^2
+ *              projection      16 * n_p * q^2
+ *      tensor  interpolation   8 * (n_p * q + q^3)
+ *              projection      8 * (3 q^3 + 2 n_p * q)
+ *
+ * plus 49 * q^2 for the flux either way. the surface kernels only differ on
+ * side 2 of an element, so there's only the scalar tensor one; the dense
+ * vector one is there to compare with. exits with 1 if any tensor residual
+ * is further than BENCHMARK_TOLERANCE from the dense one.
+ *
+ * Usage: benchmark_tensor [-r REPEATS] MESH
+ */
+
+volume_ftn  dense_volume_ftns[]  = {eval_volume,  eval_volume_avx2,  eval_volume_avx512};
+volume_ftn  tensor_volume_ftns[] = {eval_volume_tensor, eval_volume_tensor_avx2,
+                                    eval_volume_tensor_avx512};
+surface_ftn dense_surface_ftns[] = {eval_surface, eval_surface_avx2, eval_surface_avx512};
+
+int main(int argc, char *argv[]) {
+    int n, q, n_p, n_quad, n_quad1d, isa, best_isa, repeats;
+    int num_elem, num_sides;
+    int options[1] = {20};
+    double min_r, dense_flops, tensor_flops;
+    double dense_volume[3], tensor_volume[3], volume_diff[3];
+    double dense_surface[MAX_ORDER - 2][2], tensor_surface[MAX_ORDER - 2];
+    double surface_diff[MAX_ORDER - 2];
+    benchmark_order order;
+
+    if (benchmark_args(argc, argv, "r", options, "benchmark_tensor [-r REPEATS] MESH",
+                       &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+    repeats = options[0];
+
+    best_isa = detect_isa();
+
+    printf("%i elements, %i sides, best of %i, this cpu has %s\n",
+           num_elem, num_sides, repeats, isa_names[best_isa]);
+    printf("volume (ms)\n");
+    printf("%4s %6s %8s %8s %10s %10s %8s %10s\n", "n", "n_quad", "flops",
+           "isa", "dense", "tensor", "speedup", "rel diff");
+
+    for (n = 3; n <= MAX_ORDER; n++) {
+        start_order(&order, n, 1);
+        init_order(&order, num_elem, num_sides);
+        q        = n + 1;
+        n_p      = order.n_p;
+        n_quad   = order.n_quad;
+        n_quad1d = order.n_quad1d;
+
+        dense_flops  = 24. * n_p * q * q + 49. * q * q;
+        tensor_flops = 8. * (n_p * q + q * q * q) + 8. * (3. * q * q * q + 2. * n_p * q) + 49. * q * q;
+
+        // the dense scalar residuals
+        save_residuals(eval_volume, eval_surface, n_quad, n_quad1d, n_p, num_elem, num_sides);
+        kernel_differences(NULL, eval_surface_tensor, n_quad, n_quad1d, n_p, num_elem, num_sides,
+                           NULL, &surface_diff[n - 3]);
+
+        for (isa = ISA_SCALAR; isa <= best_isa; isa++) {
+            kernel_differences(tensor_volume_ftns[isa], NULL, n_quad, n_quad1d, n_p,
+                               num_elem, num_sides, &volume_diff[isa], NULL);
+
+            dense_volume[isa]  = time_volume(dense_volume_ftns[isa],  n_quad, n_p, num_elem, repeats);
+            tensor_volume[isa] = time_volume(tensor_volume_ftns[isa], n_quad, n_p, num_elem, repeats);
+
+            printf("%4i %6i %7.2fx %8s %10.3f %10.3f %7.2fx %10.2e%s\n",
+                   n, n_quad, dense_flops / tensor_flops, isa_names[isa],
+                   dense_volume[isa] * 1e3, tensor_volume[isa] * 1e3,
+                   dense_volume[isa] / tensor_volume[isa], volume_diff[isa],
+                   check(volume_diff[isa]));
+            fflush(stdout);
+        }
+
+        dense_surface[n - 3][0] = time_surface(eval_surface, n_quad, n_quad1d, n_p,
+                                               num_elem, num_sides, repeats);
+        dense_surface[n - 3][1] = time_surface(dense_surface_ftns[best_isa], n_quad, n_quad1d, n_p,
+                                               num_elem, num_sides, repeats);
+        tensor_surface[n - 3]   = time_surface(eval_surface_tensor, n_quad, n_quad1d, n_p,
+                                               num_elem, num_sides, repeats);
+
+        free_gpu();
+        end_order(&order);
+    }
+
+    printf("surface (ms)\n");
+    printf("%4s %10s %10s %10s %8s %10s\n", "n", "dense", isa_names[best_isa], "tensor",
+           "speedup", "rel diff");
+    for (n = 3; n <= MAX_ORDER; n++) {
+        printf("%4i %10.3f %10.3f %10.3f %7.2fx %10.2e%s\n", n,
+               dense_surface[n - 3][0] * 1e3, dense_surface[n - 3][1] * 1e3,
+               tensor_surface[n - 3] * 1e3,
+               dense_surface[n - 3][0] / tensor_surface[n - 3], surface_diff[n - 3],
+               check(surface_diff[n - 3]));
+    }
+
+    free_references();
+    free_gpu_mesh();
+    free_basis();
+
+    return benchmark_failed;
+}
@@ -2,10 +2,21 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <immintrin.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "euler_kernels.c"
 #include "time_integrator_euler.c"
 #include "quadrature.c"
 #include "basis.c"
+#include "mesh.c"
+#include "renumber.c"
 
 /* 2dadvec_euler.cu
  * 
@@ -13,10 +24,60 @@
  * DG method.
  */
 
+/* set tensor quadrature
+ *
+ * the same as set_quadrature, but the 2d rule is the collapsed coordinate one
+ * the tensor kernels factor: n + 1 gauss-legendre points in
+ *
+ *      a = 2 s / (1 - r) - 1
+ *
+ * times n + 1 gauss-jacobi points for the weight (1 - b) in b = 2 r - 1,
+ * exact to degree 2n + 1. point ib * (n + 1) + ia is (a_ia, b_ib). the 1d
+ * rule is gauss-legendre, as for set_quadrature.
+ */
+void set_tensor_quadrature(int n,
+                           double **r1_local, double **r2_local, double **w_local,
+                           double **s_r, double **oned_w_local,
+                           int *n_quad, int *n_quad1d) {
+    int ia, ib, j;
+    int q = n + 1;
+    double a[q], wa[q], b[q], wb[q];
+
+    *n_quad   = q * q;
+    *n_quad1d = q;
+
+    *r1_local = (double *) malloc(*n_quad * sizeof(double));
+    *r2_local = (double *) malloc(*n_quad * sizeof(double));
+    *w_local  = (double *) malloc(*n_quad * sizeof(double));
+
+    *s_r = (double *) malloc(*n_quad1d * sizeof(double));
+    *oned_w_local = (double *) malloc(*n_quad1d * sizeof(double));
+
+    gauss_jacobi(q, 0., 0., a, wa);
+    gauss_jacobi(q, 1., 0., b, wb);
+
+    // dr ds = (1 - b) / 8 da db, and the (1 - b) is in wb
+    for (ib = 0; ib < q; ib++) {
+        for (ia = 0; ia < q; ia++) {
+            j = ib * q + ia;
+            (*r1_local)[j] = 0.5 * (1. + b[ib]);
+            (*r2_local)[j] = 0.25 * (1. + a[ia]) * (1. - b[ib]);
+            (*w_local) [j] = wa[ia] * wb[ib] / 8.;
+        }
+    }
+
+    for (j = 0; j < q; j++) {
+        (*s_r)[j] = a[j];
+        (*oned_w_local)[j] = wa[j];
+    }
+}
+
 /* set quadrature 
  *
  * sets the 1d quadrature integration points and weights for the boundary integrals
  * and the 2d quadrature integration points and weights for the volume intergrals.
+ * the 1d rule is n + 1 point gauss-legendre, computed for any order, and
+ * the 2d rule the symmetric one of degree 2n from quadrature.c.
  */
 void set_quadrature(int n,
                     double **r1_local, double **r2_local, double **w_local,
@@ -42,26 +103,9 @@ void set_quadrature(int n,
 
     *
     */
-    switch (n) {
-        case 0: *n_quad = 1;
-                *n_quad1d = 1;
-                break;
-        case 1: *n_quad = 3;
-                *n_quad1d = 2;
-                break;
-        case 2: *n_quad = 6;
-                *n_quad1d = 3;
-                break;
-        case 3: *n_quad = 12 ;
-                *n_quad1d = 4;
-                break;
-        case 4: *n_quad = 16;
-                *n_quad1d = 5;
-                break;
-        case 5: *n_quad = 25;
-                *n_quad1d = 6;
-                break;
-    }
+    *n_quad   = quad_2d_points[n];
+    *n_quad1d = n + 1;
+
     // allocate integration points
     *r1_local = (double *)  malloc(*n_quad * sizeof(double));
     *r2_local = (double *)  malloc(*n_quad * sizeof(double));
@@ -72,22 +116,13 @@ void set_quadrature(int n,
 
     // set 2D quadrature rules
     for (i = 0; i < *n_quad; i++) {
-        if (n > 0) {
-            (*r1_local)[i] = quad_2d[2 * n - 1][3*i];
-            (*r2_local)[i] = quad_2d[2 * n - 1][3*i+1];
-            (*w_local) [i] = quad_2d[2 * n - 1][3*i+2] / 2.; //weights are 2 times too big for some reason
-        } else {
-            (*r1_local)[i] = quad_2d[0][3*i];
-            (*r2_local)[i] = quad_2d[0][3*i+1];
-            (*w_local) [i] = quad_2d[0][3*i+2] / 2.; //weights are 2 times too big for some reason
-        }
+        (*r1_local)[i] = quad_2d[n][3*i];
+        (*r2_local)[i] = quad_2d[n][3*i+1];
+        (*w_local) [i] = quad_2d[n][3*i+2] / 2.; //weights are 2 times too big for some reason
     }
 
     // set 1D quadrature rules
-    for (i = 0; i < *n_quad1d; i++) {
-        (*s_r)[i] = quad_1d[n][2*i];
-        (*oned_w_local)[i] = quad_1d[n][2*i+1];
-    }
+    gauss_jacobi(*n_quad1d, 0., 0., *s_r, *oned_w_local);
 }
 
 void read_mesh(FILE *mesh_file, 
@@ -102,18 +137,20 @@ void read_mesh(FILE *mesh_file,
               int *elem_s1,  int *elem_s2, int *elem_s3,
               int *left_elem, int *right_elem) {
 
-    int i, j, items, s1, s2, s3, numsides, boundary_side, boundary;
+    int i, k, items, boundary_side, boundary;
     double J, tmpx, tmpy;
     char line[100];
-    numsides = 0;
-    // stores the number of sides this element has.
-    int *total_sides = (int *) malloc(num_elem * sizeof(int));
-    for (i = 0; i < num_elem; i++) {
-        total_sides[i] = 0;
-    }
+
+    // the vertex coordinates of every element, so we can find the shared ones
+    double *x = (double *) malloc(3 * num_elem * sizeof(double));
+    double *y = (double *) malloc(3 * num_elem * sizeof(double));
+
+    // vertex indices and boundary types for each side of each element
+    int *elem_v  = (int *) malloc(3 * num_elem * sizeof(int));
+    int *elem_bc = (int *) malloc(3 * num_elem * sizeof(int));
 
     i = 0;
-    while(fgets(line, sizeof(line), mesh_file) != NULL) {
+    while(i < num_elem && fgets(line, sizeof(line), mesh_file) != NULL) {
         // these three vertices define the element
         // and boundary_side tells which side is a boundary
         // while boundary determines the type of boundary
@@ -127,11 +164,6 @@ void read_mesh(FILE *mesh_file,
             exit(0);
         }
 
-        // determine whether we should add these three sides or not
-        s1 = 1;
-        s2 = 1;
-        s3 = 1;
-
         // enforce strictly positive jacobian
         J = (V2x[i] - V1x[i]) * (V3y[i] - V1y[i]) - (V3x[i] - V1x[i]) * (V2y[i] - V1y[i]);
         if (J < 0) {
@@ -150,171 +182,142 @@ void read_mesh(FILE *mesh_file,
             }
         }
 
-        // scan through the existing sides to see if we already added it
-        // TODO: yeah, there's a better way to do this.
-        // TODO: Also, this is super sloppy. should be checking indices instead of double values.
-        for (j = 0; j < numsides; j++) {
-            // side 1
-            if (s1 && ((sides_x1[j] == V1x[i] && sides_y1[j] == V1y[i]
-             && sides_x2[j] == V2x[i] && sides_y2[j] == V2y[i]) 
-            || (sides_x2[j] == V1x[i] && sides_y2[j] == V1y[i]
-             && sides_x1[j] == V2x[i] && sides_y1[j] == V2y[i]))) {
-                s1 = 0;
-                // OK, we've added this side to element i
-                right_elem[j] = i;
-                // link the added side j to this element
-                elem_s1[i] = j;
-                right_side_number[j] = 0;
-                break;
-            }
-        }
-        for (j = 0; j < numsides; j++) {
-            // side 2
-            if (s2 && ((sides_x1[j] == V2x[i] && sides_y1[j] == V2y[i]
-             && sides_x2[j] == V3x[i] && sides_y2[j] == V3y[i]) 
-            || (sides_x2[j] == V2x[i] && sides_y2[j] == V2y[i]
-             && sides_x1[j] == V3x[i] && sides_y1[j] == V3y[i]))) {
-                s2 = 0;
-                // OK, we've added this side to some element before; which one?
-                right_elem[j] = i;
-                elem_s2[i] = j;
-                // link the added side to this element
-                right_side_number[j] = 1;
-                break;
-            }
+        x[3 * i + 0] = V1x[i];
+        y[3 * i + 0] = V1y[i];
+        x[3 * i + 1] = V2x[i];
+        y[3 * i + 1] = V2y[i];
+        x[3 * i + 2] = V3x[i];
+        y[3 * i + 2] = V3y[i];
+
+        // see if one of the sides is a boundary
+        for (k = 0; k < 3; k++) {
+            elem_bc[3 * i + k] = 0;
         }
-        for (j = 0; j < numsides; j++) {
-            // side 3
-            if (s3 && ((sides_x1[j] == V1x[i] && sides_y1[j] == V1y[i]
-             && sides_x2[j] == V3x[i] && sides_y2[j] == V3y[i]) 
-            || (sides_x2[j] == V1x[i] && sides_y2[j] == V1y[i]
-             && sides_x1[j] == V3x[i] && sides_y1[j] == V3y[i]))) {
-                s3 = 0;
-                // OK, we've added this side to some element before; which one?
-                right_elem[j] = i;
-                elem_s3[i] = j;
-                // link the added side to this element
-                right_side_number[j] = 2;
-                break;
+        if (boundary_side >= 0 && boundary_side < 3) {
+            switch (boundary) {
+                case 10000: elem_bc[3 * i + boundary_side] = -1;
+                            break;
+                case 20000: elem_bc[3 * i + boundary_side] = -2;
+                            break;
+                case 30000: elem_bc[3 * i + boundary_side] = -3;
+                            break;
             }
         }
-        // if we haven't added the side already, add it
-        if (s1) {
-            sides_x1[numsides] = V1x[i];
-            sides_y1[numsides] = V1y[i];
-            sides_x2[numsides] = V2x[i];
-            sides_y2[numsides] = V2y[i];
-
-            // link the added side to this element
-            left_side_number[numsides] = 0;
+        i++;
+    }
 
-            // see if this is a boundary side
-            if (boundary_side == 0) {
-                switch (boundary) {
-                    case 10000: right_elem[numsides] = -1;
-                                break;
-                    case 20000: right_elem[numsides] = -2;
-                                break;
-                    case 30000: right_elem[numsides] = -3;
-                                break;
-                }
-            }
+    // give identical points the same vertex index and hash the sides on them
+    dedup_vertices(x, y, 3 * num_elem, elem_v);
+
+    *num_sides = build_sides(num_elem, elem_v, elem_bc,
+                             V1x, V1y, V2x, V2y, V3x, V3y,
+                             left_side_number, right_side_number,
+                             sides_x1, sides_y1,
+                             sides_x2, sides_y2,
+                             elem_s1, elem_s2, elem_s3,
+                             left_elem, right_elem);
+
+    free(x);
+    free(y);
+    free(elem_v);
+    free(elem_bc);
+}
 
-            // and link the element to this side
-            elem_s1[i] = numsides;
+/* init gpu
+ *
+ * allocates the solution and work arrays. the mesh arrays are set up
+ * separately by init_gpu_mesh or read_binary_mesh.
+ */
+void init_gpu(int num_elem, int num_sides, int n_p) {
+    int idx, i, base, num_padded;
+    int reduction_size = (num_elem  / 256) + ((num_elem  % 256) ? 1 : 0);
 
-            // make this the left element
-            left_elem[numsides] = i;
-            numsides++;
+    // pad the coefficient arrays out to a whole number of blocks
+    elem_block = (coeff_layout == LAYOUT_AOSOA) ? AOSOA_BLOCK : num_elem;
+    num_coeffs = 4 * n_p * elem_block * ((num_elem + elem_block - 1) / elem_block);
+    num_padded = num_coeffs / (4 * n_p);
+
+    d_c        = (double *) malloc(num_coeffs * sizeof(double));
+    d_c_prev   = (double *) malloc(num_coeffs * sizeof(double));
+    d_quad_rhs = (double *) malloc(num_coeffs * sizeof(double));
+
+    // only the stage storage the time integrator uses
+    d_kstar = d_k1 = d_du = NULL;
+    d_hist[0] = d_hist[1] = d_hist[2] = NULL;
+    if (time_integrator == INTEGRATOR_RK4) {
+        d_kstar = (double *) malloc(num_coeffs * sizeof(double));
+        d_k1    = (double *) malloc(num_coeffs * sizeof(double));
+    } else if (time_integrator == INTEGRATOR_RK2 || time_integrator == INTEGRATOR_SSPRK3) {
+        d_kstar = (double *) malloc(num_coeffs * sizeof(double));
+    } else if (time_integrator == INTEGRATOR_LSRK3 || time_integrator == INTEGRATOR_LSRK4) {
+        d_du    = (double *) malloc(num_coeffs * sizeof(double));
+    } else if (time_integrator == INTEGRATOR_LTS) {
+        // d_kstar is the solution the residual reads, or the ssprk3
+        // register while the history fills in
+        d_kstar = (double *) malloc(num_coeffs * sizeof(double));
+        for (i = 0; i < 3; i++) {
+            d_hist[i] = (double *) malloc(num_coeffs * sizeof(double));
         }
-        if (s2) {
-            sides_x1[numsides] = V2x[i];
-            sides_y1[numsides] = V2y[i];
-            sides_x2[numsides] = V3x[i];
-            sides_y2[numsides] = V3y[i];
-
-            // link the added side to this element
-            left_side_number[numsides] = 1;
-
-            // see if this is a boundary side
-            if (boundary_side == 1) {
-                switch (boundary) {
-                    case 10000: right_elem[numsides] = -1;
-                                break;
-                    case 20000: right_elem[numsides] = -2;
-                                break;
-                    case 30000: right_elem[numsides] = -3;
-                                break;
-                }
-            }
-
-            // and link the element to this side
-            elem_s2[i] = numsides;
+    }
 
-            // make this the left element
-            left_elem[numsides] = i;
-            numsides++;
-        }
-        if (s3) {
-            sides_x1[numsides] = V3x[i];
-            sides_y1[numsides] = V3y[i];
-            sides_x2[numsides] = V1x[i];
-            sides_y2[numsides] = V1y[i];
-
-            // link the added side to this element
-            left_side_number[numsides] = 2;
-
-            // see if this is a boundary side
-            if (boundary_side == 2) {
-                switch (boundary) {
-                    case 10000: right_elem[numsides] = -1;
-                                break;
-                    case 20000: right_elem[numsides] = -2;
-                                break;
-                    case 30000: right_elem[numsides] = -3;
-                                break;
-                }
-            }
+    d_lambda    = (double *) malloc(num_elem * sizeof(double));
+    d_reduction = (double *) malloc(reduction_size * sizeof(double));
 
-            // and link the element to this side
-            elem_s3[i] = numsides;
+    d_Uv1 = (double *) malloc(num_elem * sizeof(double));
+    d_Uv2 = (double *) malloc(num_elem * sizeof(double));
+    d_Uv3 = (double *) malloc(num_elem * sizeof(double));
 
-            // make this the left element
-            left_elem[numsides] = i;
-            numsides++;
+    // first touch: each page is zeroed by the thread that works on those
+    // elements in the kernels, which all use the same static
+    // schedule, so it's placed on that thread's numa node. the padding lanes
+    // are zeroed too so they stay finite through the rk updates.
+    #pragma omp parallel for schedule(static) private(i, base)
+    for (idx = 0; idx < num_padded; idx++) {
+        base = coeff_base(idx, n_p);
+        for (i = 0; i < 4 * n_p; i++) {
+            d_c       [base + i * elem_block] = 0.;
+            d_c_prev  [base + i * elem_block] = 0.;
+            d_quad_rhs[base + i * elem_block] = 0.;
+            if (d_kstar) {
+                d_kstar[base + i * elem_block] = 0.;
+            }
+            if (d_k1) {
+                d_k1   [base + i * elem_block] = 0.;
+            }
+            if (d_du) {
+                d_du   [base + i * elem_block] = 0.;
+            }
+            if (d_hist[0]) {
+                d_hist[0][base + i * elem_block] = 0.;
+                d_hist[1][base + i * elem_block] = 0.;
+                d_hist[2][base + i * elem_block] = 0.;
+            }
+        }
+        if (idx < num_elem) {
+            d_lambda[idx] = 0.;
+            d_Uv1[idx]    = 0.;
+            d_Uv2[idx]    = 0.;
+            d_Uv3[idx]    = 0.;
         }
-        i++;
     }
-    //free(total_sides);
-    *num_sides = numsides;
 }
 
-void init_gpu(int num_elem, int num_sides, int n_p,
-              double *V1x, double *V1y, 
-              double *V2x, double *V2y, 
-              double *V3x, double *V3y, 
-              int *left_side_number, int *right_side_number,
-              double *sides_x1, double *sides_y1,
-              double *sides_x2, double *sides_y2,
-              int *elem_s1, int *elem_s2, int *elem_s3,
-              int *left_elem, int *right_elem) {
-    int reduction_size = (num_elem  / 256) + ((num_elem  % 256) ? 1 : 0);
-
-    d_c = (double *) malloc(4 * num_elem * n_p * sizeof(double)); 
-    d_c_prev = (double *) malloc(4 * num_elem * n_p * sizeof(double)); 
-    d_quad_rhs = (double *) malloc(4 * num_elem * n_p * sizeof(double));
-    d_left_riemann_rhs = (double *) malloc(4 * num_sides * n_p * sizeof(double));
-    d_right_riemann_rhs = (double *) malloc(4 * num_sides * n_p * sizeof(double));
-
-    d_kstar = (double *) malloc(4 * num_elem * n_p * sizeof(double));
-    d_k1    = (double *) malloc(4 * num_elem * n_p * sizeof(double));
-    d_k2    = (double *) malloc(4 * num_elem * n_p * sizeof(double));
-    d_k3    = (double *) malloc(4 * num_elem * n_p * sizeof(double));
-    d_k4    = (double *) malloc(4 * num_elem * n_p * sizeof(double));
+/* init gpu mesh
+ *
+ * allocates the mesh arrays and copies over the mesh we just read.
+ */
+void init_gpu_mesh(int num_elem, int num_sides,
+                   double *V1x, double *V1y, 
+                   double *V2x, double *V2y, 
+                   double *V3x, double *V3y, 
+                   int *left_side_number, int *right_side_number,
+                   double *sides_x1, double *sides_y1,
+                   double *sides_x2, double *sides_y2,
+                   int *elem_s1, int *elem_s2, int *elem_s3,
+                   int *left_elem, int *right_elem) {
 
     d_J         = (double *) malloc(num_elem * sizeof(double));
-    d_lambda    = (double *) malloc(num_elem * sizeof(double));
-    d_reduction = (double *) malloc(reduction_size * sizeof(double));
+    d_radius    = (double *) malloc(num_elem * sizeof(double));
     d_s_length  = (double *) malloc(num_sides * sizeof(double));
 
     d_s_V1x = (double *) malloc(num_sides * sizeof(double));
@@ -326,10 +329,6 @@ void init_gpu(int num_elem, int num_sides, int n_p,
     d_elem_s2 = (int *) malloc(num_elem * sizeof(int));
     d_elem_s3 = (int *) malloc(num_elem * sizeof(int));
 
-    d_Uv1 = (double *) malloc(num_elem * sizeof(double));
-    d_Uv2 = (double *) malloc(num_elem * sizeof(double));
-    d_Uv3 = (double *) malloc(num_elem * sizeof(double));
-
     d_V1x = (double *) malloc(num_elem * sizeof(double));
     d_V1y = (double *) malloc(num_elem * sizeof(double));
     d_V2x = (double *) malloc(num_elem * sizeof(double));
@@ -375,22 +374,227 @@ void init_gpu(int num_elem, int num_sides, int n_p,
     memcpy(d_right_elem, right_elem, num_sides * sizeof(int));
 }
 
+/* preval mesh
+ *
+ * does all the geometric precomputations on the mesh arrays and returns the
+ * smallest inscribed circle in min_r.
+ */
+void preval_mesh(int num_elem, int num_sides, double *min_r) {
+    int i;
+
+    // find the min inscribed circle
+    preval_inscribed_circles(d_radius, d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y, num_elem);
+
+    // just grab all the radii and sort them since there are so few of them
+    *min_r = d_radius[0];
+    for (i = 1; i < num_elem; i++) {
+        *min_r = (d_radius[i] < *min_r) ? d_radius[i] : *min_r;
+    }
+
+    // pre computations
+    preval_jacobian(d_J, d_V1x, d_V1y, d_V2x, d_V2y, d_V3x, d_V3y, num_elem); 
+
+    preval_side_length(d_s_length, d_s_V1x, d_s_V1y, d_s_V2x, d_s_V2y, 
+                                                      num_sides); 
+
+    preval_normals(d_Nx, d_Ny, 
+                   d_s_V1x, d_s_V1y, d_s_V2x, d_s_V2y,
+                   d_V1x, d_V1y, 
+                   d_V2x, d_V2y, 
+                   d_V3x, d_V3y, 
+                   d_left_side_number, num_sides); 
+
+    preval_normals_direction(d_Nx, d_Ny, 
+                             d_V1x, d_V1y, 
+                             d_V2x, d_V2y, 
+                             d_V3x, d_V3y, 
+                             d_left_elem, d_left_side_number, num_sides); 
+
+    preval_partials(d_V1x, d_V1y,
+                    d_V2x, d_V2y,
+                    d_V3x, d_V3y,
+                    d_xr,  d_yr,
+                    d_xs,  d_ys, num_elem);
+}
+
+/* read mesh file
+ *
+ * loads the mesh into the d_ mesh arrays and does the precomputations.
+ * binary meshes are mapped directly; text meshes are read, connected and
+ * precomputed. returns 1 on failure.
+ */
+int read_mesh_file(char *mesh_filename, int *num_elem, int *num_sides, double *min_r) {
+    int i;
+    char line[100];
+    FILE *mesh_file;
+
+    double *V1x, *V1y, *V2x, *V2y, *V3x, *V3y;
+    double *sides_x1, *sides_x2;
+    double *sides_y1, *sides_y2;
+    int *left_elem, *right_elem;
+    int *elem_s1, *elem_s2, *elem_s3;
+    int *left_side_number, *right_side_number;
+
+    mesh_file = fopen(mesh_filename, "r");
+    if (!mesh_file) {
+        printf("\nERROR: mesh file not found.\n");
+        return 1;
+    }
+
+    // everything's already been done for binary meshes
+    if (is_binary_mesh(mesh_file)) {
+        fclose(mesh_file);
+        if (read_binary_mesh(mesh_filename, num_elem, num_sides, min_r)) {
+            return 1;
+        }
+        if (find_side_ranges(*num_sides, d_elem_s1, d_elem_s2, d_elem_s3,
+                             d_left_elem, d_right_elem)) {
+            printf("\nERROR: the sides in %s aren't grouped by boundary type and color.\n", mesh_filename);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (is_gmsh_mesh(mesh_file)) {
+        // gmsh meshes can be read directly
+        read_gmsh(mesh_file, num_elem, num_sides,
+                  &V1x, &V1y, &V2x, &V2y, &V3x, &V3y,
+                  &left_side_number, &right_side_number,
+                  &sides_x1, &sides_y1,
+                  &sides_x2, &sides_y2,
+                  &elem_s1, &elem_s2, &elem_s3,
+                  &left_elem, &right_elem);
+    } else {
+        // get num_elem for allocations
+        fgets(line, 100, mesh_file);
+        sscanf(line, "%i", num_elem);
+
+        // allocate vertex points
+        V1x = (double *) malloc(*num_elem * sizeof(double));
+        V1y = (double *) malloc(*num_elem * sizeof(double));
+        V2x = (double *) malloc(*num_elem * sizeof(double));
+        V2y = (double *) malloc(*num_elem * sizeof(double));
+        V3x = (double *) malloc(*num_elem * sizeof(double));
+        V3y = (double *) malloc(*num_elem * sizeof(double));
+
+        elem_s1 = (int *) malloc(*num_elem * sizeof(int));
+        elem_s2 = (int *) malloc(*num_elem * sizeof(int));
+        elem_s3 = (int *) malloc(*num_elem * sizeof(int));
+
+        // TODO: these are too big; should be a way to figure out how many we actually need
+        left_side_number  = (int *)   malloc(3 * *num_elem * sizeof(int));
+        right_side_number = (int *)   malloc(3 * *num_elem * sizeof(int));
+
+        sides_x1    = (double *) malloc(3 * *num_elem * sizeof(double));
+        sides_x2    = (double *) malloc(3 * *num_elem * sizeof(double));
+        sides_y1    = (double *) malloc(3 * *num_elem * sizeof(double));
+        sides_y2    = (double *) malloc(3 * *num_elem * sizeof(double)); 
+        left_elem   = (int *) malloc(3 * *num_elem * sizeof(int));
+        right_elem  = (int *) malloc(3 * *num_elem * sizeof(int));
+
+        for (i = 0; i < 3 * *num_elem; i++) {
+            right_elem[i] = -1;
+        }
+
+        // read in the mesh and make all the mappings
+        read_mesh(mesh_file, num_sides, *num_elem,
+                             V1x, V1y, V2x, V2y, V3x, V3y,
+                             left_side_number, right_side_number,
+                             sides_x1, sides_y1, 
+                             sides_x2, sides_y2, 
+                             elem_s1, elem_s2, elem_s3,
+                             left_elem, right_elem);
+    }
+
+    fclose(mesh_file);
+
+    // put neighbors close together in memory
+    if (mesh_ordering != ORDER_NONE) {
+        renumber_mesh(mesh_ordering, *num_elem, *num_sides,
+                      V1x, V1y, V2x, V2y, V3x, V3y,
+                      left_side_number, right_side_number,
+                      sides_x1, sides_y1,
+                      sides_x2, sides_y2,
+                      elem_s1, elem_s2, elem_s3,
+                      left_elem, right_elem);
+    }
+
+    // group the boundary sides at the end and sort each group by color
+    sort_sides(*num_elem, *num_sides,
+               left_side_number, right_side_number,
+               sides_x1, sides_y1,
+               sides_x2, sides_y2,
+               elem_s1, elem_s2, elem_s3,
+               left_elem, right_elem);
+    if (find_side_ranges(*num_sides, elem_s1, elem_s2, elem_s3, left_elem, right_elem)) {
+        printf("\nERROR: the sides in %s couldn't be grouped by boundary type and color.\n", mesh_filename);
+        return 1;
+    }
+
+    init_gpu_mesh(*num_elem, *num_sides,
+                  V1x, V1y, V2x, V2y, V3x, V3y,
+                  left_side_number, right_side_number,
+                  sides_x1, sides_y1,
+                  sides_x2, sides_y2, 
+                  elem_s1, elem_s2, elem_s3,
+                  left_elem, right_elem);
+
+    free(V1x);
+    free(V1y);
+    free(V2x);
+    free(V2y);
+    free(V3x);
+    free(V3y);
+
+    free(elem_s1);
+    free(elem_s2);
+    free(elem_s3);
+
+    free(sides_x1);
+    free(sides_x2);
+    free(sides_y1);
+    free(sides_y2);
+
+    free(left_elem);
+    free(right_elem);
+    free(left_side_number);
+    free(right_side_number);
+
+    preval_mesh(*num_elem, *num_sides, min_r);
+
+    return 0;
+}
+
 void free_gpu() {
     free(d_c);
     free(d_c_prev);
     free(d_quad_rhs);
-    free(d_left_riemann_rhs);
-    free(d_right_riemann_rhs);
 
     free(d_kstar);
     free(d_k1);
-    free(d_k2);
-    free(d_k3);
-    free(d_k4);
+    free(d_du);
+    free(d_hist[0]);
+    free(d_hist[1]);
+    free(d_hist[2]);
 
-    free(d_J);
     free(d_lambda);
     free(d_reduction);
+
+    free(d_Uv1);
+    free(d_Uv2);
+    free(d_Uv3);
+}
+
+void free_gpu_mesh() {
+    // the arrays all live in the mapping for binary meshes
+    if (mesh_map) {
+        munmap(mesh_map, mesh_map_size);
+        mesh_map = NULL;
+        return;
+    }
+
+    free(d_J);
+    free(d_radius);
     free(d_s_length);
 
     free(d_s_V1x);
@@ -402,10 +606,6 @@ void free_gpu() {
     free(d_elem_s2);
     free(d_elem_s3);
 
-    free(d_Uv1);
-    free(d_Uv2);
-    free(d_Uv3);
-
     free(d_V1x);
     free(d_V1y);
     free(d_V2x);
@@ -430,9 +630,21 @@ void free_gpu() {
 
 void usage_error() {
     printf("\nUsage: cpueuler [OPTIONS] [MESH] [OUTFILE]\n");
-    printf(" Options: [-n] Order of polynomial approximation.\n");
+    printf(" Options: [-n] Order of polynomial approximation (0 to %i).\n", MAX_ORDER);
     printf("          [-T] End time.\n");
     printf("          [-d] Debug.\n");
+    printf("          [-r] Element ordering: none, rcm, hilbert or morton.\n");
+    printf("          [-l] Coefficient layout: soa or aosoa.\n");
+    printf("          [-p] Number of threads.\n");
+    printf("          [-P] Threads: forkjoin for every kernel, or team, one pinned team\n");
+    printf("               for the whole run (rk4 only).\n");
+    printf("          [-I] Time integrator: rk4, lsrk3, lsrk4, rk2, ssprk3, fe or lts.\n");
+    printf("          [-L] Most dt classes for lts (1 to %i).\n", MAX_CLASSES);
+    printf("          [-V] Vector instructions: scalar, avx2 or avx512. Defaults to the\n");
+    printf("               widest the cpu has.\n");
+    printf("          [-K] Kernels: loop, gemm (needs avx2 or avx512) or tensor.\n");
+    printf(" MESH may be a text mesh, a gmsh 2.2 mesh (ascii or binary) or a binary\n");
+    printf("      mesh made by meshconvert, which keeps the ordering it was made with.\n");
 }
 
 int get_input(int argc, char *argv[],
@@ -453,7 +665,7 @@ int get_input(int argc, char *argv[],
         if (strcmp(argv[i], "-n") == 0) {
             if (i + 1 < argc) {
                 *n = atoi(argv[i+1]);
-                if (*n < 0 || *n > 5) {
+                if (*n < 0 || *n > MAX_ORDER) {
                     usage_error();
                     return 1;
                 }
@@ -487,6 +699,113 @@ int get_input(int argc, char *argv[],
                 return 1;
             }
         }
+        // element ordering
+        if (strcmp(argv[i], "-r") == 0) {
+            if (i + 1 < argc) {
+                mesh_ordering = parse_ordering(argv[i+1]);
+                if (mesh_ordering < 0) {
+                    usage_error();
+                    return 1;
+                }
+            } else {
+                usage_error();
+                return 1;
+            }
+        }
+        // coefficient layout
+        if (strcmp(argv[i], "-l") == 0) {
+            if (i + 1 < argc) {
+                if (strcmp(argv[i+1], "soa") == 0) {
+                    coeff_layout = LAYOUT_SOA;
+                } else if (strcmp(argv[i+1], "aosoa") == 0) {
+                    coeff_layout = LAYOUT_AOSOA;
+                } else {
+                    usage_error();
+                    return 1;
+                }
+            } else {
+                usage_error();
+                return 1;
+            }
+        }
+        // time integrator
+        if (strcmp(argv[i], "-I") == 0) {
+            if (i + 1 < argc) {
+                time_integrator = parse_integrator(argv[i+1]);
+                if (time_integrator < 0) {
+                    usage_error();
+                    return 1;
+                }
+            } else {
+                usage_error();
+                return 1;
+            }
+        }
+        // dt classes for local time stepping
+        if (strcmp(argv[i], "-L") == 0) {
+            if (i + 1 < argc) {
+                max_classes = atoi(argv[i+1]);
+                if (max_classes < 1 || max_classes > MAX_CLASSES) {
+                    usage_error();
+                    return 1;
+                }
+            } else {
+                usage_error();
+                return 1;
+            }
+        }
+        // vector instruction set
+        if (strcmp(argv[i], "-V") == 0) {
+            if (i + 1 < argc) {
+                vector_isa = parse_isa(argv[i+1]);
+                if (vector_isa < 0) {
+                    usage_error();
+                    return 1;
+                }
+            } else {
+                usage_error();
+                return 1;
+            }
+        }
+        // kernel formulation
+        if (strcmp(argv[i], "-K") == 0) {
+            if (i + 1 < argc) {
+                kernel_form = parse_form(argv[i+1]);
+                if (kernel_form < 0) {
+                    usage_error();
+                    return 1;
+                }
+            } else {
+                usage_error();
+                return 1;
+            }
+        }
+        // thread backend
+        if (strcmp(argv[i], "-P") == 0) {
+            if (i + 1 < argc) {
+                thread_backend = parse_thread_backend(argv[i+1]);
+                if (thread_backend < 0) {
+                    usage_error();
+                    return 1;
+                }
+            } else {
+                usage_error();
+                return 1;
+            }
+        }
+        // number of threads
+        if (strcmp(argv[i], "-p") == 0) {
+            if (i + 1 < argc && atoi(argv[i+1]) > 0) {
+#ifdef _OPENMP
+                omp_set_num_threads(atoi(argv[i+1]));
+#else
+                printf("warning: built without openmp, -p is ignored.\n");
+#endif
+            } else {
+                usage_error();
+                return 1;
+            }
+        }
     } 
 
     // second last argument is filename
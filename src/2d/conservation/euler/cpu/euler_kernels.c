@@ -22,20 +22,29 @@
 /* These are always prefixed with d_ for "device" */
 double *d_c;                 // coefficients for [rho, rho * u, rho * v, E]
 double *d_c_prev;            // coefficients for [rho, rho * u, rho * v, E]
-double *d_quad_rhs;          // the right hand side containing the quadrature contributions
-double *d_left_riemann_rhs;  // the right hand side containing the left riemann contributions
-double *d_right_riemann_rhs; // the right hand side containing the right riemann contributions
+double *d_quad_rhs;          // the right hand side containing the quadrature and riemann contributions
 
-// TODO: switch to low storage runge-kutta
-// runge kutta variables
+// runge kutta variables, only allocated for classical rk4. d_k1 holds the
+// running combination of the stages (see rk4_stage).
 double *d_kstar;
 double *d_k1;
-double *d_k2;
-double *d_k3;
-double *d_k4;
 
-// precomputed basis functions 
-// TODO: maybe making these 2^n makes sure the offsets are cached more efficiently? who knows...
+// the register for the low storage runge kutta schemes
+double *d_du;
+
+// the multirate adams-bashforth history: the last three L(u) = rhs / J of
+// every element, each element's dt class rotating through them on its own
+// (see time_integrate_lts)
+double *d_hist[3];
+
+// the highest order there's a basis and quadrature rule for. both are
+// generated at startup (see preval_basis and set_quadrature), so this only
+// bounds what's been tested.
+#define MAX_ORDER 10
+
+// the alignment of the tables below, a cache line
+#define TABLE_ALIGN 64
+
 // precomputed basis functions ordered like so
 //
 // [phi_1(r1, s1), phi_1(r2, s2), ... , phi_1(r_nq, s_nq)   ]
@@ -45,25 +54,48 @@ double *d_k4;
 // [   .               .           .            .           ]
 // [phi_np(r1, s1), phi_np(r2, s2), ... , phi_np(r_nq, s_nq)]
 //
-double basis[2048];
+// preval_basis sizes them for the order and rule and aligns them to
+// TABLE_ALIGN.
+double *basis;
 // note: these are multiplied by the weights
-double basis_grad_x[2048]; 
-double basis_grad_y[2048]; 
+double *basis_grad_x; 
+double *basis_grad_y; 
 
 // precomputed basis functions evaluated along the sides. ordered
 // similarly to basis and basis_grad_{x,y} but with one "matrix" for each side
 // starting with side 0. to get to each side, offset with:
 //      side_number * n_p * num_quad1d.
-double basis_side[1024];
-double basis_vertex[256];
+double *basis_side;
+double *basis_vertex;
 
 // weights for 2d and 1d quadrature rules
-double w[32];
-double w_oned[16];
-
-double r1[32];
-double r2[32];
-double r_oned[32];
+double *w;
+double *w_oned;
+
+double *r1;
+double *r2;
+double *r_oned;
+
+// the tables above for one order and 2d rule, and the ones in
+// euler_kernels_tensor.c for one order, as static const data.
+// gen_basis_tables writes them for every order up to MAX_ORDER to
+// basis_tables.h at build time, and preval_basis and preval_tensor_basis
+// copy them from there instead of evaluating the basis.
+typedef struct {
+    int n_quad, n_quad1d;
+    const double *basis, *basis_grad_x, *basis_grad_y, *basis_side, *basis_vertex;
+    const double *w, *w_oned, *r1, *r2, *r_oned;
+} basis_table;
+
+typedef struct {
+    const int *tensor_p;
+    const double *tensor_a, *tensor_b, *tensor_grad_a[3], *tensor_grad_b[2];
+    const double *tensor_side_a, *tensor_side_b;
+} tensor_table;
+
+#ifndef BASIS_TABLES_GEN
+#include "basis_tables.h"
+#endif
 
 // tells which side (1, 2, or 3) to evaluate this boundary integral over
 int *d_left_side_number;
@@ -72,6 +104,7 @@ int *d_right_side_number;
 double *d_J;         // jacobian determinant 
 double *d_reduction; // for the min / maxes in the reductions 
 double *d_lambda;    // stores computed lambda values for each element
+double *d_radius;    // inscribed circle of each element, for the cfl condition
 double *d_s_length;  // length of sides
 
 // the num_elem values of the x and y coordinates for the two vertices defining a side
@@ -116,11 +149,289 @@ double *d_Ny;
 int *d_left_elem;  // index of left  element for side idx
 int *d_right_elem; // index of right element for side idx
 
+// the sides are sorted [interior | reflecting | outflow | inflow]. side_ranges[k]
+// is the first side of each group and side_ranges[4] is num_sides.
+int side_ranges[5];
+
+// within each group the sides are sorted by color, and no two sides of one
+// color in a group share an element, so a color can add its riemann
+// contributions straight into d_quad_rhs in parallel. color_ranges[k][j] is
+// the first side of color j in group k and color_ranges[k][num_colors[k]] is
+// side_ranges[k + 1].
+#define MAX_COLORS 8
+int num_colors[4];
+int color_ranges[4][MAX_COLORS + 1];
+
+// local time stepping runs the kernels on part of the mesh (see
+// time_integrate_lts). while d_elem_list is set, eval_volume visits the
+// elements d_elem_list[0] through d_elem_list[num_elem - 1] instead of 0
+// through num_elem - 1. while d_side_list is set, color j of group k is the
+// sides d_side_list[pos] for pos from color_ranges[k][j] up to
+// color_ends[k][j].
+int *d_elem_list;
+int *d_side_list;
+int color_ends[4][MAX_COLORS];
+
+// the coefficient arrays (d_c, d_kstar, d_k1, d_du and d_quad_rhs) are split
+// into blocks of elem_block elements, each ordered [eq][mode][lane]. the
+// coefficient for basis function i of equation eq on element idx is at
+//      coeff_base(idx, n_p) + (eq * n_p + i) * elem_block
+// LAYOUT_SOA is one block of num_elem elements, i.e. [eq][mode][element].
+// LAYOUT_AOSOA uses blocks of AOSOA_BLOCK elements, so one lane of every mode
+// of a block shares a cache line and an element's coefficients are all
+// within 4 * n_p cache lines of each other instead of num_elem doubles apart.
+#define LAYOUT_SOA   0
+#define LAYOUT_AOSOA 1
+#define AOSOA_BLOCK  8
+
+int coeff_layout = LAYOUT_SOA;
+char *layout_names[] = {"soa", "aosoa"};
+
+int elem_block; // elements per block
+int num_coeffs; // length of each coefficient array, padding included
+
+/***********************
+ *
+ * THREAD TEAM
+ *
+ ***********************/
+/* normally every kernel forks its own parallel region and joins it at the
+ * end. time_integrate_rk4 can instead run the whole time loop in one parallel
+ * region of pinned threads (see -P), which is cheaper on small meshes, where
+ * forking and joining costs about as much as the work. while that team runs,
+ * team_threads is its size and each kernel runs on the calling thread only,
+ * over its share of the loop from thread_range, then waits for the others in
+ * team_barrier, so the phases are separated just as they are by the joins.
+ * so each kernel is a function named with _share that does a given range of
+ * its loop on the calling thread, and one that runs it through TEAM_RUN.
+ */
+int team_threads = 0;
+
+// the sense-reversing barrier: the threads count themselves in on
+// team_arrived and the last one flips team_sense, which the rest wait on.
+// team_local_sense is the value each thread waits for next.
+int team_arrived = 0;
+int team_sense   = 0;
+int team_local_sense = 0;
+#pragma omp threadprivate(team_local_sense)
+
+// each thread's part of a reduction, a cache line apart
+typedef struct {
+    double min;
+    double max;
+    char pad[TABLE_ALIGN - 2 * sizeof(double)];
+} team_slot;
+
+team_slot *team_slots;
+
+/* thread rank
+ *
+ * the calling thread's number in its parallel region, 0 outside one.
+ */
+int thread_rank() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+/* thread range
+ *
+ * the calling thread's share, first up to last, of a loop from start to end
+ * in steps of step: the same run of whole steps for the same range and
+ * number of threads every time, like schedule(static). outside a parallel
+ * region that's the whole loop.
+ */
+void thread_range(int start, int end, int step, int *first, int *last) {
+    int threads = 1;
+    long steps;
+
+#ifdef _OPENMP
+    threads = omp_get_num_threads();
+#endif
+
+    steps  = (end > start) ? (end - start + step - 1) / step : 0;
+    *first = start + (int) (steps * thread_rank() / threads) * step;
+    *last  = start + (int) (steps * (thread_rank() + 1) / threads) * step;
+    *last  = (*last < end) ? *last : end;
+    *first = (*first < *last) ? *first : *last;
+}
+
+/* team barrier
+ *
+ * waits until the whole team has got here. it can be used again straight
+ * away, since the next time round the threads wait for the other sense. the
+ * waiting spins, but gives up the cpu now and then in case there are more
+ * threads than cores.
+ */
+void team_barrier() {
+    int spins;
+
+    team_local_sense = !team_local_sense;
+    if (__atomic_add_fetch(&team_arrived, 1, __ATOMIC_ACQ_REL) == team_threads) {
+        __atomic_store_n(&team_arrived, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&team_sense, team_local_sense, __ATOMIC_RELEASE);
+        return;
+    }
+
+    for (spins = 1; __atomic_load_n(&team_sense, __ATOMIC_ACQUIRE) != team_local_sense; spins++) {
+        if (spins % 256 == 0) {
+            sched_yield();
+        } else {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+    }
+}
+
+/* team reduce
+ *
+ * the smallest min and the largest max any thread in the team passed,
+ * which every thread gets back. the slots can be used again after the next
+ * team_barrier, which the next kernel ends with.
+ */
+void team_reduce(double *min, double *max) {
+    int i;
+
+    team_slots[thread_rank()].min = *min;
+    team_slots[thread_rank()].max = *max;
+    team_barrier();
+
+    for (i = 0; i < team_threads; i++) {
+        *min = (team_slots[i].min < *min) ? team_slots[i].min : *min;
+        *max = (team_slots[i].max > *max) ? team_slots[i].max : *max;
+    }
+}
+
+/* team start, team end
+ *
+ * every thread of a parallel region calls team_start to make it the team,
+ * and team_end when it's done. team_start pins each thread to a cpu of its
+ * own among the ones the process may run on (more threads than cpus share
+ * them round robin), and team_end lets it run anywhere it could before,
+ * which it's given back in allowed.
+ */
+void team_start(cpu_set_t *allowed) {
+    cpu_set_t pinned;
+    int cpu, nth;
+
+    sched_getaffinity(0, sizeof(cpu_set_t), allowed);
+    nth = thread_rank() % CPU_COUNT(allowed);
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, allowed) && nth-- == 0) {
+            CPU_ZERO(&pinned);
+            CPU_SET(cpu, &pinned);
+            sched_setaffinity(0, sizeof(cpu_set_t), &pinned);
+            break;
+        }
+    }
+
+    team_local_sense = 0;
+
+    #pragma omp barrier
+    #pragma omp master
+    {
+#ifdef _OPENMP
+        team_threads = omp_get_num_threads();
+#else
+        team_threads = 1;
+#endif
+        team_arrived = 0;
+        team_sense   = 0;
+        team_slots   = (team_slot *) aligned_alloc(TABLE_ALIGN, team_threads * sizeof(team_slot));
+    }
+    #pragma omp barrier
+}
+
+void team_end(cpu_set_t *allowed) {
+    #pragma omp barrier
+    #pragma omp master
+    {
+        team_threads = 0;
+        free(team_slots);
+        team_slots = NULL;
+    }
+    #pragma omp barrier
+
+    sched_setaffinity(0, sizeof(cpu_set_t), allowed);
+}
+
+/* team run
+ *
+ * runs share, a call that does the sides or elements first up to last of a
+ * kernel, for each thread's share of the loop from start to end in steps of
+ * step: on this thread, then waits for the rest of the team if it's running,
+ * and otherwise on every thread of a new parallel region.
+ */
+#define TEAM_RUN(start, end, step, share) { \
+    int first, last; \
+    if (team_threads) { \
+        thread_range(start, end, step, &first, &last); \
+        share; \
+        team_barrier(); \
+    } else { \
+        _Pragma("omp parallel private(first, last)") \
+        { \
+            thread_range(start, end, step, &first, &last); \
+            share; \
+        } \
+    } \
+}
+
 /***********************
  *
  * DEVICE FUNCTIONS
  *
  ***********************/
+
+/* coefficient base
+ *
+ * offset of element idx's first coefficient in the coefficient arrays.
+ * the rest are elem_block apart; see coeff_layout.
+ */
+int coeff_base(int idx, int n_p) {
+    return (idx / elem_block) * 4 * n_p * elem_block + idx % elem_block;
+}
+
+/* element at, side at
+ *
+ * the element or side a kernel works on at position pos of its loop: pos
+ * itself, unless local time stepping has set d_elem_list or d_side_list.
+ */
+int elem_at(int pos) {
+    return d_elem_list ? d_elem_list[pos] : pos;
+}
+
+int side_at(int pos) {
+    return d_side_list ? d_side_list[pos] : pos;
+}
+
+/* color end
+ *
+ * one past the last position of color j in group k; see d_side_list.
+ */
+int color_end(int k, int j) {
+    return d_side_list ? color_ends[k][j] : color_ranges[k][j + 1];
+}
+
+/* unpack coefficients
+ *
+ * copies c, in the current layout, out ordered [eq][mode][element], so
+ * solutions from different layouts can be compared.
+ */
+void unpack_coefficients(double *c, double *plain, int n_p, int num_elem) {
+    int idx, i, base;
+
+    for (idx = 0; idx < num_elem; idx++) {
+        base = coeff_base(idx, n_p);
+        for (i = 0; i < 4 * n_p; i++) {
+            plain[i * num_elem + idx] = c[base + i * elem_block];
+        }
+    }
+}
+
 double pressure(double rho, double u, double v, double E, int side_type, int idx) {
 
     // TODO: this is a dirty fix, but it's necessary or else c collapses into NAN
@@ -325,7 +636,9 @@ void init_conditions(double *c, double *J,
     int idx, i, j;
     double x, y, rho, u, v, E;
 
+    #pragma omp parallel for private(i, j, x, y, rho, u, v, E)
     for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
         for (i = 0; i < n_p; i++) {
             rho = 0.;
             u   = 0.;
@@ -345,10 +658,10 @@ void init_conditions(double *c, double *J,
                 E   += w[j] * E0(x, y) * basis[i * n_quad + j];
             }
 
-            c[num_elem * n_p * 0 + i * num_elem + idx] = rho;
-            c[num_elem * n_p * 1 + i * num_elem + idx] = u; // we actually calculate rho * u
-            c[num_elem * n_p * 2 + i * num_elem + idx] = v; // we actually calculate rho * v
-            c[num_elem * n_p * 3 + i * num_elem + idx] = E;
+            c[base + (0 * n_p + i) * elem_block] = rho;
+            c[base + (1 * n_p + i) * elem_block] = u; // we actually calculate rho * u
+            c[base + (2 * n_p + i) * elem_block] = v; // we actually calculate rho * v
+            c[base + (3 * n_p + i) * elem_block] = E;
        } 
     }
 }
@@ -378,8 +691,8 @@ void preval_side_length(double *s_length,
 
 /* inscribed circle radius computing
  *
- * computes the radius of each inscribed circle. stores in d_J to find the minumum,
- * then we reuse d_J.
+ * computes the radius of each inscribed circle into d_radius, which the cfl
+ * condition compares against each element's own wave speed.
  */
 void preval_inscribed_circles(double *J,
                               double *V1x, double *V1y,
@@ -571,6 +884,42 @@ void limit_c(double *c_inner,
     //}
 }
 
+// instrumentation: the separate passes over the cell averages of every
+// element to find the wave speeds, and the ones folded into the last stage
+// update of a step instead (see stage_cfl)
+long wave_speed_passes = 0;
+long wave_speed_fused  = 0;
+
+/* wave speed
+ *
+ * the max value of |u + c|, |u|, |u - c| for the cell averages of element
+ * idx, whose coefficients start at base.
+ */
+double wave_speed(double *c, int base, int n_p, int idx) {
+    double rho, u, v, E, c_speed, sum;
+
+    // get cell averages
+    rho = c[base + 0 * n_p * elem_block] * basis[0];
+    u   = c[base + 1 * n_p * elem_block] * basis[0];
+    v   = c[base + 2 * n_p * elem_block] * basis[0];
+    E   = c[base + 3 * n_p * elem_block] * basis[0];
+
+    u = u / rho;
+    v = v / rho;
+
+    // evaluate c
+    c_speed = eval_c(rho, u, v, E, 20000, idx);
+
+    // norm
+    sum = sqrtf(u*u + v*v);
+
+    if (sum > 0) {
+        return sum + c_speed;
+    } else {
+        return -sum + c_speed;
+    }
+}
+
 /* global lambda evaluation
  *
  * computes the max value of |u + c|, |u|, |u - c|.
@@ -578,54 +927,55 @@ void limit_c(double *c_inner,
 void eval_global_lambda(double *c, 
                         double *lambda,
                         int n_quad, int n_p, int num_elem) {
-    double rho, u, v, E, c_speed;
-    double sum;
-
     int idx;
 
+    wave_speed_passes++;
+
+    #pragma omp parallel for
     for (idx = 0; idx < num_elem; idx++) {
-        // get cell averages
-        rho = c[num_elem * n_p * 0 + idx] * basis[0];
-        u   = c[num_elem * n_p * 1 + idx] * basis[0];
-        v   = c[num_elem * n_p * 2 + idx] * basis[0];
-        E   = c[num_elem * n_p * 3 + idx] * basis[0];
+        lambda[idx] = wave_speed(c, coeff_base(idx, n_p), n_p, idx);
+    }
+}
 
-        u = u / rho;
-        v = v / rho;
+/* global cfl evaluation
+ *
+ * the min over the elements of radius / lambda, which the time integrators
+ * scale by their cfl number and 1 / (2n + 1) to get dt. each element is held
+ * to its own wave speed, rather than the smallest radius to the largest wave
+ * speed anywhere, and the wave speeds are reduced as they're computed instead
+ * of being stored and scanned. the largest of them is returned in max_l.
+ * THREADS: num_elem
+ */
+double eval_global_cfl(double *c, double *radius, double *max_l,
+                       int n_p, int num_elem) {
+    double min_dt     = HUGE_VAL;
+    double max_lambda = 0.;
+    int idx;
 
-        // evaluate c
-        c_speed = eval_c(rho, u, v, E, 20000, idx);
+    wave_speed_passes++;
 
-        // norm
-        sum = sqrtf(u*u + v*v);
+    #pragma omp parallel for reduction(min:min_dt) reduction(max:max_lambda)
+    for (idx = 0; idx < num_elem; idx++) {
+        double lambda = wave_speed(c, coeff_base(idx, n_p), n_p, idx);
 
-        if (sum > 0) {
-            lambda[idx] = sum + c_speed;
-        } else {
-            lambda[idx] = -sum + c_speed;
-        }
+        min_dt     = (radius[idx] / lambda < min_dt) ? radius[idx] / lambda : min_dt;
+        max_lambda = (lambda > max_lambda) ? lambda : max_lambda;
     }
+
+    *max_l = max_lambda;
+    return min_dt;
 }
 
-/* riemann evaluation
+/* left trace evaluation
  *
- * device function to solve the riemann problem.
+ * evaluates rho, u, v, E for the left element at integration point j.
+ * u and v come back as the actual velocities, not rho * u, rho * v.
  */
-void eval_left_right(double *c_rho_left, double *c_rho_right,
-                     double *c_u_left,   double *c_u_right,
-                     double *c_v_left,   double *c_v_right,
-                     double *c_E_left,   double *c_E_right,
-                     double *rho_left, double *u_left, double *v_left, double *E_left,
-                     double *rho_right, double *u_right, double *v_right, double *E_right,
-                     double nx, double ny,
-                     double v1x, double v1y,
-                     double v2x, double v2y,
-                     double v3x, double v3y,
-                     int j, // j, as usual, is the index of the integration point
-                     int left_side, int right_side,
-                     int left_idx, int right_idx,
-                     int n_p, int n_quad1d,
-                     int num_sides, double t) { 
+void eval_left(double *c_rho_left, double *c_u_left, 
+               double *c_v_left,   double *c_E_left,
+               double *rho_left, double *u_left, double *v_left, double *E_left,
+               int j, // j, as usual, is the index of the integration point
+               int left_side, int n_p, int n_quad1d) {
 
     int i;
 
@@ -634,10 +984,6 @@ void eval_left_right(double *c_rho_left, double *c_rho_right,
     *u_left    = 0.;
     *v_left    = 0.;
     *E_left    = 0.;
-    *rho_right = 0.;
-    *u_right   = 0.;
-    *v_right   = 0.;
-    *E_right   = 0.;
     
     for (i = 0; i < n_p; i++) {
         *rho_left += c_rho_left[i] * basis_side[left_side * n_p * n_quad1d + i * n_quad1d + j];
@@ -664,8 +1010,63 @@ void eval_left_right(double *c_rho_left, double *c_rho_right,
     // since we actually have coefficients for rho * u and rho * v
     *u_left = *u_left / *rho_left;
     *v_left = *v_left / *rho_left;
+}
+
+/* right trace evaluation
+ *
+ * evaluates rho, u, v, E for the right element of an interior side. the right
+ * element runs along the side the other way, so point j is n_quad1d - 1 - j.
+ */
+void eval_right(double *c_rho_right, double *c_u_right, 
+                double *c_v_right,   double *c_E_right,
+                double *rho_right, double *u_right, double *v_right, double *E_right,
+                int j, int right_side, int n_p, int n_quad1d) {
+
+    int i;
+
+    *rho_right = 0.;
+    *u_right   = 0.;
+    *v_right   = 0.;
+    *E_right   = 0.;
+
+    // evaluate the right side at the integration point
+    for (i = 0; i < n_p; i++) {
+        *rho_right += c_rho_right[i] * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
+        *u_right   += c_u_right[i]   * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
+        *v_right   += c_v_right[i]   * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
+        *E_right   += c_E_right[i]   * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
+    }
+
+    // in case rho_right comes back nonphysical
+    //if (*rho_right <= 0) {
+        //*rho_right = c_rho_right[0];
+    //}
+
+    // in case E_right comes back nonphysical
+    //if (*E_right <= 0) {
+        //*E_right = c_E_right[0];
+    //}
+
+    // again, since we have coefficients for rho * u and rho * v
+    *u_right = *u_right / *rho_right;
+    *v_right = *v_right / *rho_right;
+}
+
+/* boundary evaluation
+ *
+ * sets the right state of a boundary side of type right_idx (-1, -2, -3).
+ */
+void eval_boundary(double rho_left, double *rho_right,
+                   double u_left,   double *u_right,
+                   double v_left,   double *v_right,
+                   double E_left,   double *E_right,
+                   double nx, double ny,
+                   double v1x, double v1y,
+                   double v2x, double v2y,
+                   double v3x, double v3y,
+                   int j, int left_side, int right_idx,
+                   int n_quad1d, double t) { 
 
-    // TODO: make all threads in the first warps be boundary sides
     ///////////////////////
     // reflecting 
     ///////////////////////
@@ -674,10 +1075,10 @@ void eval_left_right(double *c_rho_left, double *c_rho_right,
                         v1x, v1y, v2x, v2y, v3x, v3y, 
                         j, 
                         left_side, n_quad1d);
-        //reflecting_boundary(*rho_left, rho_right, 
-                            //*u_left,   u_right, 
-                            //*v_left,   v_right, 
-                            //*E_left,   E_right,
+        //reflecting_boundary(rho_left, rho_right, 
+                            //u_left,   u_right, 
+                            //v_left,   v_right, 
+                            //E_left,   E_right,
                             //v1x, v1y, v2x, v2y, v3x, v3y, 
                             //nx, ny, j, left_side, n_quad1d);
 
@@ -689,45 +1090,20 @@ void eval_left_right(double *c_rho_left, double *c_rho_right,
                         v1x, v1y, v2x, v2y, v3x, v3y, 
                         j, 
                         left_side, n_quad1d);
-        //outflow_boundary(*rho_left, rho_right,
-                         //*u_left,   u_right,
-                         //*v_left,   v_right,
-                         //*E_left,   E_right,
+        //outflow_boundary(rho_left, rho_right,
+                         //u_left,   u_right,
+                         //v_left,   v_right,
+                         //E_left,   E_right,
                          //nx, ny);
 
     ///////////////////////
     // inflow 
     ///////////////////////
-    } else if (right_idx == -3) {
+    } else {
         inflow_boundary(rho_right, u_right, v_right, E_right,
                         v1x, v1y, v2x, v2y, v3x, v3y, 
                         j, 
                         left_side, n_quad1d);
-    ///////////////////////
-    // not a boundary
-    ///////////////////////
-    } else {
-        // evaluate the right side at the integration point
-        for (i = 0; i < n_p; i++) {
-            *rho_right += c_rho_right[i] * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
-            *u_right   += c_u_right[i]   * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
-            *v_right   += c_v_right[i]   * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
-            *E_right   += c_E_right[i]   * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
-        }
-
-        // in case rho_right comes back nonphysical
-        //if (*rho_right <= 0) {
-            //*rho_right = c_rho_right[0];
-        //}
-
-        // in case E_right comes back nonphysical
-        //if (*E_right <= 0) {
-            //*E_right = c_E_right[0];
-        //}
-
-        // again, since we have coefficients for rho * u and rho * v
-        *u_right = *u_right / *rho_right;
-        *v_right = *v_right / *rho_right;
     }
 }
 
@@ -820,37 +1196,88 @@ void eval_flux(double rho, double u, double v, double E,
     flux_y[3] = v * (E + p);
 }
 
-void eval_surface(double *c,
-                  double *left_riemann_rhs, double *right_riemann_rhs, 
-                  double *length, 
-                  double *V1x, double *V1y,
-                  double *V2x, double *V2y,
-                  double *V3x, double *V3y,
-                  int *left_idx_list,  int *right_idx_list,
-                  int *left_side_list, int *right_side_list, 
-                  double *Nx, double *Ny, 
-                  int n_quad1d, int n_quad, int n_p, int num_sides, 
-                  int num_elem, double t) {
-    int idx; 
+/* riemann flux
+ *
+ * the local lax-friedrichs flux through the side at one integration point.
+ * takes the actual values of u and v on both sides.
+ */
+void eval_riemann_flux(double rho_left,  double u_left,  double v_left,  double E_left,
+                       double rho_right, double u_right, double v_right, double E_right,
+                       double nx, double ny,
+                       int left_side, int right_side, int idx,
+                       double *s) {
+    double lambda;
+    double flux_x_l[4], flux_y_l[4];
+    double flux_x_r[4], flux_y_r[4];
+
+    // calculate the left fluxes
+    eval_flux(rho_left, u_left, v_left, E_left,
+              flux_x_l, flux_y_l,
+              left_side, idx);
+
+    // calculate the right fluxes
+    eval_flux(rho_right, u_right, v_right, E_right,
+              flux_x_r, flux_y_r,
+              right_side, idx);
+
+    // need these local max values
+    lambda = eval_lambda(rho_left, rho_right,
+                         u_left, u_right, 
+                         v_left, v_right, 
+                         E_left, E_right,
+                         nx, ny,
+                         left_side, right_side,
+                         idx);
+
+    // reconstruct primitive variables
+    u_left *= rho_left;
+    u_right *= rho_right;
+    v_left *= rho_left;
+    v_right *= rho_right;
+
+    s[0] = 0.5 * ((flux_x_l[0] + flux_x_r[0]) * nx + (flux_y_l[0] + flux_y_r[0]) * ny 
+                  + lambda * (rho_left - rho_right));
+    s[1] = 0.5 * ((flux_x_l[1] + flux_x_r[1]) * nx + (flux_y_l[1] + flux_y_r[1]) * ny 
+                  + lambda * (u_left - u_right));
+    s[2] = 0.5 * ((flux_x_l[2] + flux_x_r[2]) * nx + (flux_y_l[2] + flux_y_r[2]) * ny 
+                  + lambda * (v_left - v_right));
+    s[3] = 0.5 * ((flux_x_l[3] + flux_x_r[3]) * nx + (flux_y_l[3] + flux_y_r[3]) * ny 
+                  + lambda * (E_left - E_right));
+}
+
+/* interior surface integrals
+ *
+ * the riemann problems for the interior sides start through end - 1. every
+ * side has a right element, so there's nothing to branch on. the sides must
+ * all be one color so that adding into rhs can't race.
+ *
+ * the numerical flux only depends on the integration point, so it's found
+ * once for each of the n_quad1d points and then projected onto the n_p basis
+ * functions of both elements.
+ */
+void eval_surface_interior_share(double *c, double *rhs,
+                                 double *length, 
+                                 int *left_idx_list,  int *right_idx_list,
+                                 int *left_side_list, int *right_side_list, 
+                                 double *Nx, double *Ny, 
+                                 int n_quad1d, int n_p, int num_sides, int num_elem,
+                                 int start, int end) {
+    int pos;
+
+    for (pos = start; pos < end; pos++) {
+        int idx = side_at(pos);
 
-    // loop through each side
-    for (idx = 0; idx < num_sides; idx++) {
         int left_idx  = left_idx_list[idx];
         int left_side = left_side_list[idx];
+        int left_base = coeff_base(left_idx, n_p);
 
         int right_idx  = right_idx_list[idx];
         int right_side = right_side_list[idx];
+        int right_base = coeff_base(right_idx, n_p);
 
         double nx = Nx[idx];
         double ny = Ny[idx];
 
-        double v1x = V1x[left_idx];
-        double v1y = V1y[left_idx];
-        double v2x = V2x[left_idx];
-        double v2y = V2y[left_idx];
-        double v3x = V3x[left_idx];
-        double v3y = V3y[left_idx];
-
         double len = length[idx];
 
         double c_rho_left[n_p];
@@ -863,34 +1290,54 @@ void eval_surface(double *c,
         double c_v_right[n_p];
         double c_E_right[n_p];
 
-        int i, j;
-        double s;
-        double lambda;
+        // weighted numerical flux at each integration point
+        double s[n_quad1d][4];
+
+        int i, j, k;
+        double *left_basis, *right_basis;
         double left_sum1, right_sum1;
         double left_sum2, right_sum2;
         double left_sum3, right_sum3;
         double left_sum4, right_sum4;
-        double flux_x_l[4], flux_y_l[4];
-        double flux_x_r[4], flux_y_r[4];
         double rho_left, u_left, v_left, E_left;
         double rho_right, u_right, v_right, E_right;
 
-        // get the coefficients for this side's element
+        // get the coefficients for this side's elements
         for (i = 0; i < n_p; i++) {
-            c_rho_left[i] = c[num_elem * n_p * 0 + i * num_elem + left_idx];
-            c_u_left[i]   = c[num_elem * n_p * 1 + i * num_elem + left_idx];
-            c_v_left[i]   = c[num_elem * n_p * 2 + i * num_elem + left_idx];
-            c_E_left[i]   = c[num_elem * n_p * 3 + i * num_elem + left_idx];
-
-            if (right_idx >= 0) {
-                c_rho_right[i] = c[num_elem * n_p * 0 + i * num_elem + right_idx];
-                c_u_right[i]   = c[num_elem * n_p * 1 + i * num_elem + right_idx];
-                c_v_right[i]   = c[num_elem * n_p * 2 + i * num_elem + right_idx];
-                c_E_right[i]   = c[num_elem * n_p * 3 + i * num_elem + right_idx];
+            c_rho_left[i] = c[left_base + (0 * n_p + i) * elem_block];
+            c_u_left[i]   = c[left_base + (1 * n_p + i) * elem_block];
+            c_v_left[i]   = c[left_base + (2 * n_p + i) * elem_block];
+            c_E_left[i]   = c[left_base + (3 * n_p + i) * elem_block];
+
+            c_rho_right[i] = c[right_base + (0 * n_p + i) * elem_block];
+            c_u_right[i]   = c[right_base + (1 * n_p + i) * elem_block];
+            c_v_right[i]   = c[right_base + (2 * n_p + i) * elem_block];
+            c_E_right[i]   = c[right_base + (3 * n_p + i) * elem_block];
+        }
+
+        // solve the riemann problem at each integration point
+        for (j = 0; j < n_quad1d; j++) {
+            // calculate the left and right values along the surface
+            eval_left(c_rho_left, c_u_left, c_v_left, c_E_left,
+                      &rho_left, &u_left, &v_left, &E_left,
+                      j, left_side, n_p, n_quad1d);
+            eval_right(c_rho_right, c_u_right, c_v_right, c_E_right,
+                       &rho_right, &u_right, &v_right, &E_right,
+                       j, right_side, n_p, n_quad1d);
+
+            eval_riemann_flux(rho_left,  u_left,  v_left,  E_left,
+                              rho_right, u_right, v_right, E_right,
+                              nx, ny, left_side, right_side, idx, s[j]);
+
+            for (k = 0; k < 4; k++) {
+                s[j][k] = w_oned[j] * s[j][k];
             }
         }
+
         // multiply across by the i'th basis function
         for (i = 0; i < n_p; i++) {
+            left_basis  = basis_side + left_side  * n_p * n_quad1d + i * n_quad1d;
+            right_basis = basis_side + right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1;
 
             left_sum1  = 0.;
             left_sum2  = 0.;
@@ -901,203 +1348,361 @@ void eval_surface(double *c,
             right_sum3 = 0.;
             right_sum4 = 0.;
 
+            // the right element's points run backwards along the side
             for (j = 0; j < n_quad1d; j++) {
-                // calculate the left and right values along the surface
-                eval_left_right(c_rho_left, c_rho_right,
-                                c_u_left,   c_u_right,
-                                c_v_left,   c_v_right,
-                                c_E_left,   c_E_right,
-                                &rho_left,  &u_left,  &v_left,  &E_left,
-                                &rho_right, &u_right, &v_right, &E_right,
-                                nx, ny,
-                                v1x, v1y, v2x, v2y, v3x, v3y,
-                                j, left_side, right_side,
-                                left_idx, right_idx,
-                                n_p, n_quad1d, num_sides, t);
-
-                // calculate the left fluxes
-                eval_flux(rho_left, u_left, v_left, E_left,
-                          flux_x_l, flux_y_l,
-                          left_side, idx);
-
-                // calculate the right fluxes
-                eval_flux(rho_right, u_right, v_right, E_right,
-                          flux_x_r, flux_y_r,
-                          right_side, idx);
-
-                // need these local max values
-                lambda = eval_lambda(rho_left, rho_right,
-                                     u_left, u_right, 
-                                     v_left, v_right, 
-                                     E_left, E_right,
-                                     nx, ny,
-                                     left_side, right_side,
-                                     idx);
-
-                // reconstruct primitive variables
-                u_left *= rho_left;
-                u_right *= rho_right;
-                v_left *= rho_left;
-                v_right *= rho_right;
-
-                // 1st equation
-                s = 0.5 * ((flux_x_l[0] + flux_x_r[0]) * nx + (flux_y_l[0] + flux_y_r[0]) * ny 
-                            + lambda * (rho_left - rho_right));
-                left_sum1  += w_oned[j] * s * basis_side[left_side  * n_p * n_quad1d + i * n_quad1d + j];
-                right_sum1 += w_oned[j] * s * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
-
-                // 2nd equation
-                s = 0.5 * ((flux_x_l[1] + flux_x_r[1]) * nx + (flux_y_l[1] + flux_y_r[1]) * ny 
-                            + lambda * (u_left - u_right));
-                left_sum2  += w_oned[j] * s * basis_side[left_side  * n_p * n_quad1d + i * n_quad1d + j];
-                right_sum2 += w_oned[j] * s * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
-
-                // 3rd equation
-                s = 0.5 * ((flux_x_l[2] + flux_x_r[2]) * nx + (flux_y_l[2] + flux_y_r[2]) * ny 
-                            + lambda * (v_left - v_right));
-                left_sum3  += w_oned[j] * s * basis_side[left_side  * n_p * n_quad1d + i * n_quad1d + j];
-                right_sum3 += w_oned[j] * s * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
-
-                // 4th equation
-                s = 0.5 * ((flux_x_l[3] + flux_x_r[3]) * nx + (flux_y_l[3] + flux_y_r[3]) * ny 
-                            + lambda * (E_left - E_right));
-                left_sum4  += w_oned[j] * s * basis_side[left_side  * n_p * n_quad1d + i * n_quad1d + j];
-                right_sum4 += w_oned[j] * s * basis_side[right_side * n_p * n_quad1d + i * n_quad1d + n_quad1d - 1 - j];
+                left_sum1  += s[j][0] * left_basis[j];
+                right_sum1 += s[j][0] * right_basis[-j];
+                left_sum2  += s[j][1] * left_basis[j];
+                right_sum2 += s[j][1] * right_basis[-j];
+                left_sum3  += s[j][2] * left_basis[j];
+                right_sum3 += s[j][2] * right_basis[-j];
+                left_sum4  += s[j][3] * left_basis[j];
+                right_sum4 += s[j][3] * right_basis[-j];
             }
 
-            // store this side's contribution in the riemann rhs vectors
-            left_riemann_rhs[num_sides * n_p * 0 + i * num_sides + idx]  = -len / 2. * left_sum1;
-            left_riemann_rhs[num_sides * n_p * 1 + i * num_sides + idx]  = -len / 2. * left_sum2;
-            left_riemann_rhs[num_sides * n_p * 2 + i * num_sides + idx]  = -len / 2. * left_sum3;
-            left_riemann_rhs[num_sides * n_p * 3 + i * num_sides + idx]  = -len / 2. * left_sum4;
-            right_riemann_rhs[num_sides * n_p * 0 + i * num_sides + idx] =  len / 2. * right_sum1;
-            right_riemann_rhs[num_sides * n_p * 1 + i * num_sides + idx] =  len / 2. * right_sum2;
-            right_riemann_rhs[num_sides * n_p * 2 + i * num_sides + idx] =  len / 2. * right_sum3;
-            right_riemann_rhs[num_sides * n_p * 3 + i * num_sides + idx] =  len / 2. * right_sum4;
+            // add this side's contribution to both elements
+            rhs[left_base  + (0 * n_p + i) * elem_block] -= len / 2. * left_sum1;
+            rhs[left_base  + (1 * n_p + i) * elem_block] -= len / 2. * left_sum2;
+            rhs[left_base  + (2 * n_p + i) * elem_block] -= len / 2. * left_sum3;
+            rhs[left_base  + (3 * n_p + i) * elem_block] -= len / 2. * left_sum4;
+            rhs[right_base + (0 * n_p + i) * elem_block] += len / 2. * right_sum1;
+            rhs[right_base + (1 * n_p + i) * elem_block] += len / 2. * right_sum2;
+            rhs[right_base + (2 * n_p + i) * elem_block] += len / 2. * right_sum3;
+            rhs[right_base + (3 * n_p + i) * elem_block] += len / 2. * right_sum4;
         }
     }
 }
 
-/* volume integrals
+void eval_surface_interior(double *c, double *rhs,
+                           double *length, 
+                           int *left_idx_list,  int *right_idx_list,
+                           int *left_side_list, int *right_side_list, 
+                           double *Nx, double *Ny, 
+                           int n_quad1d, int n_p, int num_sides, int num_elem,
+                           int start, int end) {
+    TEAM_RUN(start, end, 1,
+             eval_surface_interior_share(c, rhs,
+                                         length,
+                                         left_idx_list, right_idx_list,
+                                         left_side_list, right_side_list,
+                                         Nx, Ny,
+                                         n_quad1d, n_p, num_sides, num_elem,
+                                         first, last));
+}
+
+/* boundary surface integrals
  *
- * evaluates and adds the volume integral to the rhs vector
- * THREADS: num_elem
+ * the riemann problems for the boundary sides start through end - 1, which
+ * are all of type boundary (-1, -2 or -3) and one color. only the left
+ * element gets a contribution. same two phases as eval_surface_interior.
  */
-void eval_volume(double *c,
-                 double *quad_rhs, 
-                 double *X_r, double *Y_r, double *X_s, double *Y_s,
-                 int n_quad, int n_p, int num_elem) {
-    int idx;
+void eval_surface_boundary_share(double *c, double *rhs,
+                                 double *length, 
+                                 double *V1x, double *V1y,
+                                 double *V2x, double *V2y,
+                                 double *V3x, double *V3y,
+                                 int *left_idx_list, 
+                                 int *left_side_list, int *right_side_list, 
+                                 double *Nx, double *Ny, 
+                                 int n_quad1d, int n_p, int num_sides, int num_elem,
+                                 int start, int end, int boundary, double t) {
+    int pos;
+
+    for (pos = start; pos < end; pos++) {
+        int idx = side_at(pos);
 
-    // loop through each element
-    for (idx = 0; idx < num_elem; idx++) {
-        
-        double x_r = X_r[idx];
-        double y_r = Y_r[idx];
-        double x_s = X_s[idx];
-        double y_s = Y_s[idx];
+        int left_idx  = left_idx_list[idx];
+        int left_side = left_side_list[idx];
+        int left_base = coeff_base(left_idx, n_p);
 
-        double flux_x[4], flux_y[4];
-        double c_rho[n_p];
-        double c_u[n_p];
-        double c_v[n_p];
-        double c_E[n_p];
+        int right_side = right_side_list[idx];
 
-        int i, j, k;
-        double rho, u, v, E;
-        double flux_x1, flux_y1, flux_x2, flux_y2;
-        double flux_x3, flux_y3, flux_x4, flux_y4;
-        double sum1, sum2, sum3, sum4;
+        double nx = Nx[idx];
+        double ny = Ny[idx];
+
+        double v1x = V1x[left_idx];
+        double v1y = V1y[left_idx];
+        double v2x = V2x[left_idx];
+        double v2y = V2y[left_idx];
+        double v3x = V3x[left_idx];
+        double v3y = V3y[left_idx];
+
+        double len = length[idx];
+
+        double c_rho_left[n_p];
+        double c_u_left[n_p];
+        double c_v_left[n_p];
+        double c_E_left[n_p];
+
+        double s[n_quad1d][4];
 
+        int i, j, k;
+        double *left_basis;
+        double left_sum1, left_sum2, left_sum3, left_sum4;
+        double rho_left, u_left, v_left, E_left;
+        double rho_right, u_right, v_right, E_right;
 
-        // get the coefficients
+        // get the coefficients for this side's element
         for (i = 0; i < n_p; i++) {
-            c_rho[i] = c[num_elem * n_p * 0 + i * num_elem + idx];
-            c_u[i]   = c[num_elem * n_p * 1 + i * num_elem + idx];
-            c_v[i]   = c[num_elem * n_p * 2 + i * num_elem + idx];
-            c_E[i]   = c[num_elem * n_p * 3 + i * num_elem + idx];
+            c_rho_left[i] = c[left_base + (0 * n_p + i) * elem_block];
+            c_u_left[i]   = c[left_base + (1 * n_p + i) * elem_block];
+            c_v_left[i]   = c[left_base + (2 * n_p + i) * elem_block];
+            c_E_left[i]   = c[left_base + (3 * n_p + i) * elem_block];
         }
 
-        // evaluate the volume integral for each coefficient
+        for (j = 0; j < n_quad1d; j++) {
+            // calculate the left and right values along the surface
+            eval_left(c_rho_left, c_u_left, c_v_left, c_E_left,
+                      &rho_left, &u_left, &v_left, &E_left,
+                      j, left_side, n_p, n_quad1d);
+            eval_boundary(rho_left, &rho_right,
+                          u_left,   &u_right,
+                          v_left,   &v_right,
+                          E_left,   &E_right,
+                          nx, ny,
+                          v1x, v1y, v2x, v2y, v3x, v3y,
+                          j, left_side, boundary, n_quad1d, t);
+
+            eval_riemann_flux(rho_left,  u_left,  v_left,  E_left,
+                              rho_right, u_right, v_right, E_right,
+                              nx, ny, left_side, right_side, idx, s[j]);
+
+            for (k = 0; k < 4; k++) {
+                s[j][k] = w_oned[j] * s[j][k];
+            }
+        }
+
+        // multiply across by the i'th basis function
         for (i = 0; i < n_p; i++) {
-            sum1 = 0.;
-            sum2 = 0.;
-            sum3 = 0.;
-            sum4 = 0.;
-            for (j = 0; j < n_quad; j++) {
-                // evaluate rho, u, v, E at the integration point.
-                rho = 0.;
-                u   = 0.;
-                v   = 0.;
-                E   = 0.;
-                for (k = 0; k < n_p; k++) {
-                    rho += c_rho[k] * basis[n_quad * k + j];
-                    u   += c_u[k]   * basis[n_quad * k + j];
-                    v   += c_v[k]   * basis[n_quad * k + j];
-                    E   += c_E[k]   * basis[n_quad * k + j];
-                }
-
-
-                // in case rho comes back nonphysical
-                if (rho <= 0) {
-                    rho = c_rho[0] * 1.414213562373095E+00;
-                    printf("rho unphysical in volume\n");
-                    exit(0);
-                }
-
-                // in case E comes back nonphysical
-                if (E <= 0) {
-                    E = c_E[0] * 1.414213562373095E+00;
-                    printf("E unphysical in volume\n");
-                    exit(0);
-                }
-
-                // since we actually have coefficients for rho * u, rho * v
-                u = u / rho;
-                v = v / rho;
-
-                // evaluate flux
-                eval_flux(rho, u, v, E, flux_x, flux_y, 1000, idx);
-                     
-                // Add to the sum
-                // [fx fy] * [y_s, -y_r; -x_s, x_r] * [phi_x phi_y]
-
-                // 1st equation
-                sum1 +=   flux_x[0] * ( basis_grad_x[n_quad * i + j] * y_s
-                                     -basis_grad_y[n_quad * i + j] * y_r)
-                        + flux_y[0] * (-basis_grad_x[n_quad * i + j] * x_s 
-                                    + basis_grad_y[n_quad * i + j] * x_r);
-
-                // 2nd equation
-                sum2 +=   flux_x[1] * ( basis_grad_x[n_quad * i + j] * y_s
-                                     -basis_grad_y[n_quad * i + j] * y_r)
-                        + flux_y[1] * (-basis_grad_x[n_quad * i + j] * x_s 
-                                    + basis_grad_y[n_quad * i + j] * x_r);
-
-                // 3rd equation
-                sum3 +=   flux_x[2] * ( basis_grad_x[n_quad * i + j] * y_s
-                                     -basis_grad_y[n_quad * i + j] * y_r)
-                        + flux_y[2] * (-basis_grad_x[n_quad * i + j] * x_s 
-                                    + basis_grad_y[n_quad * i + j] * x_r);
-
-                // 4th equation
-                sum4 +=   flux_x[3] * ( basis_grad_x[n_quad * i + j] * y_s
-                                     -basis_grad_y[n_quad * i + j] * y_r)
-                        + flux_y[3] * (-basis_grad_x[n_quad * i + j] * x_s 
-                                    + basis_grad_y[n_quad * i + j] * x_r);
+            left_basis = basis_side + left_side * n_p * n_quad1d + i * n_quad1d;
+
+            left_sum1  = 0.;
+            left_sum2  = 0.;
+            left_sum3  = 0.;
+            left_sum4  = 0.;
+
+            for (j = 0; j < n_quad1d; j++) {
+                left_sum1 += s[j][0] * left_basis[j];
+                left_sum2 += s[j][1] * left_basis[j];
+                left_sum3 += s[j][2] * left_basis[j];
+                left_sum4 += s[j][3] * left_basis[j];
             }
 
-            //printf("%lf, %lf, %lf, %lf\n", sum1, sum2, sum3, sum4);
+            // add this side's contribution to the element
+            rhs[left_base + (0 * n_p + i) * elem_block] -= len / 2. * left_sum1;
+            rhs[left_base + (1 * n_p + i) * elem_block] -= len / 2. * left_sum2;
+            rhs[left_base + (2 * n_p + i) * elem_block] -= len / 2. * left_sum3;
+            rhs[left_base + (3 * n_p + i) * elem_block] -= len / 2. * left_sum4;
+        }
+    }
+}
+
+void eval_surface_boundary(double *c, double *rhs,
+                           double *length, 
+                           double *V1x, double *V1y,
+                           double *V2x, double *V2y,
+                           double *V3x, double *V3y,
+                           int *left_idx_list, 
+                           int *left_side_list, int *right_side_list, 
+                           double *Nx, double *Ny, 
+                           int n_quad1d, int n_p, int num_sides, int num_elem,
+                           int start, int end, int boundary, double t) {
+    TEAM_RUN(start, end, 1,
+             eval_surface_boundary_share(c, rhs,
+                                         length,
+                                         V1x, V1y,
+                                         V2x, V2y,
+                                         V3x, V3y,
+                                         left_idx_list,
+                                         left_side_list, right_side_list,
+                                         Nx, Ny,
+                                         n_quad1d, n_p, num_sides, num_elem,
+                                         first, last, boundary, t));
+}
 
-            // store the result
-            quad_rhs[num_elem * n_p * 0 + i * num_elem + idx] = sum1;
-            quad_rhs[num_elem * n_p * 1 + i * num_elem + idx] = sum2;
-            quad_rhs[num_elem * n_p * 2 + i * num_elem + idx] = sum3;
-            quad_rhs[num_elem * n_p * 3 + i * num_elem + idx] = sum4;
+/* surface integrals
+ *
+ * evaluates all the riemann problems and adds them to rhs, which must already
+ * hold the volume integrals: the interior sides in one branch-free pass, then
+ * each group of boundary sides. every group runs one color at a time.
+ */
+void eval_surface(double *c, double *rhs,
+                  double *length, 
+                  double *V1x, double *V1y,
+                  double *V2x, double *V2y,
+                  double *V3x, double *V3y,
+                  int *left_idx_list,  int *right_idx_list,
+                  int *left_side_list, int *right_side_list, 
+                  double *Nx, double *Ny, 
+                  int n_quad1d, int n_quad, int n_p, int num_sides, 
+                  int num_elem, double t) {
+    int j, k;
+
+    for (j = 0; j < num_colors[0]; j++) {
+        eval_surface_interior(c, rhs,
+                              length,
+                              left_idx_list, right_idx_list,
+                              left_side_list, right_side_list,
+                              Nx, Ny,
+                              n_quad1d, n_p, num_sides, num_elem,
+                              color_ranges[0][j], color_end(0, j));
+    }
+
+    // reflecting, outflow, inflow
+    for (k = 1; k < 4; k++) {
+        for (j = 0; j < num_colors[k]; j++) {
+            eval_surface_boundary(c, rhs,
+                                  length,
+                                  V1x, V1y, V2x, V2y, V3x, V3y,
+                                  left_idx_list,
+                                  left_side_list, right_side_list,
+                                  Nx, Ny,
+                                  n_quad1d, n_p, num_sides, num_elem,
+                                  color_ranges[k][j], color_end(k, j), -k, t);
         }
     }
 }
 
+/* element volume integral
+ *
+ * the volume integral of element idx into rhs, as eval_volume does it for
+ * every element.
+ */
+void eval_volume_elem(double *c,
+                      double *quad_rhs, 
+                      double *X_r, double *Y_r, double *X_s, double *Y_s,
+                      int n_quad, int n_p, int idx) {
+    int base = coeff_base(idx, n_p);
+    
+    double x_r = X_r[idx];
+    double y_r = Y_r[idx];
+    double x_s = X_s[idx];
+    double y_s = Y_s[idx];
+
+    double flux_x[4], flux_y[4];
+    double c_rho[n_p];
+    double c_u[n_p];
+    double c_v[n_p];
+    double c_E[n_p];
+
+    // the flux at each integration point in the r and s directions
+    double flux_r[n_quad][4];
+    double flux_s[n_quad][4];
+
+    int i, j, k;
+    double rho, u, v, E;
+    double sum1, sum2, sum3, sum4;
+    double *grad_x, *grad_y;
+
+    // get the coefficients
+    for (i = 0; i < n_p; i++) {
+        c_rho[i] = c[base + (0 * n_p + i) * elem_block];
+        c_u[i]   = c[base + (1 * n_p + i) * elem_block];
+        c_v[i]   = c[base + (2 * n_p + i) * elem_block];
+        c_E[i]   = c[base + (3 * n_p + i) * elem_block];
+    }
+
+    for (j = 0; j < n_quad; j++) {
+        // evaluate rho, u, v, E at the integration point.
+        rho = 0.;
+        u   = 0.;
+        v   = 0.;
+        E   = 0.;
+        for (k = 0; k < n_p; k++) {
+            rho += c_rho[k] * basis[n_quad * k + j];
+            u   += c_u[k]   * basis[n_quad * k + j];
+            v   += c_v[k]   * basis[n_quad * k + j];
+            E   += c_E[k]   * basis[n_quad * k + j];
+        }
+
+        // in case rho comes back nonphysical
+        if (rho <= 0) {
+            rho = c_rho[0] * 1.414213562373095E+00;
+            printf("rho unphysical in volume\n");
+            exit(0);
+        }
+
+        // in case E comes back nonphysical
+        if (E <= 0) {
+            E = c_E[0] * 1.414213562373095E+00;
+            printf("E unphysical in volume\n");
+            exit(0);
+        }
+
+        // since we actually have coefficients for rho * u, rho * v
+        u = u / rho;
+        v = v / rho;
+
+        // evaluate flux
+        eval_flux(rho, u, v, E, flux_x, flux_y, 1000, idx);
+
+        // [fx fy] * [y_s, -y_r; -x_s, x_r]
+        for (k = 0; k < 4; k++) {
+            flux_r[j][k] =  flux_x[k] * y_s - flux_y[k] * x_s;
+            flux_s[j][k] = -flux_x[k] * y_r + flux_y[k] * x_r;
+        }
+    }
+
+    // evaluate the volume integral for each coefficient
+    for (i = 0; i < n_p; i++) {
+        grad_x = basis_grad_x + n_quad * i;
+        grad_y = basis_grad_y + n_quad * i;
+
+        sum1 = 0.;
+        sum2 = 0.;
+        sum3 = 0.;
+        sum4 = 0.;
+        for (j = 0; j < n_quad; j++) {
+            sum1 += flux_r[j][0] * grad_x[j] + flux_s[j][0] * grad_y[j];
+            sum2 += flux_r[j][1] * grad_x[j] + flux_s[j][1] * grad_y[j];
+            sum3 += flux_r[j][2] * grad_x[j] + flux_s[j][2] * grad_y[j];
+            sum4 += flux_r[j][3] * grad_x[j] + flux_s[j][3] * grad_y[j];
+        }
+
+        // store the result
+        quad_rhs[base + (0 * n_p + i) * elem_block] = sum1;
+        quad_rhs[base + (1 * n_p + i) * elem_block] = sum2;
+        quad_rhs[base + (2 * n_p + i) * elem_block] = sum3;
+        quad_rhs[base + (3 * n_p + i) * elem_block] = sum4;
+    }
+}
+
+/* volume integrals
+ *
+ * evaluates the volume integral into the rhs vector. this overwrites rhs, so
+ * it runs before eval_surface adds the riemann contributions.
+ * THREADS: num_elem
+ *
+ * works in three phases for each element: interpolate the solution to the
+ * integration points, evaluate the flux there (mapped to the canonical
+ * element) and project it onto the gradients of the basis functions. the
+ * flux is only evaluated n_quad times instead of n_p * n_quad times.
+ */
+void eval_volume_share(double *c,
+                       double *quad_rhs, 
+                       double *X_r, double *Y_r, double *X_s, double *Y_s,
+                       int n_quad, int n_p, int num_elem,
+                       int first, int last) {
+    int pos;
+
+    // loop through each element
+    for (pos = first; pos < last; pos++) {
+        eval_volume_elem(c, quad_rhs, X_r, Y_r, X_s, Y_s, n_quad, n_p, elem_at(pos));
+    }
+}
+
+void eval_volume(double *c,
+                 double *quad_rhs, 
+                 double *X_r, double *Y_r, double *X_s, double *Y_s,
+                 int n_quad, int n_p, int num_elem) {
+    TEAM_RUN(0, num_elem, 1,
+             eval_volume_share(c,
+                               quad_rhs,
+                               X_r, Y_r, X_s, Y_s,
+                               n_quad, n_p, num_elem,
+                               first, last));
+}
+
 /* evaluate u
  * 
  * evaluates rho and E at the three vertex points for output
@@ -1108,6 +1713,7 @@ void eval_u(double *c,
             int num_elem, int n_p, int j) {
     int idx;
     for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
         int i;
         double uv1, uv2, uv3;
 
@@ -1116,9 +1722,9 @@ void eval_u(double *c,
         uv2 = 0.;
         uv3 = 0.;
         for (i = 0; i < n_p; i++) {
-            uv1 += c[num_elem * n_p * j + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            uv2 += c[num_elem * n_p * j + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            uv3 += c[num_elem * n_p * j + i * num_elem + idx] * basis_vertex[i * 3 + 2];
+            uv1 += c[base + (j * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            uv2 += c[base + (j * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            uv3 += c[base + (j * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
         }
 
         // store result
@@ -1139,6 +1745,7 @@ void eval_u_velocity(double *c,
     int idx;
 
     for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
         int i;
 
         double uv1, uv2, uv3;
@@ -1149,18 +1756,18 @@ void eval_u_velocity(double *c,
         rhov2 = 0.;
         rhov3 = 0.;
         for (i = 0; i < n_p; i++) {
-            rhov1 += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            rhov2 += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            rhov3 += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
+            rhov1 += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            rhov2 += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            rhov3 += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
         }
 
         uv1 = 0.;
         uv2 = 0.;
         uv3 = 0.;
         for (i = 0; i < n_p; i++) {
-            uv1 += c[num_elem * n_p * j + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            uv2 += c[num_elem * n_p * j + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            uv3 += c[num_elem * n_p * j + i * num_elem + idx] * basis_vertex[i * 3 + 2];
+            uv1 += c[base + (j * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            uv2 += c[base + (j * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            uv3 += c[base + (j * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
         }
 
         uv1 = uv1 / rhov1;
@@ -1184,6 +1791,7 @@ void eval_p(double *c,
     int idx;
 
     for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
         int i;
 
         double rhov1, rhov2, rhov3;
@@ -1209,27 +1817,27 @@ void eval_p(double *c,
         Ev3 = 0.;
 
         for (i = 0; i < n_p; i++) {
-            rhov1 += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            rhov2 += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            rhov3 += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
+            rhov1 += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            rhov2 += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            rhov3 += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
         }
 
         for (i = 0; i < n_p; i++) {
-            uv1 += c[num_elem * n_p * 1 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            uv2 += c[num_elem * n_p * 1 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            uv3 += c[num_elem * n_p * 1 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
+            uv1 += c[base + (1 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            uv2 += c[base + (1 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            uv3 += c[base + (1 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
         }
 
         for (i = 0; i < n_p; i++) {
-            vv1 += c[num_elem * n_p * 2 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            vv2 += c[num_elem * n_p * 2 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            vv3 += c[num_elem * n_p * 2 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
+            vv1 += c[base + (2 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            vv2 += c[base + (2 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            vv3 += c[base + (2 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
         }
 
         for (i = 0; i < n_p; i++) {
-            Ev1 += c[num_elem * n_p * 3 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            Ev2 += c[num_elem * n_p * 3 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            Ev3 += c[num_elem * n_p * 3 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
+            Ev1 += c[base + (3 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            Ev2 += c[base + (3 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            Ev3 += c[base + (3 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
         }
 
         uv1 = uv1 / rhov1;
@@ -1253,7 +1861,7 @@ void eval_p(double *c,
  */
 void check_convergence(double *c_prev, double *c, int num_elem, int n_p) {
     int idx;
-    for (idx = 0; idx < num_elem * n_p * 4; idx++) {
+    for (idx = 0; idx < num_coeffs; idx++) {
         c_prev[idx] = powf(c[idx] - c_prev[idx], 2);
     }
 }
@@ -1267,6 +1875,7 @@ void measure_error(double *c,
                        int num_elem, int n_p) {
     int idx;
     for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
         int i;
         double rho, u, v, E;
         double v1x, v1y, v2x, v2y, v3x, v3y;
@@ -1289,10 +1898,10 @@ void measure_error(double *c,
         v = 0.;
         E = 0.;
         for (i = 0; i < n_p; i++) {
-            rho += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            u   += c[num_elem * n_p * 1 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            v   += c[num_elem * n_p * 2 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
-            E   += c[num_elem * n_p * 3 + i * num_elem + idx] * basis_vertex[i * 3 + 0];
+            rho += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            u   += c[base + (1 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            v   += c[base + (2 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
+            E   += c[base + (3 * n_p + i) * elem_block] * basis_vertex[i * 3 + 0];
         }
 
         u = u / rho;
@@ -1308,10 +1917,10 @@ void measure_error(double *c,
         v = 0.;
         E = 0.;
         for (i = 0; i < n_p; i++) {
-            rho += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            u   += c[num_elem * n_p * 1 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            v   += c[num_elem * n_p * 2 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
-            E   += c[num_elem * n_p * 3 + i * num_elem + idx] * basis_vertex[i * 3 + 1];
+            rho += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            u   += c[base + (1 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            v   += c[base + (2 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
+            E   += c[base + (3 * n_p + i) * elem_block] * basis_vertex[i * 3 + 1];
         }
 
         u = u / rho;
@@ -1327,10 +1936,10 @@ void measure_error(double *c,
         v = 0.;
         E = 0.;
         for (i = 0; i < n_p; i++) {
-            rho += c[num_elem * n_p * 0 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
-            u   += c[num_elem * n_p * 1 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
-            v   += c[num_elem * n_p * 2 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
-            E   += c[num_elem * n_p * 3 + i * num_elem + idx] * basis_vertex[i * 3 + 2];
+            rho += c[base + (0 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
+            u   += c[base + (1 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
+            v   += c[base + (2 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
+            E   += c[base + (3 * n_p + i) * elem_block] * basis_vertex[i * 3 + 2];
         }
 
         u = u / rho;
@@ -1346,3 +1955,150 @@ void measure_error(double *c,
         Uv3[idx] = p3;
     }
 }
+
+/***********************
+ *
+ * ORDER SPECIALIZED KERNELS
+ *
+ ***********************/
+/* one copy of euler_kernels_order.c for each order; see dispatch_functions */
+#define ORDER 0
+#define NP    1
+#define NQ    1
+#define NQ1D  1
+#include "euler_kernels_order.c"
+
+#define ORDER 1
+#define NP    3
+#define NQ    3
+#define NQ1D  2
+#include "euler_kernels_order.c"
+
+#define ORDER 2
+#define NP    6
+#define NQ    6
+#define NQ1D  3
+#include "euler_kernels_order.c"
+
+#define ORDER 3
+#define NP    10
+#define NQ    12
+#define NQ1D  4
+#include "euler_kernels_order.c"
+
+#define ORDER 4
+#define NP    15
+#define NQ    16
+#define NQ1D  5
+#include "euler_kernels_order.c"
+
+#define ORDER 5
+#define NP    21
+#define NQ    25
+#define NQ1D  6
+#include "euler_kernels_order.c"
+
+/***********************
+ *
+ * TENSOR PRODUCT KERNELS
+ *
+ ***********************/
+#include "euler_kernels_tensor.c"
+
+/***********************
+ *
+ * VECTOR KERNELS
+ *
+ ***********************/
+/* the vector instruction sets there are kernels for. vector_isa is the one
+ * dispatch_functions hands them out for, which unless -V says otherwise is
+ * the widest this cpu has (see detect_isa).
+ */
+#define ISA_SCALAR 0
+#define ISA_AVX2   1
+#define ISA_AVX512 2
+
+int vector_isa = -1;
+char *isa_names[] = {"scalar", "avx2", "avx512"};
+
+/* detect isa
+ *
+ * the widest vector instruction set the cpu running this has.
+ */
+int detect_isa() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return ISA_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return ISA_AVX2;
+    }
+    return ISA_SCALAR;
+}
+
+/* parse isa
+ *
+ * returns the instruction set with this name, or -1 if there isn't one or
+ * the cpu doesn't have it.
+ */
+int parse_isa(char *name) {
+    int i;
+
+    for (i = 0; i < (int) (sizeof(isa_names) / sizeof(char *)); i++) {
+        if (strcmp(name, isa_names[i]) == 0) {
+            return (i <= detect_isa()) ? i : -1;
+        }
+    }
+
+    return -1;
+}
+
+/* the formulation of the volume and interior surface kernels: loops over
+ * the basis for each element or side, products of small dense matrices
+ * over tiles of them (see euler_kernels_gemm.c), or sums factored in
+ * collapsed coordinates (see euler_kernels_tensor.c). the gemm kernels need
+ * a vector instruction set, and the tensor ones the points from
+ * set_tensor_quadrature.
+ */
+#define FORM_LOOP   0
+#define FORM_GEMM   1
+#define FORM_TENSOR 2
+
+int kernel_form = FORM_LOOP;
+char *form_names[] = {"loop", "gemm", "tensor"};
+
+/* parse form
+ *
+ * returns the kernel formulation with this name or -1 if there isn't one.
+ */
+int parse_form(char *name) {
+    int i;
+
+    for (i = 0; i < (int) (sizeof(form_names) / sizeof(char *)); i++) {
+        if (strcmp(name, form_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* one copy of euler_kernels_simd.c and euler_kernels_gemm.c for each
+ * instruction set */
+#define LANES       4
+#define SIMD_ISA    avx2
+#define SIMD_TARGET "avx2,fma"
+#include "euler_kernels_simd.c"
+#include "euler_kernels_gemm.c"
+#undef LANES
+#undef SIMD_ISA
+#undef SIMD_TARGET
+
+#define LANES       8
+#define SIMD_ISA    avx512
+#define SIMD_TARGET "avx512f"
+#include "euler_kernels_simd.c"
+#include "euler_kernels_gemm.c"
+#undef LANES
+#undef SIMD_ISA
+#undef SIMD_TARGET
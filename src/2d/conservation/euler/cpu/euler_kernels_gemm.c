@@ -0,0 +1,479 @@
+/* euler_kernels_gemm.c
+ *
+ * the volume integrals and the interior surface integrals as products of
+ * small dense matrices over tiles of GEMM_TILE elements or sides, for one
+ * vector instruction set. euler_kernels.c includes this file right after
+ * euler_kernels_simd.c with the same LANES, SIMD_ISA and SIMD_TARGET, and it
+ * uses the vector types and helpers from there.
+ *
+ * a tile's coefficients are packed into an n_p x 4 * GEMM_TILE matrix with
+ * a column for each equation of each element, so for the volume
+ *
+ *      values (n_quad x 4T) = basis^T (n_quad x n_p) * coeffs (n_p x 4T)
+ *      rhs    (n_p x 4T)    = [grad_x grad_y] (n_p x 2 n_quad) * [flux_r; flux_s]
+ *
+ * and the traces along the sides and their projection back onto the basis
+ * are the same with basis_side. everything goes through gemm_micro, which
+ * keeps a GEMM_MR x 2 LANES block of the product in registers while the
+ * basis, packed into panels of GEMM_MR rows, streams past in order. a tile's
+ * matrices stay in the l2 cache from packing to unpacking.
+ */
+
+#ifndef GEMM_TILE
+#define GEMM_TILE 32 // elements or sides in a tile, a multiple of LANES
+#define GEMM_MR   6  // rows of the block gemm_micro keeps in registers
+
+/* gemm packed size
+ *
+ * the doubles gemm_pack needs for an m x k matrix.
+ */
+int gemm_packed_size(int m, int k) {
+    return (m + GEMM_MR - 1) / GEMM_MR * GEMM_MR * k;
+}
+
+/* gemm pack
+ *
+ * packs the m x k matrix whose (i, p) entry is a[i * row + p * col] into
+ * panels of GEMM_MR rows, each stored column by column, with the last panel
+ * padded with zeros.
+ */
+void gemm_pack(double *a, int m, int k, int row, int col, double *packed) {
+    int i, p, panel;
+
+    for (panel = 0; panel < m; panel += GEMM_MR) {
+        for (p = 0; p < k; p++) {
+            for (i = 0; i < GEMM_MR; i++) {
+                *packed++ = (panel + i < m) ? a[(panel + i) * row + p * col] : 0.;
+            }
+        }
+    }
+}
+#endif
+
+/* gemm micro kernel
+ *
+ * c = a * b for the first m <= GEMM_MR rows of one packed panel a and
+ * 2 LANES columns of the k x n row major b.
+ */
+__attribute__((target(SIMD_TARGET), always_inline))
+static inline void SIMD(gemm_micro)(int m, int k, double *a, double *b, int ldb,
+                                    double *c, int ldc) {
+    SIMD(vec) c0[GEMM_MR], c1[GEMM_MR], b0, b1;
+    int i, p;
+
+    #pragma GCC unroll 8
+    for (i = 0; i < GEMM_MR; i++) {
+        c0[i] = c1[i] = (SIMD(vec)) {0.};
+    }
+
+    for (p = 0; p < k; p++) {
+        b0 = *(SIMD(vec) *) (b + p * ldb);
+        b1 = *(SIMD(vec) *) (b + p * ldb + LANES);
+        #pragma GCC unroll 8
+        for (i = 0; i < GEMM_MR; i++) {
+            c0[i] += a[p * GEMM_MR + i] * b0;
+            c1[i] += a[p * GEMM_MR + i] * b1;
+        }
+    }
+
+    // unrolled over all GEMM_MR rows so the block never leaves the registers
+    #pragma GCC unroll 8
+    for (i = 0; i < GEMM_MR; i++) {
+        if (i < m) {
+            *(SIMD(vec) *) (c + i * ldc)         = c0[i];
+            *(SIMD(vec) *) (c + i * ldc + LANES) = c1[i];
+        }
+    }
+}
+
+/* gemm
+ *
+ * c (m x n) = a (m x k, packed by gemm_pack) * b (k x n), with b and c row
+ * major and n a multiple of 2 LANES. each block of columns of b is used for
+ * every panel of a before moving on, so it stays in the l1 cache.
+ */
+__attribute__((target(SIMD_TARGET)))
+static void SIMD(gemm)(int m, int n, int k, double *a, double *b, int ldb,
+                       double *c, int ldc) {
+    int i, j;
+
+    for (j = 0; j < n; j += 2 * LANES) {
+        for (i = 0; i < m; i += GEMM_MR) {
+            SIMD(gemm_micro)((m - i < GEMM_MR) ? m - i : GEMM_MR, k,
+                             a + i * k, b + j, ldb, c + i * ldc + j, ldc);
+        }
+    }
+}
+
+/* volume integrals
+ *
+ * eval_volume for GEMM_TILE elements at a time: the interpolation and the
+ * projection are products with the tile's coefficients and fluxes, and
+ * volume_flux takes LANES elements at a time in between. a tile with an
+ * unphysical state is redone by eval_volume_elem, which reports it.
+ * THREADS: num_elem / GEMM_TILE
+ */
+__attribute__((target(SIMD_TARGET)))
+void SIMD(eval_volume_gemm_share)(double *c,
+                                  double *quad_rhs,
+                                  double *X_r, double *Y_r, double *X_s, double *Y_s,
+                                  int n_quad, int n_p, int num_elem,
+                                  int first, int last) {
+    double interp[gemm_packed_size(n_quad, n_p)];
+    double project[gemm_packed_size(n_p, 2 * n_quad)];
+    double grad[n_p][2 * n_quad];
+    int tile, i, j;
+
+    gemm_pack(basis, n_quad, n_p, 1, n_quad, interp);
+    for (i = 0; i < n_p; i++) {
+        for (j = 0; j < n_quad; j++) {
+            grad[i][j]          = basis_grad_x[n_quad * i + j];
+            grad[i][n_quad + j] = basis_grad_y[n_quad * i + j];
+        }
+    }
+    gemm_pack(grad[0], n_p, 2 * n_quad, 2 * n_quad, 1, project);
+
+    for (tile = first; tile < last; tile += GEMM_TILE) {
+        int elems = (tile + GEMM_TILE < num_elem) ? GEMM_TILE : num_elem - tile;
+        int idx[GEMM_TILE], base[GEMM_TILE];
+
+        // the sums go where the coefficients were
+        double coeffs[n_p][4 * GEMM_TILE];
+        double values[n_quad][4 * GEMM_TILE];
+        double fluxes[2 * n_quad][4 * GEMM_TILE];
+
+        SIMD(vec) x_r, y_r, x_s, y_s, flux_r[4], flux_s[4];
+        SIMD(mask) unphysical;
+
+        int i, j, k, t, l, contiguous, lanes;
+
+        // the short last tile repeats its last element
+        for (t = 0; t < GEMM_TILE; t++) {
+            idx[t]  = elem_at((t < elems) ? tile + t : tile + elems - 1);
+            base[t] = coeff_base(idx[t], n_p);
+        }
+
+        // a whole row of the tile at a time, so each mode is read in one go
+        for (k = 0; k < 4; k++) {
+            for (i = 0; i < n_p; i++) {
+                for (t = 0; t < GEMM_TILE; t += LANES) {
+                    contiguous = !d_elem_list && t + LANES <= elems;
+                    *(SIMD(vec) *) &coeffs[i][k * GEMM_TILE + t] =
+                        SIMD(load)(c, base + t, contiguous, (k * n_p + i) * elem_block);
+                }
+            }
+        }
+
+        SIMD(gemm)(n_quad, 4 * GEMM_TILE, n_p, interp,
+                   coeffs[0], 4 * GEMM_TILE, values[0], 4 * GEMM_TILE);
+
+        unphysical = (SIMD(mask)) {0};
+        for (t = 0; t < GEMM_TILE; t += LANES) {
+            contiguous = !d_elem_list && t + LANES <= elems;
+            x_r = SIMD(load)(X_r, idx + t, contiguous, 0);
+            y_r = SIMD(load)(Y_r, idx + t, contiguous, 0);
+            x_s = SIMD(load)(X_s, idx + t, contiguous, 0);
+            y_s = SIMD(load)(Y_s, idx + t, contiguous, 0);
+
+            for (j = 0; j < n_quad; j++) {
+                unphysical |= SIMD(volume_flux)(*(SIMD(vec) *) &values[j][0 * GEMM_TILE + t],
+                                                *(SIMD(vec) *) &values[j][1 * GEMM_TILE + t],
+                                                *(SIMD(vec) *) &values[j][2 * GEMM_TILE + t],
+                                                *(SIMD(vec) *) &values[j][3 * GEMM_TILE + t],
+                                                x_r, y_r, x_s, y_s, flux_r, flux_s);
+                for (k = 0; k < 4; k++) {
+                    *(SIMD(vec) *) &fluxes[j][k * GEMM_TILE + t]          = flux_r[k];
+                    *(SIMD(vec) *) &fluxes[n_quad + j][k * GEMM_TILE + t] = flux_s[k];
+                }
+            }
+        }
+
+        for (l = 0; l < LANES; l++) {
+            if (unphysical[l]) {
+                break;
+            }
+        }
+        if (l < LANES) {
+            for (t = 0; t < elems; t++) {
+                eval_volume_elem(c, quad_rhs, X_r, Y_r, X_s, Y_s, n_quad, n_p, idx[t]);
+            }
+            continue;
+        }
+
+        SIMD(gemm)(n_p, 4 * GEMM_TILE, 2 * n_quad, project,
+                   fluxes[0], 4 * GEMM_TILE, coeffs[0], 4 * GEMM_TILE);
+
+        for (k = 0; k < 4; k++) {
+            for (i = 0; i < n_p; i++) {
+                for (t = 0; t < elems; t += LANES) {
+                    lanes      = (t + LANES < elems) ? LANES : elems - t;
+                    contiguous = !d_elem_list && lanes == LANES;
+                    SIMD(store)(quad_rhs, base + t, contiguous, lanes, (k * n_p + i) * elem_block,
+                                *(SIMD(vec) *) &coeffs[i][k * GEMM_TILE + t]);
+                }
+            }
+        }
+    }
+}
+
+void SIMD(eval_volume_gemm)(double *c,
+                            double *quad_rhs,
+                            double *X_r, double *Y_r, double *X_s, double *Y_s,
+                            int n_quad, int n_p, int num_elem) {
+    TEAM_RUN(0, num_elem, GEMM_TILE,
+             SIMD(eval_volume_gemm_share)(c,
+                                          quad_rhs,
+                                          X_r, Y_r, X_s, Y_s,
+                                          n_quad, n_p, num_elem,
+                                          first, last));
+}
+
+/* interior surface integrals
+ *
+ * eval_surface_interior for GEMM_TILE sides at a time. the tile's sides are
+ * sorted into buckets by the side number of their left element, and again
+ * by that of their right, so each bucket's traces are one product with that
+ * side's basis_side matrix (run backwards for the right element).
+ * riemann_flux takes LANES sides at a time, and the weighted fluxes go back
+ * through the same buckets and the transposed matrices onto the basis. the
+ * sides are one color, so the contributions scatter into rhs without
+ * conflicts. a tile with an unphysical trace goes through
+ * eval_surface_interior_share.
+ * THREADS: (end - start) / GEMM_TILE
+ */
+__attribute__((target(SIMD_TARGET)))
+void SIMD(eval_surface_interior_gemm_share)(double *c, double *rhs,
+                                            double *length,
+                                            int *left_idx_list,  int *right_idx_list,
+                                            int *left_side_list, int *right_side_list,
+                                            double *Nx, double *Ny,
+                                            int n_quad1d, int n_p, int num_sides, int num_elem,
+                                            int start, int end) {
+    // [left, right][side number]
+    double trace[2][3][gemm_packed_size(n_quad1d, n_p)];
+    double lift[2][3][gemm_packed_size(n_p, n_quad1d)];
+    double *b;
+    int tile, side;
+
+    // the right element's points run backwards along the side
+    for (side = 0; side < 3; side++) {
+        b = basis_side + side * n_p * n_quad1d;
+        gemm_pack(b,                n_quad1d, n_p,  1,       n_quad1d, trace[0][side]);
+        gemm_pack(b + n_quad1d - 1, n_quad1d, n_p, -1,       n_quad1d, trace[1][side]);
+        gemm_pack(b,                n_p, n_quad1d, n_quad1d,  1,       lift[0][side]);
+        gemm_pack(b + n_quad1d - 1, n_p, n_quad1d, n_quad1d, -1,       lift[1][side]);
+    }
+
+    for (tile = start; tile < end; tile += GEMM_TILE) {
+        int sides = (tile + GEMM_TILE < end) ? GEMM_TILE : end - tile;
+        int idx[GEMM_TILE], base[2][GEMM_TILE];
+        int bucket[2][3][GEMM_TILE], count[2][3];
+
+        // one bucket's matrices, n_p or n_quad1d rows of 4 * width columns
+        double packed[(n_p > n_quad1d ? n_p : n_quad1d) * 4 * GEMM_TILE];
+        double product[(n_p > n_quad1d ? n_p : n_quad1d) * 4 * GEMM_TILE];
+
+        // the tile's traces and weighted fluxes in side order
+        double traces[2][n_quad1d][4][GEMM_TILE];
+        double s[n_quad1d][4][GEMM_TILE];
+
+        SIMD(vec) nx, ny, flux[4];
+        SIMD(mask) unphysical;
+
+        int i, j, k, t, q, l, lr, side, width, offset, contiguous;
+        double *row;
+
+        // the short last tile repeats its last side
+        for (t = 0; t < GEMM_TILE; t++) {
+            idx[t] = side_at((t < sides) ? tile + t : tile + sides - 1);
+        }
+
+        memset(count, 0, sizeof(count));
+        for (t = 0; t < sides; t++) {
+            base[0][t] = coeff_base(left_idx_list[idx[t]],  n_p);
+            base[1][t] = coeff_base(right_idx_list[idx[t]], n_p);
+
+            side = left_side_list[idx[t]];
+            bucket[0][side][count[0][side]++] = t;
+            side = right_side_list[idx[t]];
+            bucket[1][side][count[1][side]++] = t;
+        }
+
+        for (lr = 0; lr < 2; lr++) {
+            for (side = 0; side < 3; side++) {
+                if (!count[lr][side]) {
+                    continue;
+                }
+                width = (count[lr][side] + LANES - 1) / LANES * LANES;
+
+                for (i = 0; i < n_p; i++) {
+                    for (k = 0; k < 4; k++) {
+                        for (q = 0; q < width; q++) {
+                            packed[(i * 4 + k) * width + q] = (q < count[lr][side])
+                                ? c[base[lr][bucket[lr][side][q]] + (k * n_p + i) * elem_block]
+                                : 0.;
+                        }
+                    }
+                }
+
+                SIMD(gemm)(n_quad1d, 4 * width, n_p, trace[lr][side],
+                           packed, 4 * width, product, 4 * width);
+
+                for (j = 0; j < n_quad1d; j++) {
+                    for (k = 0; k < 4; k++) {
+                        for (q = 0; q < count[lr][side]; q++) {
+                            traces[lr][j][k][bucket[lr][side][q]] = product[(j * 4 + k) * width + q];
+                        }
+                    }
+                }
+            }
+        }
+
+        for (lr = 0; lr < 2; lr++) {
+            for (j = 0; j < n_quad1d; j++) {
+                for (k = 0; k < 4; k++) {
+                    for (t = sides; t < GEMM_TILE; t++) {
+                        traces[lr][j][k][t] = traces[lr][j][k][sides - 1];
+                    }
+                }
+            }
+        }
+
+        unphysical = (SIMD(mask)) {0};
+        for (t = 0; t < GEMM_TILE; t += LANES) {
+            contiguous = !d_side_list && t + LANES <= sides;
+            nx = SIMD(load)(Nx, idx + t, contiguous, 0);
+            ny = SIMD(load)(Ny, idx + t, contiguous, 0);
+
+            for (j = 0; j < n_quad1d; j++) {
+                SIMD(vec) left[4]  = {*(SIMD(vec) *) &traces[0][j][0][t],
+                                      *(SIMD(vec) *) &traces[0][j][1][t],
+                                      *(SIMD(vec) *) &traces[0][j][2][t],
+                                      *(SIMD(vec) *) &traces[0][j][3][t]};
+                SIMD(vec) right[4] = {*(SIMD(vec) *) &traces[1][j][0][t],
+                                      *(SIMD(vec) *) &traces[1][j][1][t],
+                                      *(SIMD(vec) *) &traces[1][j][2][t],
+                                      *(SIMD(vec) *) &traces[1][j][3][t]};
+
+                unphysical |= SIMD(riemann_flux)(left, right, nx, ny, flux);
+
+                for (k = 0; k < 4; k++) {
+                    *(SIMD(vec) *) &s[j][k][t] = w_oned[j] * flux[k];
+                }
+            }
+        }
+
+        for (l = 0; l < LANES; l++) {
+            if (unphysical[l]) {
+                break;
+            }
+        }
+        if (l < LANES) {
+            eval_surface_interior_share(c, rhs, length,
+                                        left_idx_list, right_idx_list,
+                                        left_side_list, right_side_list,
+                                        Nx, Ny, n_quad1d, n_p, num_sides, num_elem,
+                                        tile, tile + sides);
+            continue;
+        }
+
+        for (lr = 0; lr < 2; lr++) {
+            for (side = 0; side < 3; side++) {
+                if (!count[lr][side]) {
+                    continue;
+                }
+                width = (count[lr][side] + LANES - 1) / LANES * LANES;
+
+                for (j = 0; j < n_quad1d; j++) {
+                    for (k = 0; k < 4; k++) {
+                        for (q = 0; q < width; q++) {
+                            packed[(j * 4 + k) * width + q] = (q < count[lr][side])
+                                ? s[j][k][bucket[lr][side][q]]
+                                : 0.;
+                        }
+                    }
+                }
+
+                SIMD(gemm)(n_p, 4 * width, n_quad1d, lift[lr][side],
+                           packed, 4 * width, product, 4 * width);
+
+                // add this side's contribution to both elements, a row of
+                // the product at a time
+                for (i = 0; i < n_p; i++) {
+                    for (k = 0; k < 4; k++) {
+                        row    = product + (i * 4 + k) * width;
+                        offset = (k * n_p + i) * elem_block;
+                        for (q = 0; q < count[lr][side]; q++) {
+                            t = bucket[lr][side][q];
+                            if (lr) {
+                                rhs[base[1][t] + offset] += length[idx[t]] / 2. * row[q];
+                            } else {
+                                rhs[base[0][t] + offset] -= length[idx[t]] / 2. * row[q];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SIMD(eval_surface_interior_gemm)(double *c, double *rhs,
+                                      double *length,
+                                      int *left_idx_list,  int *right_idx_list,
+                                      int *left_side_list, int *right_side_list,
+                                      double *Nx, double *Ny,
+                                      int n_quad1d, int n_p, int num_sides, int num_elem,
+                                      int start, int end) {
+    TEAM_RUN(start, end, GEMM_TILE,
+             SIMD(eval_surface_interior_gemm_share)(c, rhs,
+                                                    length,
+                                                    left_idx_list, right_idx_list,
+                                                    left_side_list, right_side_list,
+                                                    Nx, Ny,
+                                                    n_quad1d, n_p, num_sides, num_elem,
+                                                    first, last));
+}
+
+/* surface integrals
+ *
+ * eval_surface with the interior sides done by eval_surface_interior_gemm.
+ * the boundary sides are left to eval_surface_boundary.
+ */
+__attribute__((target(SIMD_TARGET)))
+void SIMD(eval_surface_gemm)(double *c, double *rhs,
+                             double *length,
+                             double *V1x, double *V1y,
+                             double *V2x, double *V2y,
+                             double *V3x, double *V3y,
+                             int *left_idx_list,  int *right_idx_list,
+                             int *left_side_list, int *right_side_list,
+                             double *Nx, double *Ny,
+                             int n_quad1d, int n_quad, int n_p, int num_sides,
+                             int num_elem, double t) {
+    int j, k;
+
+    for (j = 0; j < num_colors[0]; j++) {
+        SIMD(eval_surface_interior_gemm)(c, rhs,
+                                         length,
+                                         left_idx_list, right_idx_list,
+                                         left_side_list, right_side_list,
+                                         Nx, Ny,
+                                         n_quad1d, n_p, num_sides, num_elem,
+                                         color_ranges[0][j], color_end(0, j));
+    }
+
+    // reflecting, outflow, inflow
+    for (k = 1; k < 4; k++) {
+        for (j = 0; j < num_colors[k]; j++) {
+            eval_surface_boundary(c, rhs,
+                                  length,
+                                  V1x, V1y, V2x, V2y, V3x, V3y,
+                                  left_idx_list,
+                                  left_side_list, right_side_list,
+                                  Nx, Ny,
+                                  n_quad1d, n_p, num_sides, num_elem,
+                                  color_ranges[k][j], color_end(k, j), -k, t);
+        }
+    }
+}
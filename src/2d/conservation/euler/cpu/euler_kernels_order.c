@@ -0,0 +1,435 @@
+/* euler_kernels_order.c
+ *
+ * the surface and volume kernels specialized for one order of
+ * approximation. euler_kernels.c includes this file once for each n with
+ * these defined:
+ *
+ *      ORDER  n
+ *      NP     n_p      = (n + 1) * (n + 2) / 2
+ *      NQ     n_quad
+ *      NQ1D   n_quad1d
+ *
+ * so every trip count is a constant and the compiler can unroll the loops
+ * and keep the coefficients in registers. the functions are named
+ * eval_surface_n and eval_volume_n and take the same
+ * arguments as the generic kernels (the sizes they are passed are ignored),
+ * so dispatch_functions can hand out either. they do the same arithmetic in
+ * the same order as the generic kernels. they are only picked for the
+ * scalar loop kernels, though: on a cpu with avx2 or avx-512 the vector
+ * kernels replace them unless the run asks for -V scalar.
+ *
+ * they read the basis from this order's tables in basis_tables.h, which hold
+ * what preval_basis fills in for set_quadrature's rule, rather than from the
+ * globals. their addresses are constants then, and the compiler knows the
+ * stores to rhs can't change them, so it doesn't reload them every time.
+ */
+
+#ifndef ORDERED
+#define ORDERED(name)        ORDERED_PASTE(name, ORDER)
+#define ORDERED_PASTE(a, b)  ORDERED_PASTE_(a, b)
+#define ORDERED_PASTE_(a, b) a ## _ ## b
+
+// gen_basis_tables is built without basis_tables.h, since it writes it
+#ifdef BASIS_TABLES_GEN
+#define ORDER_TABLE(name)    name
+#else
+#define ORDER_TABLE(name)    ORDERED(name)
+#endif
+#endif
+
+/* interior surface integrals
+ *
+ * eval_surface_interior for this order.
+ */
+void ORDERED(eval_surface_interior_share)(double *c, double *rhs,
+                                          double *length,
+                                          int *left_idx_list,  int *right_idx_list,
+                                          int *left_side_list, int *right_side_list,
+                                          double *Nx, double *Ny,
+                                          int start, int end) {
+    int pos;
+
+    for (pos = start; pos < end; pos++) {
+        int idx       = side_at(pos);
+        int left_idx  = left_idx_list[idx];
+        int left_side = left_side_list[idx];
+        int left_base = coeff_base(left_idx, NP);
+
+        int right_idx  = right_idx_list[idx];
+        int right_side = right_side_list[idx];
+        int right_base = coeff_base(right_idx, NP);
+
+        double nx  = Nx[idx];
+        double ny  = Ny[idx];
+        double len = length[idx];
+
+        double c_left[4][NP], c_right[4][NP];
+        double s[NQ1D][4];
+
+        int i, j, k;
+        const double *left_basis, *right_basis;
+        double left_sum[4], right_sum[4];
+        double rho_left, u_left, v_left, E_left;
+        double rho_right, u_right, v_right, E_right;
+
+        for (k = 0; k < 4; k++) {
+            for (i = 0; i < NP; i++) {
+                c_left[k][i]  = c[left_base  + (k * NP + i) * elem_block];
+                c_right[k][i] = c[right_base + (k * NP + i) * elem_block];
+            }
+        }
+
+        for (j = 0; j < NQ1D; j++) {
+            left_basis  = ORDER_TABLE(basis_side) + left_side  * NP * NQ1D + j;
+            right_basis = ORDER_TABLE(basis_side) + right_side * NP * NQ1D + NQ1D - 1 - j;
+
+            rho_left  = 0.;
+            u_left    = 0.;
+            v_left    = 0.;
+            E_left    = 0.;
+            rho_right = 0.;
+            u_right   = 0.;
+            v_right   = 0.;
+            E_right   = 0.;
+            for (i = 0; i < NP; i++) {
+                rho_left  += c_left[0][i]  * left_basis[i * NQ1D];
+                u_left    += c_left[1][i]  * left_basis[i * NQ1D];
+                v_left    += c_left[2][i]  * left_basis[i * NQ1D];
+                E_left    += c_left[3][i]  * left_basis[i * NQ1D];
+                rho_right += c_right[0][i] * right_basis[i * NQ1D];
+                u_right   += c_right[1][i] * right_basis[i * NQ1D];
+                v_right   += c_right[2][i] * right_basis[i * NQ1D];
+                E_right   += c_right[3][i] * right_basis[i * NQ1D];
+            }
+
+            if (rho_left <= 0.) {
+                printf("%lf rho unphysical.\n", rho_left);
+                exit(0);
+            }
+            if (E_left <= 0) {
+                printf("%lf E unphysical.\n", E_left);
+                exit(0);
+            }
+
+            u_left  = u_left  / rho_left;
+            v_left  = v_left  / rho_left;
+            u_right = u_right / rho_right;
+            v_right = v_right / rho_right;
+
+            eval_riemann_flux(rho_left,  u_left,  v_left,  E_left,
+                              rho_right, u_right, v_right, E_right,
+                              nx, ny, left_side, right_side, idx, s[j]);
+
+            for (k = 0; k < 4; k++) {
+                s[j][k] = ORDER_TABLE(w_oned)[j] * s[j][k];
+            }
+        }
+
+        for (i = 0; i < NP; i++) {
+            left_basis  = ORDER_TABLE(basis_side) + left_side  * NP * NQ1D + i * NQ1D;
+            right_basis = ORDER_TABLE(basis_side) + right_side * NP * NQ1D + i * NQ1D + NQ1D - 1;
+
+            for (k = 0; k < 4; k++) {
+                left_sum[k]  = 0.;
+                right_sum[k] = 0.;
+            }
+            for (j = 0; j < NQ1D; j++) {
+                for (k = 0; k < 4; k++) {
+                    left_sum[k]  += s[j][k] * left_basis[j];
+                    right_sum[k] += s[j][k] * right_basis[-j];
+                }
+            }
+
+            for (k = 0; k < 4; k++) {
+                rhs[left_base  + (k * NP + i) * elem_block] -= len / 2. * left_sum[k];
+                rhs[right_base + (k * NP + i) * elem_block] += len / 2. * right_sum[k];
+            }
+        }
+    }
+}
+
+void ORDERED(eval_surface_interior)(double *c, double *rhs,
+                                    double *length,
+                                    int *left_idx_list,  int *right_idx_list,
+                                    int *left_side_list, int *right_side_list,
+                                    double *Nx, double *Ny,
+                                    int start, int end) {
+    TEAM_RUN(start, end, 1,
+             ORDERED(eval_surface_interior_share)(c, rhs,
+                                                  length,
+                                                  left_idx_list, right_idx_list,
+                                                  left_side_list, right_side_list,
+                                                  Nx, Ny,
+                                                  first, last));
+}
+
+/* boundary surface integrals
+ *
+ * eval_surface_boundary for this order.
+ */
+void ORDERED(eval_surface_boundary_share)(double *c, double *rhs,
+                                          double *length,
+                                          double *V1x, double *V1y,
+                                          double *V2x, double *V2y,
+                                          double *V3x, double *V3y,
+                                          int *left_idx_list,
+                                          int *left_side_list, int *right_side_list,
+                                          double *Nx, double *Ny,
+                                          int start, int end, int boundary, double t) {
+    int pos;
+
+    for (pos = start; pos < end; pos++) {
+        int idx        = side_at(pos);
+        int left_idx   = left_idx_list[idx];
+        int left_side  = left_side_list[idx];
+        int left_base  = coeff_base(left_idx, NP);
+        int right_side = right_side_list[idx];
+
+        double nx  = Nx[idx];
+        double ny  = Ny[idx];
+        double len = length[idx];
+
+        double c_left[4][NP];
+        double s[NQ1D][4];
+
+        int i, j, k;
+        const double *left_basis;
+        double left_sum[4];
+        double rho_left, u_left, v_left, E_left;
+        double rho_right, u_right, v_right, E_right;
+
+        for (k = 0; k < 4; k++) {
+            for (i = 0; i < NP; i++) {
+                c_left[k][i] = c[left_base + (k * NP + i) * elem_block];
+            }
+        }
+
+        for (j = 0; j < NQ1D; j++) {
+            left_basis = ORDER_TABLE(basis_side) + left_side * NP * NQ1D + j;
+
+            rho_left = 0.;
+            u_left   = 0.;
+            v_left   = 0.;
+            E_left   = 0.;
+            for (i = 0; i < NP; i++) {
+                rho_left += c_left[0][i] * left_basis[i * NQ1D];
+                u_left   += c_left[1][i] * left_basis[i * NQ1D];
+                v_left   += c_left[2][i] * left_basis[i * NQ1D];
+                E_left   += c_left[3][i] * left_basis[i * NQ1D];
+            }
+
+            if (rho_left <= 0.) {
+                printf("%lf rho unphysical.\n", rho_left);
+                exit(0);
+            }
+            if (E_left <= 0) {
+                printf("%lf E unphysical.\n", E_left);
+                exit(0);
+            }
+
+            u_left = u_left / rho_left;
+            v_left = v_left / rho_left;
+
+            eval_boundary(rho_left, &rho_right,
+                          u_left,   &u_right,
+                          v_left,   &v_right,
+                          E_left,   &E_right,
+                          nx, ny,
+                          V1x[left_idx], V1y[left_idx],
+                          V2x[left_idx], V2y[left_idx],
+                          V3x[left_idx], V3y[left_idx],
+                          j, left_side, boundary, NQ1D, t);
+
+            eval_riemann_flux(rho_left,  u_left,  v_left,  E_left,
+                              rho_right, u_right, v_right, E_right,
+                              nx, ny, left_side, right_side, idx, s[j]);
+
+            for (k = 0; k < 4; k++) {
+                s[j][k] = ORDER_TABLE(w_oned)[j] * s[j][k];
+            }
+        }
+
+        for (i = 0; i < NP; i++) {
+            left_basis = ORDER_TABLE(basis_side) + left_side * NP * NQ1D + i * NQ1D;
+
+            for (k = 0; k < 4; k++) {
+                left_sum[k] = 0.;
+            }
+            for (j = 0; j < NQ1D; j++) {
+                for (k = 0; k < 4; k++) {
+                    left_sum[k] += s[j][k] * left_basis[j];
+                }
+            }
+
+            for (k = 0; k < 4; k++) {
+                rhs[left_base + (k * NP + i) * elem_block] -= len / 2. * left_sum[k];
+            }
+        }
+    }
+}
+
+void ORDERED(eval_surface_boundary)(double *c, double *rhs,
+                                    double *length,
+                                    double *V1x, double *V1y,
+                                    double *V2x, double *V2y,
+                                    double *V3x, double *V3y,
+                                    int *left_idx_list,
+                                    int *left_side_list, int *right_side_list,
+                                    double *Nx, double *Ny,
+                                    int start, int end, int boundary, double t) {
+    TEAM_RUN(start, end, 1,
+             ORDERED(eval_surface_boundary_share)(c, rhs,
+                                                  length,
+                                                  V1x, V1y,
+                                                  V2x, V2y,
+                                                  V3x, V3y,
+                                                  left_idx_list,
+                                                  left_side_list, right_side_list,
+                                                  Nx, Ny,
+                                                  first, last, boundary, t));
+}
+
+/* surface integrals
+ *
+ * eval_surface for this order.
+ */
+void ORDERED(eval_surface)(double *c, double *rhs,
+                           double *length,
+                           double *V1x, double *V1y,
+                           double *V2x, double *V2y,
+                           double *V3x, double *V3y,
+                           int *left_idx_list,  int *right_idx_list,
+                           int *left_side_list, int *right_side_list,
+                           double *Nx, double *Ny,
+                           int n_quad1d, int n_quad, int n_p, int num_sides,
+                           int num_elem, double t) {
+    int j, k;
+
+    for (j = 0; j < num_colors[0]; j++) {
+        ORDERED(eval_surface_interior)(c, rhs,
+                                       length,
+                                       left_idx_list, right_idx_list,
+                                       left_side_list, right_side_list,
+                                       Nx, Ny,
+                                       color_ranges[0][j], color_end(0, j));
+    }
+
+    for (k = 1; k < 4; k++) {
+        for (j = 0; j < num_colors[k]; j++) {
+            ORDERED(eval_surface_boundary)(c, rhs,
+                                           length,
+                                           V1x, V1y, V2x, V2y, V3x, V3y,
+                                           left_idx_list,
+                                           left_side_list, right_side_list,
+                                           Nx, Ny,
+                                           color_ranges[k][j], color_end(k, j), -k, t);
+        }
+    }
+}
+
+/* volume integrals
+ *
+ * eval_volume for this order.
+ */
+void ORDERED(eval_volume_share)(double *c,
+                                double *quad_rhs,
+                                double *X_r, double *Y_r, double *X_s, double *Y_s,
+                                int n_quad, int n_p, int num_elem,
+                                int first, int last) {
+    int pos;
+
+    for (pos = first; pos < last; pos++) {
+        int idx  = elem_at(pos);
+        int base = coeff_base(idx, NP);
+
+        double x_r = X_r[idx];
+        double y_r = Y_r[idx];
+        double x_s = X_s[idx];
+        double y_s = Y_s[idx];
+
+        double c_elem[4][NP];
+        double flux_x[4], flux_y[4];
+        double flux_r[NQ][4], flux_s[NQ][4];
+
+        int i, j, k;
+        double rho, u, v, E;
+        double sum1, sum2, sum3, sum4;
+        const double *grad_x, *grad_y;
+
+        for (k = 0; k < 4; k++) {
+            for (i = 0; i < NP; i++) {
+                c_elem[k][i] = c[base + (k * NP + i) * elem_block];
+            }
+        }
+
+        for (j = 0; j < NQ; j++) {
+            rho = 0.;
+            u   = 0.;
+            v   = 0.;
+            E   = 0.;
+            for (i = 0; i < NP; i++) {
+                rho += c_elem[0][i] * ORDER_TABLE(basis)[NQ * i + j];
+                u   += c_elem[1][i] * ORDER_TABLE(basis)[NQ * i + j];
+                v   += c_elem[2][i] * ORDER_TABLE(basis)[NQ * i + j];
+                E   += c_elem[3][i] * ORDER_TABLE(basis)[NQ * i + j];
+            }
+
+            if (rho <= 0) {
+                printf("rho unphysical in volume\n");
+                exit(0);
+            }
+            if (E <= 0) {
+                printf("E unphysical in volume\n");
+                exit(0);
+            }
+
+            u = u / rho;
+            v = v / rho;
+
+            eval_flux(rho, u, v, E, flux_x, flux_y, 1000, idx);
+
+            for (k = 0; k < 4; k++) {
+                flux_r[j][k] =  flux_x[k] * y_s - flux_y[k] * x_s;
+                flux_s[j][k] = -flux_x[k] * y_r + flux_y[k] * x_r;
+            }
+        }
+
+        for (i = 0; i < NP; i++) {
+            grad_x = ORDER_TABLE(basis_grad_x) + NQ * i;
+            grad_y = ORDER_TABLE(basis_grad_y) + NQ * i;
+
+            sum1 = 0.;
+            sum2 = 0.;
+            sum3 = 0.;
+            sum4 = 0.;
+            for (j = 0; j < NQ; j++) {
+                sum1 += flux_r[j][0] * grad_x[j] + flux_s[j][0] * grad_y[j];
+                sum2 += flux_r[j][1] * grad_x[j] + flux_s[j][1] * grad_y[j];
+                sum3 += flux_r[j][2] * grad_x[j] + flux_s[j][2] * grad_y[j];
+                sum4 += flux_r[j][3] * grad_x[j] + flux_s[j][3] * grad_y[j];
+            }
+
+            quad_rhs[base + (0 * NP + i) * elem_block] = sum1;
+            quad_rhs[base + (1 * NP + i) * elem_block] = sum2;
+            quad_rhs[base + (2 * NP + i) * elem_block] = sum3;
+            quad_rhs[base + (3 * NP + i) * elem_block] = sum4;
+        }
+    }
+}
+
+void ORDERED(eval_volume)(double *c,
+                          double *quad_rhs,
+                          double *X_r, double *Y_r, double *X_s, double *Y_s,
+                          int n_quad, int n_p, int num_elem) {
+    TEAM_RUN(0, num_elem, 1,
+             ORDERED(eval_volume_share)(c,
+                                        quad_rhs,
+                                        X_r, Y_r, X_s, Y_s,
+                                        n_quad, n_p, num_elem,
+                                        first, last));
+}
+
+#undef ORDER
+#undef NP
+#undef NQ
+#undef NQ1D
@@ -0,0 +1,638 @@
+/* euler_kernels_simd.c
+ *
+ * kernels that work on LANES elements or sides at a time, one in each lane
+ * of a vector, for one vector instruction set. euler_kernels.c includes this
+ * file once for each with these defined:
+ *
+ *      LANES        doubles per vector
+ *      SIMD_ISA     suffix of the function names, e.g. avx2
+ *      SIMD_TARGET  the target attribute they're compiled with
+ *
+ * the functions are compiled for their instruction set whatever flags the
+ * rest of the build uses; dispatch_functions only hands them out if the cpu
+ * has it (see vector_isa). both coefficient layouts keep the same mode of
+ * consecutive elements next to each other, so a group of LANES elements
+ * starting at a multiple of LANES is one vector load per coefficient. groups
+ * that aren't, the last one and the ones d_elem_list picks, are gathered a
+ * lane at a time, as are the elements on either side of a group of sides.
+ */
+
+#ifndef SIMD
+#define SIMD(name)        SIMD_PASTE(name, SIMD_ISA)
+#define SIMD_PASTE(a, b)  SIMD_PASTE_(a, b)
+#define SIMD_PASTE_(a, b) a ## _ ## b
+#endif
+
+// only aligned to a double, so they can be loaded from anywhere
+typedef double SIMD(vec) __attribute__((vector_size(LANES * sizeof(double)), aligned(sizeof(double))));
+typedef long   SIMD(mask) __attribute__((vector_size(LANES * sizeof(long)), aligned(sizeof(long))));
+typedef float  SIMD(fvec) __attribute__((vector_size(LANES * sizeof(float))));
+
+/* load, store
+ *
+ * a[base[l] + offset] for each lane l of a group, which is a single vector
+ * load or store if the group is contiguous. store only writes the first
+ * lanes lanes.
+ */
+__attribute__((target(SIMD_TARGET), always_inline))
+static inline SIMD(vec) SIMD(load)(double *a, int *base, int contiguous, int offset) {
+    SIMD(vec) x = {0.};
+    int l;
+
+    if (contiguous) {
+        return *(SIMD(vec) *) (a + base[0] + offset);
+    }
+    for (l = 0; l < LANES; l++) {
+        x[l] = a[base[l] + offset];
+    }
+    return x;
+}
+
+__attribute__((target(SIMD_TARGET), always_inline))
+static inline void SIMD(store)(double *a, int *base, int contiguous, int lanes, int offset,
+                               SIMD(vec) x) {
+    int l;
+
+    if (contiguous) {
+        *(SIMD(vec) *) (a + base[0] + offset) = x;
+        return;
+    }
+    for (l = 0; l < lanes; l++) {
+        a[base[l] + offset] = x[l];
+    }
+}
+
+/* scatter add
+ *
+ * a[base[l] + offset] += x[l] for the first lanes lanes of a group.
+ */
+__attribute__((target(SIMD_TARGET), always_inline))
+static inline void SIMD(scatter_add)(double *a, int *base, int lanes, int offset, SIMD(vec) x) {
+    int l;
+
+    for (l = 0; l < lanes; l++) {
+        a[base[l] + offset] += x[l];
+    }
+}
+
+/* blend
+ *
+ * a in the lanes where m is set, b in the others.
+ */
+__attribute__((target(SIMD_TARGET), always_inline))
+static inline SIMD(vec) SIMD(blend)(SIMD(mask) m, SIMD(vec) a, SIMD(vec) b) {
+    return (SIMD(vec)) ((m & (SIMD(mask)) a) | (~m & (SIMD(mask)) b));
+}
+
+/* speed of sound
+ *
+ * eval_c for every lane, which like eval_c takes the square root in single
+ * precision: one vector square root of the lanes converted to float. the
+ * square root is correctly rounded, so this matches eval_c exactly.
+ */
+__attribute__((target(SIMD_TARGET), always_inline))
+static inline SIMD(vec) SIMD(sound_speed)(SIMD(vec) rho, SIMD(vec) p) {
+    SIMD(fvec) x = __builtin_convertvector(GAMMA * p / rho, SIMD(fvec));
+
+#if LANES == 4
+    x = (SIMD(fvec)) _mm_sqrt_ps((__m128) x);
+#else
+    x = (SIMD(fvec)) _mm256_sqrt_ps((__m256) x);
+#endif
+    return __builtin_convertvector(x, SIMD(vec));
+}
+
+/* volume flux
+ *
+ * the flux at one integration point of each lane from the interpolated
+ * rho, rho * u, rho * v, E, mapped to the canonical element like
+ * eval_volume_elem does. returns the lanes whose state is unphysical.
+ */
+__attribute__((target(SIMD_TARGET), always_inline))
+static inline SIMD(mask) SIMD(volume_flux)(SIMD(vec) rho, SIMD(vec) u, SIMD(vec) v, SIMD(vec) E,
+                                           SIMD(vec) x_r, SIMD(vec) y_r,
+                                           SIMD(vec) x_s, SIMD(vec) y_s,
+                                           SIMD(vec) *flux_r, SIMD(vec) *flux_s) {
+    SIMD(vec) p, flux_x[4], flux_y[4];
+    int k;
+
+    u = u / rho;
+    v = v / rho;
+    p = (GAMMA - 1.) * (E - (u*u + v*v) / 2. * rho);
+
+    flux_x[0] = rho * u;
+    flux_y[0] = rho * v;
+    flux_x[1] = rho * u * u + p;
+    flux_y[1] = rho * u * v;
+    flux_x[2] = rho * u * v;
+    flux_y[2] = rho * v * v + p;
+    flux_x[3] = u * (E + p);
+    flux_y[3] = v * (E + p);
+
+    for (k = 0; k < 4; k++) {
+        flux_r[k] =  flux_x[k] * y_s - flux_y[k] * x_s;
+        flux_s[k] = -flux_x[k] * y_r + flux_y[k] * x_r;
+    }
+
+    return (rho <= 0.) | (E <= 0.) | (p < 0.);
+}
+
+/* riemann flux
+ *
+ * eval_riemann_flux for each lane, from the interpolated rho, rho * u,
+ * rho * v, E on both sides. the branches eval_lambda takes on the sign of
+ * the normal speed and the larger of the two speeds are blends. returns the
+ * lanes with an unphysical trace.
+ */
+__attribute__((target(SIMD_TARGET), always_inline))
+static inline SIMD(mask) SIMD(riemann_flux)(SIMD(vec) *left, SIMD(vec) *right,
+                                            SIMD(vec) nx, SIMD(vec) ny, SIMD(vec) *s) {
+    SIMD(vec) rho_left,  u_left,  v_left,  E_left,  p_left;
+    SIMD(vec) rho_right, u_right, v_right, E_right, p_right;
+    SIMD(vec) flux_x_l[4], flux_y_l[4], flux_x_r[4], flux_y_r[4], jump[4];
+    SIMD(vec) s_left, s_right, left_max, right_max, lambda;
+    int k;
+
+    rho_left  = left[0];
+    u_left    = left[1]  / rho_left;
+    v_left    = left[2]  / rho_left;
+    E_left    = left[3];
+    rho_right = right[0];
+    u_right   = right[1] / rho_right;
+    v_right   = right[2] / rho_right;
+    E_right   = right[3];
+
+    p_left  = (GAMMA - 1.) * (E_left  - (u_left*u_left   + v_left*v_left)   / 2. * rho_left);
+    p_right = (GAMMA - 1.) * (E_right - (u_right*u_right + v_right*v_right) / 2. * rho_right);
+
+    flux_x_l[0] = rho_left * u_left;
+    flux_y_l[0] = rho_left * v_left;
+    flux_x_l[1] = rho_left * u_left * u_left + p_left;
+    flux_y_l[1] = rho_left * u_left * v_left;
+    flux_x_l[2] = rho_left * u_left * v_left;
+    flux_y_l[2] = rho_left * v_left * v_left + p_left;
+    flux_x_l[3] = u_left * (E_left + p_left);
+    flux_y_l[3] = v_left * (E_left + p_left);
+
+    flux_x_r[0] = rho_right * u_right;
+    flux_y_r[0] = rho_right * v_right;
+    flux_x_r[1] = rho_right * u_right * u_right + p_right;
+    flux_y_r[1] = rho_right * u_right * v_right;
+    flux_x_r[2] = rho_right * u_right * v_right;
+    flux_y_r[2] = rho_right * v_right * v_right + p_right;
+    flux_x_r[3] = u_right * (E_right + p_right);
+    flux_y_r[3] = v_right * (E_right + p_right);
+
+    // the larger of | s +- c | on the two sides
+    s_left    = nx * u_left  + ny * v_left;
+    s_right   = nx * u_right + ny * v_right;
+    left_max  = SIMD(blend)(s_left  > 0., s_left,  -s_left)  + SIMD(sound_speed)(rho_left,  p_left);
+    right_max = SIMD(blend)(s_right > 0., s_right, -s_right) + SIMD(sound_speed)(rho_right, p_right);
+    left_max  = SIMD(blend)(left_max  < 0., -left_max,  left_max);
+    right_max = SIMD(blend)(right_max < 0., -right_max, right_max);
+    lambda    = SIMD(blend)(left_max > right_max, left_max, right_max);
+
+    jump[0] = rho_left - rho_right;
+    jump[1] = u_left * rho_left - u_right * rho_right;
+    jump[2] = v_left * rho_left - v_right * rho_right;
+    jump[3] = E_left - E_right;
+
+    for (k = 0; k < 4; k++) {
+        s[k] = 0.5 * ((flux_x_l[k] + flux_x_r[k]) * nx + (flux_y_l[k] + flux_y_r[k]) * ny
+                      + lambda * jump[k]);
+    }
+
+    return (rho_left <= 0.) | (E_left <= 0.) | (p_left < 0.) | (p_right < 0.);
+}
+
+/* volume integrals
+ *
+ * eval_volume for LANES elements at a time. the interpolation to the
+ * integration points, the flux and the projection onto the basis gradients
+ * are the same arithmetic as eval_volume_elem, but on whole vectors, and
+ * the checks for unphysical states are folded into a mask. if any lane of
+ * a group trips it, the group is redone by eval_volume_elem, which reports
+ * it and stops like the scalar kernels do.
+ * THREADS: num_elem / LANES
+ */
+__attribute__((target(SIMD_TARGET)))
+void SIMD(eval_volume_share)(double *c,
+                             double *quad_rhs,
+                             double *X_r, double *Y_r, double *X_s, double *Y_s,
+                             int n_quad, int n_p, int num_elem,
+                             int first, int last) {
+    int group;
+
+    for (group = first; group < last; group += LANES) {
+        int lanes      = (group + LANES < num_elem) ? LANES : num_elem - group;
+        int contiguous = !d_elem_list && lanes == LANES;
+        int idx[LANES], base[LANES];
+
+        SIMD(vec) x_r, y_r, x_s, y_s;
+        SIMD(vec) c_elem[4][n_p];
+        SIMD(vec) flux_r[n_quad][4], flux_s[n_quad][4];
+        SIMD(vec) rho, u, v, E, b, grad_x, grad_y, sum[4];
+        SIMD(mask) unphysical;
+
+        int i, j, k, l;
+
+        // the short last group repeats its last element in the spare lanes
+        for (l = 0; l < LANES; l++) {
+            idx[l]  = elem_at((l < lanes) ? group + l : group + lanes - 1);
+            base[l] = coeff_base(idx[l], n_p);
+        }
+
+        x_r = SIMD(load)(X_r, idx, contiguous, 0);
+        y_r = SIMD(load)(Y_r, idx, contiguous, 0);
+        x_s = SIMD(load)(X_s, idx, contiguous, 0);
+        y_s = SIMD(load)(Y_s, idx, contiguous, 0);
+
+        for (k = 0; k < 4; k++) {
+            for (i = 0; i < n_p; i++) {
+                c_elem[k][i] = SIMD(load)(c, base, contiguous, (k * n_p + i) * elem_block);
+            }
+        }
+
+        unphysical = (SIMD(mask)) {0};
+        for (j = 0; j < n_quad; j++) {
+            rho = u = v = E = (SIMD(vec)) {0.};
+            for (i = 0; i < n_p; i++) {
+                b    = (SIMD(vec)) {0.} + basis[n_quad * i + j];
+                rho += c_elem[0][i] * b;
+                u   += c_elem[1][i] * b;
+                v   += c_elem[2][i] * b;
+                E   += c_elem[3][i] * b;
+            }
+
+            unphysical |= SIMD(volume_flux)(rho, u, v, E, x_r, y_r, x_s, y_s,
+                                             flux_r[j], flux_s[j]);
+        }
+
+        for (l = 0; l < LANES; l++) {
+            if (unphysical[l]) {
+                break;
+            }
+        }
+        if (l < LANES) {
+            for (l = 0; l < lanes; l++) {
+                eval_volume_elem(c, quad_rhs, X_r, Y_r, X_s, Y_s, n_quad, n_p, idx[l]);
+            }
+            continue;
+        }
+
+        for (i = 0; i < n_p; i++) {
+            sum[0] = sum[1] = sum[2] = sum[3] = (SIMD(vec)) {0.};
+            for (j = 0; j < n_quad; j++) {
+                grad_x = (SIMD(vec)) {0.} + basis_grad_x[n_quad * i + j];
+                grad_y = (SIMD(vec)) {0.} + basis_grad_y[n_quad * i + j];
+                for (k = 0; k < 4; k++) {
+                    sum[k] += flux_r[j][k] * grad_x + flux_s[j][k] * grad_y;
+                }
+            }
+
+            for (k = 0; k < 4; k++) {
+                SIMD(store)(quad_rhs, base, contiguous, lanes, (k * n_p + i) * elem_block, sum[k]);
+            }
+        }
+    }
+}
+
+void SIMD(eval_volume)(double *c,
+                       double *quad_rhs,
+                       double *X_r, double *Y_r, double *X_s, double *Y_s,
+                       int n_quad, int n_p, int num_elem) {
+    TEAM_RUN(0, num_elem, LANES,
+             SIMD(eval_volume_share)(c,
+                                     quad_rhs,
+                                     X_r, Y_r, X_s, Y_s,
+                                     n_quad, n_p, num_elem,
+                                     first, last));
+}
+
+/* interior surface integrals
+ *
+ * eval_surface_interior for LANES sides at a time. each lane's left and
+ * right coefficients and the basis along its side are gathered, so the
+ * traces and riemann_flux at each integration point are whole vectors. the
+ * gathers go into buffers a lane at a time before any of it is loaded as
+ * vectors, so the loads don't wait on the stores they read, and the basis is
+ * gathered once for the traces and the projection. the sides are one color,
+ * so the lanes' elements are all different and their contributions can be
+ * scattered into rhs one lane after another. a group with an unphysical
+ * trace goes through eval_surface_interior_share.
+ * THREADS: (end - start) / LANES
+ */
+__attribute__((target(SIMD_TARGET)))
+void SIMD(eval_surface_interior_share)(double *c, double *rhs,
+                                       double *length,
+                                       int *left_idx_list,  int *right_idx_list,
+                                       int *left_side_list, int *right_side_list,
+                                       double *Nx, double *Ny,
+                                       int n_quad1d, int n_p, int num_sides, int num_elem,
+                                       int start, int end) {
+    int group;
+
+    for (group = start; group < end; group += LANES) {
+        int lanes      = (group + LANES < end) ? LANES : end - group;
+        int contiguous = !d_side_list && lanes == LANES;
+        int idx[LANES], left_base[LANES], right_base[LANES];
+        int left_basis[LANES], right_basis[LANES];
+
+        SIMD(vec) nx, ny, half_len;
+        double c_left[4 * n_p][LANES], c_right[4 * n_p][LANES];
+        double basis_left[n_p * n_quad1d][LANES], basis_right[n_p * n_quad1d][LANES];
+        SIMD(vec) s[n_quad1d][4];
+        SIMD(vec) left[4], right[4], left_sum[4], right_sum[4], b_left, b_right;
+        SIMD(mask) unphysical;
+
+        int i, j, k, l;
+
+        // the short last group repeats its last side in the spare lanes
+        for (l = 0; l < LANES; l++) {
+            idx[l]         = side_at((l < lanes) ? group + l : group + lanes - 1);
+            left_base[l]   = coeff_base(left_idx_list[idx[l]], n_p);
+            right_base[l]  = coeff_base(right_idx_list[idx[l]], n_p);
+            left_basis[l]  = left_side_list[idx[l]]  * n_p * n_quad1d;
+            right_basis[l] = right_side_list[idx[l]] * n_p * n_quad1d + n_quad1d - 1;
+        }
+
+        nx       = SIMD(load)(Nx, idx, contiguous, 0);
+        ny       = SIMD(load)(Ny, idx, contiguous, 0);
+        half_len = SIMD(load)(length, idx, contiguous, 0) / 2.;
+
+        for (i = 0; i < 4 * n_p; i++) {
+            for (l = 0; l < LANES; l++) {
+                c_left[i][l]  = c[left_base[l]  + i * elem_block];
+                c_right[i][l] = c[right_base[l] + i * elem_block];
+            }
+        }
+        // the right element's points run backwards along the side
+        for (i = 0; i < n_p; i++) {
+            for (j = 0; j < n_quad1d; j++) {
+                for (l = 0; l < LANES; l++) {
+                    basis_left[i * n_quad1d + j][l]  = basis_side[left_basis[l]  + i * n_quad1d + j];
+                    basis_right[i * n_quad1d + j][l] = basis_side[right_basis[l] + i * n_quad1d - j];
+                }
+            }
+        }
+
+        unphysical = (SIMD(mask)) {0};
+        for (j = 0; j < n_quad1d; j++) {
+            for (k = 0; k < 4; k++) {
+                left[k] = right[k] = (SIMD(vec)) {0.};
+            }
+            for (i = 0; i < n_p; i++) {
+                b_left  = *(SIMD(vec) *) basis_left[i * n_quad1d + j];
+                b_right = *(SIMD(vec) *) basis_right[i * n_quad1d + j];
+                for (k = 0; k < 4; k++) {
+                    left[k]  += *(SIMD(vec) *) c_left[k * n_p + i]  * b_left;
+                    right[k] += *(SIMD(vec) *) c_right[k * n_p + i] * b_right;
+                }
+            }
+
+            unphysical |= SIMD(riemann_flux)(left, right, nx, ny, s[j]);
+
+            for (k = 0; k < 4; k++) {
+                s[j][k] = w_oned[j] * s[j][k];
+            }
+        }
+
+        for (l = 0; l < LANES; l++) {
+            if (unphysical[l]) {
+                break;
+            }
+        }
+        if (l < LANES) {
+            eval_surface_interior_share(c, rhs, length,
+                                        left_idx_list, right_idx_list,
+                                        left_side_list, right_side_list,
+                                        Nx, Ny, n_quad1d, n_p, num_sides, num_elem,
+                                        group, group + lanes);
+            continue;
+        }
+
+        for (i = 0; i < n_p; i++) {
+            for (k = 0; k < 4; k++) {
+                left_sum[k]  = (SIMD(vec)) {0.};
+                right_sum[k] = (SIMD(vec)) {0.};
+            }
+
+            for (j = 0; j < n_quad1d; j++) {
+                b_left  = *(SIMD(vec) *) basis_left[i * n_quad1d + j];
+                b_right = *(SIMD(vec) *) basis_right[i * n_quad1d + j];
+                for (k = 0; k < 4; k++) {
+                    left_sum[k]  += s[j][k] * b_left;
+                    right_sum[k] += s[j][k] * b_right;
+                }
+            }
+
+            for (k = 0; k < 4; k++) {
+                SIMD(scatter_add)(rhs, left_base,  lanes, (k * n_p + i) * elem_block, -(half_len * left_sum[k]));
+                SIMD(scatter_add)(rhs, right_base, lanes, (k * n_p + i) * elem_block,   half_len * right_sum[k]);
+            }
+        }
+    }
+}
+
+void SIMD(eval_surface_interior)(double *c, double *rhs,
+                                 double *length,
+                                 int *left_idx_list,  int *right_idx_list,
+                                 int *left_side_list, int *right_side_list,
+                                 double *Nx, double *Ny,
+                                 int n_quad1d, int n_p, int num_sides, int num_elem,
+                                 int start, int end) {
+    TEAM_RUN(start, end, LANES,
+             SIMD(eval_surface_interior_share)(c, rhs,
+                                               length,
+                                               left_idx_list, right_idx_list,
+                                               left_side_list, right_side_list,
+                                               Nx, Ny,
+                                               n_quad1d, n_p, num_sides, num_elem,
+                                               first, last));
+}
+
+/* surface integrals
+ *
+ * eval_surface with the interior sides done LANES at a time. the boundary
+ * sides are few enough to leave to eval_surface_boundary.
+ */
+__attribute__((target(SIMD_TARGET)))
+void SIMD(eval_surface)(double *c, double *rhs,
+                        double *length,
+                        double *V1x, double *V1y,
+                        double *V2x, double *V2y,
+                        double *V3x, double *V3y,
+                        int *left_idx_list,  int *right_idx_list,
+                        int *left_side_list, int *right_side_list,
+                        double *Nx, double *Ny,
+                        int n_quad1d, int n_quad, int n_p, int num_sides,
+                        int num_elem, double t) {
+    int j, k;
+
+    for (j = 0; j < num_colors[0]; j++) {
+        SIMD(eval_surface_interior)(c, rhs,
+                                    length,
+                                    left_idx_list, right_idx_list,
+                                    left_side_list, right_side_list,
+                                    Nx, Ny,
+                                    n_quad1d, n_p, num_sides, num_elem,
+                                    color_ranges[0][j], color_end(0, j));
+    }
+
+    // reflecting, outflow, inflow
+    for (k = 1; k < 4; k++) {
+        for (j = 0; j < num_colors[k]; j++) {
+            eval_surface_boundary(c, rhs,
+                                  length,
+                                  V1x, V1y, V2x, V2y, V3x, V3y,
+                                  left_idx_list,
+                                  left_side_list, right_side_list,
+                                  Nx, Ny,
+                                  n_quad1d, n_p, num_sides, num_elem,
+                                  color_ranges[k][j], color_end(k, j), -k, t);
+        }
+    }
+}
+
+/* tensor volume integrals
+ *
+ * eval_volume_tensor for LANES elements at a time: the sums factored in
+ * collapsed coordinates like eval_volume_tensor_elem does them, on whole
+ * vectors, with a group that trips the unphysical mask redone by it.
+ * THREADS: num_elem / LANES
+ */
+__attribute__((target(SIMD_TARGET)))
+void SIMD(eval_volume_tensor_share)(double *c,
+                                    double *quad_rhs,
+                                    double *X_r, double *Y_r, double *X_s, double *Y_s,
+                                    int n_quad, int n_p, int num_elem,
+                                    int first, int last) {
+    int q = tensor_q;
+    int group;
+
+    for (group = first; group < last; group += LANES) {
+        int lanes      = (group + LANES < num_elem) ? LANES : num_elem - group;
+        int contiguous = !d_elem_list && lanes == LANES;
+        int idx[LANES], base[LANES];
+
+        SIMD(vec) x_r, y_r, x_s, y_s;
+        SIMD(vec) c_elem[n_p][4];
+        SIMD(vec) u[n_quad][4];
+        SIMD(vec) flux_r[n_quad][4], flux_s[n_quad][4];
+        SIMD(vec) f[q * q][4], g[q * q][4];
+        SIMD(vec) a0, a1, a2, b0, b1, sum[4];
+        SIMD(mask) unphysical;
+
+        int i, j, k, l, m, p, ia, ib;
+
+        // the short last group repeats its last element in the spare lanes
+        for (l = 0; l < LANES; l++) {
+            idx[l]  = elem_at((l < lanes) ? group + l : group + lanes - 1);
+            base[l] = coeff_base(idx[l], n_p);
+        }
+
+        x_r = SIMD(load)(X_r, idx, contiguous, 0);
+        y_r = SIMD(load)(Y_r, idx, contiguous, 0);
+        x_s = SIMD(load)(X_s, idx, contiguous, 0);
+        y_s = SIMD(load)(Y_s, idx, contiguous, 0);
+
+        for (k = 0; k < 4; k++) {
+            for (i = 0; i < n_p; i++) {
+                c_elem[i][k] = SIMD(load)(c, base, contiguous, (k * n_p + i) * elem_block);
+            }
+        }
+
+        // interpolate to the integration points
+        for (i = 0; i < q * q; i++) {
+            f[i][0] = f[i][1] = f[i][2] = f[i][3] = (SIMD(vec)) {0.};
+        }
+        for (m = 0; m < n_p; m++) {
+            p = tensor_p[m];
+            for (ib = 0; ib < q; ib++) {
+                b0 = (SIMD(vec)) {0.} + tensor_b[m * q + ib];
+                for (k = 0; k < 4; k++) {
+                    f[p * q + ib][k] += c_elem[m][k] * b0;
+                }
+            }
+        }
+
+        for (j = 0; j < n_quad; j++) {
+            u[j][0] = u[j][1] = u[j][2] = u[j][3] = (SIMD(vec)) {0.};
+        }
+        for (ib = 0; ib < q; ib++) {
+            for (p = 0; p < q; p++) {
+                for (ia = 0; ia < q; ia++) {
+                    a0 = (SIMD(vec)) {0.} + tensor_a[p * q + ia];
+                    for (k = 0; k < 4; k++) {
+                        u[ib * q + ia][k] += f[p * q + ib][k] * a0;
+                    }
+                }
+            }
+        }
+
+        unphysical = (SIMD(mask)) {0};
+        for (j = 0; j < n_quad; j++) {
+            unphysical |= SIMD(volume_flux)(u[j][0], u[j][1], u[j][2], u[j][3],
+                                             x_r, y_r, x_s, y_s, flux_r[j], flux_s[j]);
+        }
+
+        for (l = 0; l < LANES; l++) {
+            if (unphysical[l]) {
+                break;
+            }
+        }
+        if (l < LANES) {
+            for (l = 0; l < lanes; l++) {
+                eval_volume_tensor_elem(c, quad_rhs, X_r, Y_r, X_s, Y_s, n_quad, n_p, idx[l]);
+            }
+            continue;
+        }
+
+        // project onto the gradients of the basis functions
+        for (p = 0; p < q; p++) {
+            for (ib = 0; ib < q; ib++) {
+                for (k = 0; k < 4; k++) {
+                    f[p * q + ib][k] = (SIMD(vec)) {0.};
+                    g[p * q + ib][k] = (SIMD(vec)) {0.};
+                }
+                for (ia = 0; ia < q; ia++) {
+                    a0 = (SIMD(vec)) {0.} + tensor_grad_a[0][p * q + ia];
+                    a1 = (SIMD(vec)) {0.} + tensor_grad_a[1][p * q + ia];
+                    a2 = (SIMD(vec)) {0.} + tensor_grad_a[2][p * q + ia];
+                    for (k = 0; k < 4; k++) {
+                        f[p * q + ib][k] += a0 * flux_r[ib * q + ia][k] + a1 * flux_s[ib * q + ia][k];
+                        g[p * q + ib][k] += a2 * flux_r[ib * q + ia][k];
+                    }
+                }
+            }
+        }
+
+        for (m = 0; m < n_p; m++) {
+            p = tensor_p[m];
+            sum[0] = sum[1] = sum[2] = sum[3] = (SIMD(vec)) {0.};
+            for (ib = 0; ib < q; ib++) {
+                b0 = (SIMD(vec)) {0.} + tensor_grad_b[0][m * q + ib];
+                b1 = (SIMD(vec)) {0.} + tensor_grad_b[1][m * q + ib];
+                for (k = 0; k < 4; k++) {
+                    sum[k] += b0 * f[p * q + ib][k] + b1 * g[p * q + ib][k];
+                }
+            }
+
+            for (k = 0; k < 4; k++) {
+                SIMD(store)(quad_rhs, base, contiguous, lanes, (k * n_p + m) * elem_block, sum[k]);
+            }
+        }
+    }
+}
+
+void SIMD(eval_volume_tensor)(double *c,
+                              double *quad_rhs,
+                              double *X_r, double *Y_r, double *X_s, double *Y_s,
+                              int n_quad, int n_p, int num_elem) {
+    TEAM_RUN(0, num_elem, LANES,
+             SIMD(eval_volume_tensor_share)(c,
+                                            quad_rhs,
+                                            X_r, Y_r, X_s, Y_s,
+                                            n_quad, n_p, num_elem,
+                                            first, last));
+}
@@ -0,0 +1,448 @@
+/* euler_kernels_tensor.c
+ *
+ * the volume integrals and the interior surface integrals by sum
+ * factorization in collapsed coordinates. the square [-1, 1]^2 maps onto the
+ * canonical element by
+ *
+ *      r = (1 + b) / 2,    s = (1 + a)(1 - b) / 4
+ *
+ * and the orthonormal basis from basis.c is the dubiner basis over it.
+ * basis function m = d (d + 1) / 2 + p of degree d = p + q is
+ *
+ *      phi_m = P_p(a) B_m(b),  B_m(b) = sqrt((2p + 1)(2p + 2q + 2)) ((1 - b) / 2)^p P_q^(2p+1, 0)(b)
+ *
+ * with P_p the legendre polynomials. on the q x q point rule from
+ * set_tensor_quadrature, the interpolation to the integration points is
+ * then a sum over m into a q x (n + 1) matrix followed by one over p, and
+ * the projection is the same two sums the other way, so an element costs
+ * O(n^3) instead of the O(n^4) of the n_p x n_quad tables. side 2, where
+ * b = -1, traces in O(n^2); sides 0 and 1 run along b, where no sum is
+ * saved, and use basis_side. preval_tensor_basis fills the tables, and
+ * euler_kernels_simd.c has the volume integrals LANES elements at a time.
+ */
+
+// n + 1, the points in a and b and along the sides
+int tensor_q;
+
+// the degree p in a of each basis function
+int *tensor_p;
+
+// P_p at the points in a, [p * tensor_q + ia]
+double *tensor_a;
+// B_m at the points in b, [m * tensor_q + ib]
+double *tensor_b;
+
+// the factors of the weighted gradients. for the a points
+//      2 wa (1 + a) P_p',  4 wa P_p',  wa P_p
+// and for the b points
+//      wb B_m / 8(1 - b),  wb B_m' / 4
+// so the r gradient is the first a factor times the first b factor plus the
+// third times the second, and the s gradient the second times the first.
+double *tensor_grad_a[3];
+double *tensor_grad_b[2];
+
+// P_p at side 2's integration points and B_m(-1), which side 2 is at
+double *tensor_side_a;
+double *tensor_side_b;
+
+/* tensor element volume integral
+ *
+ * the volume integral of element idx, as eval_volume_elem does it but with
+ * the sums factored. the interpolation is
+ *
+ *      f[p][ib]  = sum over m of degree p in a of c[m] B_m(b_ib)
+ *      u[ib][ia] = sum over p of P_p(a_ia) f[p][ib]
+ *
+ * and the projection runs the same way back. the four equations go through
+ * each sum together.
+ */
+void eval_volume_tensor_elem(double *c,
+                             double *quad_rhs,
+                             double *X_r, double *Y_r, double *X_s, double *Y_s,
+                             int n_quad, int n_p, int idx) {
+    int q = tensor_q;
+    int base = coeff_base(idx, n_p);
+
+    double x_r = X_r[idx];
+    double y_r = Y_r[idx];
+    double x_s = X_s[idx];
+    double y_s = Y_s[idx];
+
+    double c_k[n_p][4];
+    double u[n_quad][4];
+    double flux_r[n_quad][4];
+    double flux_s[n_quad][4];
+    double flux_x[4], flux_y[4];
+
+    // the sums over one direction, [p * q + ib]
+    double f[q * q][4];
+    double g[q * q][4];
+
+    int i, j, k, m, p, ia, ib;
+    double rho, E, b, a0, a1, a2, b0, b1, sum[4];
+    double *fr, *fs;
+
+    // get the coefficients
+    for (i = 0; i < n_p; i++) {
+        for (k = 0; k < 4; k++) {
+            c_k[i][k] = c[base + (k * n_p + i) * elem_block];
+        }
+    }
+
+    // interpolate to the integration points
+    for (i = 0; i < q * q; i++) {
+        for (k = 0; k < 4; k++) {
+            f[i][k] = 0.;
+        }
+    }
+    for (m = 0; m < n_p; m++) {
+        p = tensor_p[m];
+        for (ib = 0; ib < q; ib++) {
+            b = tensor_b[m * q + ib];
+            for (k = 0; k < 4; k++) {
+                f[p * q + ib][k] += c_k[m][k] * b;
+            }
+        }
+    }
+
+    for (j = 0; j < n_quad; j++) {
+        for (k = 0; k < 4; k++) {
+            u[j][k] = 0.;
+        }
+    }
+    for (ib = 0; ib < q; ib++) {
+        for (p = 0; p < q; p++) {
+            for (ia = 0; ia < q; ia++) {
+                a0 = tensor_a[p * q + ia];
+                for (k = 0; k < 4; k++) {
+                    u[ib * q + ia][k] += f[p * q + ib][k] * a0;
+                }
+            }
+        }
+    }
+
+    for (j = 0; j < n_quad; j++) {
+        rho = u[j][0];
+        E   = u[j][3];
+
+        // in case rho comes back nonphysical
+        if (rho <= 0) {
+            printf("rho unphysical in volume\n");
+            exit(0);
+        }
+
+        // in case E comes back nonphysical
+        if (E <= 0) {
+            printf("E unphysical in volume\n");
+            exit(0);
+        }
+
+        eval_flux(rho, u[j][1] / rho, u[j][2] / rho, E, flux_x, flux_y, 1000, idx);
+
+        // [fx fy] * [y_s, -y_r; -x_s, x_r]
+        for (k = 0; k < 4; k++) {
+            flux_r[j][k] =  flux_x[k] * y_s - flux_y[k] * x_s;
+            flux_s[j][k] = -flux_x[k] * y_r + flux_y[k] * x_r;
+        }
+    }
+
+    // project onto the gradients of the basis functions
+    for (p = 0; p < q; p++) {
+        for (ib = 0; ib < q; ib++) {
+            for (k = 0; k < 4; k++) {
+                f[p * q + ib][k] = 0.;
+                g[p * q + ib][k] = 0.;
+            }
+            for (ia = 0; ia < q; ia++) {
+                a0 = tensor_grad_a[0][p * q + ia];
+                a1 = tensor_grad_a[1][p * q + ia];
+                a2 = tensor_grad_a[2][p * q + ia];
+                fr = flux_r[ib * q + ia];
+                fs = flux_s[ib * q + ia];
+                for (k = 0; k < 4; k++) {
+                    f[p * q + ib][k] += a0 * fr[k] + a1 * fs[k];
+                    g[p * q + ib][k] += a2 * fr[k];
+                }
+            }
+        }
+    }
+
+    for (m = 0; m < n_p; m++) {
+        p = tensor_p[m];
+        for (k = 0; k < 4; k++) {
+            sum[k] = 0.;
+        }
+        for (ib = 0; ib < q; ib++) {
+            b0 = tensor_grad_b[0][m * q + ib];
+            b1 = tensor_grad_b[1][m * q + ib];
+            for (k = 0; k < 4; k++) {
+                sum[k] += b0 * f[p * q + ib][k] + b1 * g[p * q + ib][k];
+            }
+        }
+        for (k = 0; k < 4; k++) {
+            quad_rhs[base + (k * n_p + m) * elem_block] = sum[k];
+        }
+    }
+}
+
+/* tensor volume integrals
+ *
+ * eval_volume with eval_volume_tensor_elem. the points must be the ones from
+ * set_tensor_quadrature.
+ * THREADS: num_elem
+ */
+void eval_volume_tensor_share(double *c,
+                              double *quad_rhs,
+                              double *X_r, double *Y_r, double *X_s, double *Y_s,
+                              int n_quad, int n_p, int num_elem,
+                              int first, int last) {
+    int pos;
+
+    for (pos = first; pos < last; pos++) {
+        eval_volume_tensor_elem(c, quad_rhs, X_r, Y_r, X_s, Y_s, n_quad, n_p, elem_at(pos));
+    }
+}
+
+void eval_volume_tensor(double *c,
+                        double *quad_rhs,
+                        double *X_r, double *Y_r, double *X_s, double *Y_s,
+                        int n_quad, int n_p, int num_elem) {
+    TEAM_RUN(0, num_elem, 1,
+             eval_volume_tensor_share(c,
+                                      quad_rhs,
+                                      X_r, Y_r, X_s, Y_s,
+                                      n_quad, n_p, num_elem,
+                                      first, last));
+}
+
+/* tensor trace
+ *
+ * the values of the expansion with coefficients c_k, for each equation, at
+ * the n_quad1d integration points of side, in the side's own order.
+ */
+void eval_trace_tensor(double *c_k, double *u, int side, int n_p, int n_quad1d) {
+    int j, k, m, p;
+    double g[4][n_quad1d];
+    double *b;
+
+    for (j = 0; j < 4 * n_quad1d; j++) {
+        u[j] = 0.;
+    }
+
+    if (side == 2) {
+        for (k = 0; k < 4; k++) {
+            for (p = 0; p < n_quad1d; p++) {
+                g[k][p] = 0.;
+            }
+            for (m = 0; m < n_p; m++) {
+                g[k][tensor_p[m]] += c_k[k * n_p + m] * tensor_side_b[m];
+            }
+        }
+        for (p = 0; p < n_quad1d; p++) {
+            b = tensor_side_a + p * n_quad1d;
+            for (j = 0; j < n_quad1d; j++) {
+                u[0 * n_quad1d + j] += g[0][p] * b[j];
+                u[1 * n_quad1d + j] += g[1][p] * b[j];
+                u[2 * n_quad1d + j] += g[2][p] * b[j];
+                u[3 * n_quad1d + j] += g[3][p] * b[j];
+            }
+        }
+    } else {
+        for (m = 0; m < n_p; m++) {
+            b = basis_side + side * n_p * n_quad1d + m * n_quad1d;
+            for (j = 0; j < n_quad1d; j++) {
+                u[0 * n_quad1d + j] += c_k[0 * n_p + m] * b[j];
+                u[1 * n_quad1d + j] += c_k[1 * n_p + m] * b[j];
+                u[2 * n_quad1d + j] += c_k[2 * n_p + m] * b[j];
+                u[3 * n_quad1d + j] += c_k[3 * n_p + m] * b[j];
+            }
+        }
+    }
+}
+
+/* tensor lift
+ *
+ * adds scale times the projection of the values s_k at side's integration
+ * points onto the basis, for each equation, into the element at base of
+ * rhs. the transpose of eval_trace_tensor.
+ */
+void eval_lift_tensor(double *s_k, double *rhs, int base, double scale,
+                      int side, int n_p, int n_quad1d) {
+    int j, k, m;
+    double h[4][n_quad1d];
+    double sum1, sum2, sum3, sum4;
+    double *b;
+
+    if (side == 2) {
+        for (k = 0; k < 4; k++) {
+            for (m = 0; m < n_quad1d; m++) {
+                b = tensor_side_a + m * n_quad1d;
+                sum1 = 0.;
+                for (j = 0; j < n_quad1d; j++) {
+                    sum1 += b[j] * s_k[k * n_quad1d + j];
+                }
+                h[k][m] = scale * sum1;
+            }
+        }
+        for (m = 0; m < n_p; m++) {
+            for (k = 0; k < 4; k++) {
+                rhs[base + (k * n_p + m) * elem_block] += tensor_side_b[m] * h[k][tensor_p[m]];
+            }
+        }
+    } else {
+        for (m = 0; m < n_p; m++) {
+            b = basis_side + side * n_p * n_quad1d + m * n_quad1d;
+            sum1 = 0.;
+            sum2 = 0.;
+            sum3 = 0.;
+            sum4 = 0.;
+            for (j = 0; j < n_quad1d; j++) {
+                sum1 += s_k[0 * n_quad1d + j] * b[j];
+                sum2 += s_k[1 * n_quad1d + j] * b[j];
+                sum3 += s_k[2 * n_quad1d + j] * b[j];
+                sum4 += s_k[3 * n_quad1d + j] * b[j];
+            }
+            rhs[base + (0 * n_p + m) * elem_block] += scale * sum1;
+            rhs[base + (1 * n_p + m) * elem_block] += scale * sum2;
+            rhs[base + (2 * n_p + m) * elem_block] += scale * sum3;
+            rhs[base + (3 * n_p + m) * elem_block] += scale * sum4;
+        }
+    }
+}
+
+/* tensor interior surface integrals
+ *
+ * eval_surface_interior with the traces and their projection back onto the
+ * basis from eval_trace_tensor and eval_lift_tensor.
+ */
+void eval_surface_interior_tensor_share(double *c, double *rhs,
+                                        double *length,
+                                        int *left_idx_list,  int *right_idx_list,
+                                        int *left_side_list, int *right_side_list,
+                                        double *Nx, double *Ny,
+                                        int n_quad1d, int n_p, int num_sides, int num_elem,
+                                        int start, int end) {
+    int pos;
+
+    for (pos = start; pos < end; pos++) {
+        int idx = side_at(pos);
+
+        int left_idx  = left_idx_list[idx];
+        int left_side = left_side_list[idx];
+        int left_base = coeff_base(left_idx, n_p);
+
+        int right_idx  = right_idx_list[idx];
+        int right_side = right_side_list[idx];
+        int right_base = coeff_base(right_idx, n_p);
+
+        double nx  = Nx[idx];
+        double ny  = Ny[idx];
+        double len = length[idx];
+
+        double c_left[4 * n_p], c_right[4 * n_p];
+        double u_left[4][n_quad1d], u_right[4][n_quad1d];
+        double s[4][n_quad1d], s_right[4][n_quad1d];
+        double flux[4];
+
+        int i, j, k, jr;
+        double rho_left, rho_right;
+
+        for (i = 0; i < 4 * n_p; i++) {
+            c_left[i]  = c[left_base  + i * elem_block];
+            c_right[i] = c[right_base + i * elem_block];
+        }
+        eval_trace_tensor(c_left,  u_left[0],  left_side,  n_p, n_quad1d);
+        eval_trace_tensor(c_right, u_right[0], right_side, n_p, n_quad1d);
+
+        // solve the riemann problem at each integration point; the right
+        // element's points run backwards along the side
+        for (j = 0; j < n_quad1d; j++) {
+            jr = n_quad1d - 1 - j;
+            rho_left  = u_left[0][j];
+            rho_right = u_right[0][jr];
+
+            if (rho_left <= 0.) {
+                printf("%lf rho unphysical.\n", rho_left);
+                exit(0);
+            }
+            if (u_left[3][j] <= 0) {
+                printf("%lf E unphysical.\n", u_left[3][j]);
+                exit(0);
+            }
+
+            eval_riemann_flux(rho_left, u_left[1][j] / rho_left, u_left[2][j] / rho_left,
+                              u_left[3][j],
+                              rho_right, u_right[1][jr] / rho_right, u_right[2][jr] / rho_right,
+                              u_right[3][jr],
+                              nx, ny, left_side, right_side, idx, flux);
+
+            for (k = 0; k < 4; k++) {
+                s[k][j]        = w_oned[j] * flux[k];
+                s_right[k][jr] = s[k][j];
+            }
+        }
+
+        // add this side's contribution to both elements
+        eval_lift_tensor(s[0],       rhs, left_base,  -len / 2., left_side,  n_p, n_quad1d);
+        eval_lift_tensor(s_right[0], rhs, right_base,  len / 2., right_side, n_p, n_quad1d);
+    }
+}
+
+void eval_surface_interior_tensor(double *c, double *rhs,
+                                  double *length,
+                                  int *left_idx_list,  int *right_idx_list,
+                                  int *left_side_list, int *right_side_list,
+                                  double *Nx, double *Ny,
+                                  int n_quad1d, int n_p, int num_sides, int num_elem,
+                                  int start, int end) {
+    TEAM_RUN(start, end, 1,
+             eval_surface_interior_tensor_share(c, rhs,
+                                                length,
+                                                left_idx_list, right_idx_list,
+                                                left_side_list, right_side_list,
+                                                Nx, Ny,
+                                                n_quad1d, n_p, num_sides, num_elem,
+                                                first, last));
+}
+
+/* tensor surface integrals
+ *
+ * eval_surface with eval_surface_interior_tensor for the interior sides. the
+ * boundary sides are the same as ever.
+ */
+void eval_surface_tensor(double *c, double *rhs,
+                         double *length,
+                         double *V1x, double *V1y,
+                         double *V2x, double *V2y,
+                         double *V3x, double *V3y,
+                         int *left_idx_list,  int *right_idx_list,
+                         int *left_side_list, int *right_side_list,
+                         double *Nx, double *Ny,
+                         int n_quad1d, int n_quad, int n_p, int num_sides,
+                         int num_elem, double t) {
+    int j, k;
+
+    for (j = 0; j < num_colors[0]; j++) {
+        eval_surface_interior_tensor(c, rhs,
+                                     length,
+                                     left_idx_list, right_idx_list,
+                                     left_side_list, right_side_list,
+                                     Nx, Ny,
+                                     n_quad1d, n_p, num_sides, num_elem,
+                                     color_ranges[0][j], color_end(0, j));
+    }
+
+    // reflecting, outflow, inflow
+    for (k = 1; k < 4; k++) {
+        for (j = 0; j < num_colors[k]; j++) {
+            eval_surface_boundary(c, rhs,
+                                  length,
+                                  V1x, V1y, V2x, V2y, V3x, V3y,
+                                  left_idx_list,
+                                  left_side_list, right_side_list,
+                                  Nx, Ny,
+                                  n_quad1d, n_p, num_sides, num_elem,
+                                  color_ranges[k][j], color_end(k, j), -k, t);
+        }
+    }
+}
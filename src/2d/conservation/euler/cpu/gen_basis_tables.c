@@ -0,0 +1,150 @@
+#define BASIS_TABLES_GEN
+#include "euler.c"
+
+/* gen_basis_tables.c
+ *
+ * writes basis_tables.h: the tables preval_basis fills for every order up to
+ * MAX_ORDER on the rules from set_quadrature and set_tensor_quadrature, and
+ * the ones preval_tensor_basis fills, as static const data. the makefile
+ * builds and runs this before anything that includes euler.c, so the
+ * solvers only copy the tables at startup, and the kernels specialized for
+ * an order read its tables directly. this is built without basis_tables.h,
+ * so preval_basis evaluates the basis here.
+ *
+ * the tables for order n are named like the globals with _n after them, and
+ * _collapsed_n for set_tensor_quadrature's rule. they're printed with 17
+ * digits, which reads back to the same doubles.
+ *
+ * Usage: gen_basis_tables > basis_tables.h
+ */
+
+/* print table
+ *
+ * a static const table of size doubles, aligned like aligned_table makes
+ * them.
+ */
+void print_table(const char *name, const char *suffix, double *table, int size) {
+    int i;
+
+    printf("static const double %s%s[%i] __attribute__((aligned(TABLE_ALIGN))) = {", name, suffix, size);
+    for (i = 0; i < size; i++) {
+        printf("%s%.17g,", (i % 4) ? " " : "\n    ", table[i]);
+    }
+    printf("\n};\n\n");
+}
+
+/* print basis tables
+ *
+ * the tables preval_basis filled, for the rule with n_quad and n_quad1d
+ * points.
+ */
+void print_basis_tables(const char *suffix, int n_quad, int n_quad1d, int n_p) {
+    print_table("basis",        suffix, basis,        n_quad * n_p);
+    print_table("basis_grad_x", suffix, basis_grad_x, n_quad * n_p);
+    print_table("basis_grad_y", suffix, basis_grad_y, n_quad * n_p);
+    print_table("basis_side",   suffix, basis_side,   3 * n_quad1d * n_p);
+    print_table("basis_vertex", suffix, basis_vertex, 3 * n_p);
+    print_table("w",      suffix, w,      n_quad);
+    print_table("w_oned", suffix, w_oned, n_quad1d);
+    print_table("r1",     suffix, r1,     n_quad);
+    print_table("r2",     suffix, r2,     n_quad);
+    print_table("r_oned", suffix, r_oned, n_quad1d);
+}
+
+/* print basis table entry
+ *
+ * the basis_table initializer for the tables with this suffix.
+ */
+void print_basis_table_entry(const char *suffix, int n_quad, int n_quad1d) {
+    printf("    {%i, %i,\n", n_quad, n_quad1d);
+    printf("     basis%s, basis_grad_x%s, basis_grad_y%s, basis_side%s, basis_vertex%s,\n",
+           suffix, suffix, suffix, suffix, suffix);
+    printf("     w%s, w_oned%s, r1%s, r2%s, r_oned%s},\n",
+           suffix, suffix, suffix, suffix, suffix);
+}
+
+int main() {
+    int n, i, n_p;
+    int n_quad[MAX_ORDER + 1], n_quad1d[MAX_ORDER + 1];
+    int n_collapsed[MAX_ORDER + 1];
+    char suffix[32];
+    double *r1_local, *r2_local, *w_local, *s_r, *oned_w_local;
+
+    printf("/* basis_tables.h\n");
+    printf(" *\n");
+    printf(" * generated by gen_basis_tables; don't edit.\n");
+    printf(" */\n\n");
+
+    for (n = 0; n <= MAX_ORDER; n++) {
+        n_p = (n + 1) * (n + 2) / 2;
+
+        set_quadrature(n, &r1_local, &r2_local, &w_local,
+                       &s_r, &oned_w_local, &n_quad[n], &n_quad1d[n]);
+        preval_basis(r1_local, r2_local, s_r, w_local, oned_w_local, n_quad[n], n_quad1d[n], n_p);
+        sprintf(suffix, "_%i", n);
+        print_basis_tables(suffix, n_quad[n], n_quad1d[n], n_p);
+
+        free(r1_local);
+        free(r2_local);
+        free(w_local);
+        free(s_r);
+        free(oned_w_local);
+
+        set_tensor_quadrature(n, &r1_local, &r2_local, &w_local,
+                              &s_r, &oned_w_local, &n_collapsed[n], &n_quad1d[n]);
+        preval_basis(r1_local, r2_local, s_r, w_local, oned_w_local, n_collapsed[n], n_quad1d[n], n_p);
+        preval_tensor_basis(n);
+        sprintf(suffix, "_collapsed_%i", n);
+        print_basis_tables(suffix, n_collapsed[n], n_quad1d[n], n_p);
+
+        sprintf(suffix, "_%i", n);
+        printf("static const int tensor_p%s[%i] = {", suffix, n_p);
+        for (i = 0; i < n_p; i++) {
+            printf("%s%i", i ? ", " : "", tensor_p[i]);
+        }
+        printf("};\n\n");
+        print_table("tensor_a",       suffix, tensor_a,         tensor_q * tensor_q);
+        print_table("tensor_b",       suffix, tensor_b,         n_p * tensor_q);
+        print_table("tensor_grad_a0", suffix, tensor_grad_a[0], tensor_q * tensor_q);
+        print_table("tensor_grad_a1", suffix, tensor_grad_a[1], tensor_q * tensor_q);
+        print_table("tensor_grad_a2", suffix, tensor_grad_a[2], tensor_q * tensor_q);
+        print_table("tensor_grad_b0", suffix, tensor_grad_b[0], n_p * tensor_q);
+        print_table("tensor_grad_b1", suffix, tensor_grad_b[1], n_p * tensor_q);
+        print_table("tensor_side_a",  suffix, tensor_side_a,    tensor_q * tensor_q);
+        print_table("tensor_side_b",  suffix, tensor_side_b,    n_p);
+
+        free(r1_local);
+        free(r2_local);
+        free(w_local);
+        free(s_r);
+        free(oned_w_local);
+    }
+
+    // the tables for each order n, at index n
+    printf("static const basis_table symmetric_tables[MAX_ORDER + 1] = {\n");
+    for (n = 0; n <= MAX_ORDER; n++) {
+        sprintf(suffix, "_%i", n);
+        print_basis_table_entry(suffix, n_quad[n], n_quad1d[n]);
+    }
+    printf("};\n\n");
+
+    printf("static const basis_table collapsed_tables[MAX_ORDER + 1] = {\n");
+    for (n = 0; n <= MAX_ORDER; n++) {
+        sprintf(suffix, "_collapsed_%i", n);
+        print_basis_table_entry(suffix, n_collapsed[n], n_quad1d[n]);
+    }
+    printf("};\n\n");
+
+    printf("static const tensor_table tensor_tables[MAX_ORDER + 1] = {\n");
+    for (n = 0; n <= MAX_ORDER; n++) {
+        printf("    {tensor_p_%i, tensor_a_%i, tensor_b_%i,\n", n, n, n);
+        printf("     {tensor_grad_a0_%i, tensor_grad_a1_%i, tensor_grad_a2_%i},\n", n, n, n);
+        printf("     {tensor_grad_b0_%i, tensor_grad_b1_%i},\n", n, n);
+        printf("     tensor_side_a_%i, tensor_side_b_%i},\n", n, n);
+    }
+    printf("};\n");
+
+    free_basis();
+
+    return 0;
+}
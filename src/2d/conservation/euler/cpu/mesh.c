@@ -0,0 +1,251 @@
+/* mesh.c
+ *
+ * mesh connectivity for the cpu euler solver. instead of scanning every side
+ * we've already added (which is quadratic in the number of elements), the
+ * vertices are deduplicated into indices and every side is looked up in a hash
+ * table keyed on its sorted pair of vertex indices. the side hash table and
+ * the gmsh reader are shared with dgcuda, in conserv_mesh.cu. the binary
+ * meshes written by meshconvert are read here.
+ */
+
+#include "../../conserv_mesh.cu"
+
+/* dedup vertices
+ *
+ * maps each of the num_points (x, y) pairs to a vertex index so that identical
+ * coordinates get the same index. returns the number of unique vertices.
+ */
+int dedup_vertices(double *x, double *y, int num_points, int *vertex_idx) {
+    int i, slot, num_vertices;
+    double xk, yk;
+    unsigned long long key_x, key_y;
+    int size = hash_table_size(num_points);
+    int *table = (int *) malloc(size * sizeof(int));
+
+    for (i = 0; i < size; i++) {
+        table[i] = -1;
+    }
+
+    num_vertices = 0;
+    for (i = 0; i < num_points; i++) {
+        // hash the bit patterns, but like the == the old side scan compared
+        // with, -0 has to meet 0, so adding 0 turns it into 0 first
+        xk = x[i] + 0.;
+        yk = y[i] + 0.;
+        memcpy(&key_x, &xk, sizeof(double));
+        memcpy(&key_y, &yk, sizeof(double));
+        slot = hash_key(key_x ^ hash_key(key_y)) & (size - 1);
+
+        // linear probing until we find this point or an empty slot
+        while (table[slot] != -1 && (x[table[slot]] != x[i] || y[table[slot]] != y[i])) {
+            slot = (slot + 1) & (size - 1);
+        }
+
+        if (table[slot] == -1) {
+            table[slot] = i;
+            vertex_idx[i] = num_vertices;
+            num_vertices++;
+        } else {
+            vertex_idx[i] = vertex_idx[table[slot]];
+        }
+    }
+
+    free(table);
+    return num_vertices;
+}
+
+/***********************
+ *
+ * BINARY MESHES
+ *
+ ***********************/
+
+/* binary mesh format
+ *
+ * a preprocessed mesh holding the connectivity and every precomputed
+ * geometric factor, so a run can mmap it instead of parsing text and
+ * rebuilding everything. the file is a 64 byte header followed by the
+ * arrays listed in binary_elem_doubles, binary_elem_ints, binary_side_doubles
+ * and binary_side_ints (in that order), each starting on a 64 byte boundary.
+ * the sides are stored grouped by boundary type and sorted by color within
+ * each group (see sort_sides). bump BINARY_MESH_VERSION whenever any of this
+ * changes.
+ */
+#define BINARY_MESH_MAGIC "DGBMSH"
+#define BINARY_MESH_VERSION 4
+#define BINARY_MESH_ALIGN 64
+
+typedef struct {
+    char magic[8];
+    int version;
+    int num_elem;
+    int num_sides;
+    int reserved;
+    double min_r;
+    long long file_size;
+    char padding[24];
+} binary_mesh_header;
+
+double **binary_elem_doubles[] = {&d_V1x, &d_V1y, &d_V2x, &d_V2y, &d_V3x, &d_V3y,
+                                  &d_J, &d_radius, &d_xr, &d_yr, &d_xs, &d_ys};
+int **binary_elem_ints[]       = {&d_elem_s1, &d_elem_s2, &d_elem_s3};
+double **binary_side_doubles[] = {&d_s_V1x, &d_s_V1y, &d_s_V2x, &d_s_V2y,
+                                  &d_s_length, &d_Nx, &d_Ny};
+int **binary_side_ints[]       = {&d_left_elem, &d_right_elem,
+                                  &d_left_side_number, &d_right_side_number};
+
+#define NUM_ENTRIES(list) (int) (sizeof(list) / sizeof(list[0]))
+
+// the mapped file, if the mesh arrays came from one
+void *mesh_map = NULL;
+size_t mesh_map_size;
+
+/* aligned size
+ *
+ * rounds an array size up to the next BINARY_MESH_ALIGN boundary.
+ */
+size_t aligned_size(size_t size) {
+    return (size + BINARY_MESH_ALIGN - 1) / BINARY_MESH_ALIGN * BINARY_MESH_ALIGN;
+}
+
+/* binary mesh size
+ *
+ * the total file size for a mesh with this many elements and sides.
+ */
+size_t binary_mesh_size(int num_elem, int num_sides) {
+    return sizeof(binary_mesh_header)
+         + NUM_ENTRIES(binary_elem_doubles) * aligned_size(num_elem  * sizeof(double))
+         + NUM_ENTRIES(binary_elem_ints)    * aligned_size(num_elem  * sizeof(int))
+         + NUM_ENTRIES(binary_side_doubles) * aligned_size(num_sides * sizeof(double))
+         + NUM_ENTRIES(binary_side_ints)    * aligned_size(num_sides * sizeof(int));
+}
+
+/* is binary mesh
+ *
+ * checks the magic number at the start of the mesh file and rewinds it.
+ */
+int is_binary_mesh(FILE *mesh_file) {
+    char magic[8];
+    int items = fread(magic, 1, sizeof(magic), mesh_file);
+    rewind(mesh_file);
+
+    return items == sizeof(magic) && strcmp(magic, BINARY_MESH_MAGIC) == 0;
+}
+
+/* write binary mesh
+ *
+ * writes the mesh currently in the d_ arrays out to filename. all of the
+ * precomputations must have been done already.
+ */
+int write_binary_mesh(char *filename, int num_elem, int num_sides, double min_r) {
+    int i;
+    size_t size;
+    binary_mesh_header header;
+    char padding[BINARY_MESH_ALIGN];
+    FILE *mesh_file = fopen(filename, "wb");
+
+    if (!mesh_file) {
+        printf("\nERROR: could not open %s for writing.\n", filename);
+        return 1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memset(padding, 0, sizeof(padding));
+    strcpy(header.magic, BINARY_MESH_MAGIC);
+    header.version   = BINARY_MESH_VERSION;
+    header.num_elem  = num_elem;
+    header.num_sides = num_sides;
+    header.min_r     = min_r;
+    header.file_size = binary_mesh_size(num_elem, num_sides);
+    fwrite(&header, sizeof(header), 1, mesh_file);
+
+    // write each array followed by the padding up to the next boundary
+    size = num_elem * sizeof(double);
+    for (i = 0; i < NUM_ENTRIES(binary_elem_doubles); i++) {
+        fwrite(*binary_elem_doubles[i], 1, size, mesh_file);
+        fwrite(padding, 1, aligned_size(size) - size, mesh_file);
+    }
+    size = num_elem * sizeof(int);
+    for (i = 0; i < NUM_ENTRIES(binary_elem_ints); i++) {
+        fwrite(*binary_elem_ints[i], 1, size, mesh_file);
+        fwrite(padding, 1, aligned_size(size) - size, mesh_file);
+    }
+    size = num_sides * sizeof(double);
+    for (i = 0; i < NUM_ENTRIES(binary_side_doubles); i++) {
+        fwrite(*binary_side_doubles[i], 1, size, mesh_file);
+        fwrite(padding, 1, aligned_size(size) - size, mesh_file);
+    }
+    size = num_sides * sizeof(int);
+    for (i = 0; i < NUM_ENTRIES(binary_side_ints); i++) {
+        fwrite(*binary_side_ints[i], 1, size, mesh_file);
+        fwrite(padding, 1, aligned_size(size) - size, mesh_file);
+    }
+
+    fclose(mesh_file);
+    return 0;
+}
+
+/* read binary mesh
+ *
+ * maps filename into memory and points the d_ mesh arrays straight into the
+ * mapping; nothing is copied. the mapping is private, so writes to the arrays
+ * never make it back to the file.
+ */
+int read_binary_mesh(char *filename, int *num_elem, int *num_sides, double *min_r) {
+    int i, fd;
+    size_t size;
+    char *data;
+    struct stat st;
+    binary_mesh_header *header;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        printf("\nERROR: mesh file not found.\n");
+        return 1;
+    }
+
+    data = (char *) mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("\nERROR: could not map %s.\n", filename);
+        return 1;
+    }
+
+    header = (binary_mesh_header *) data;
+    if (strcmp(header->magic, BINARY_MESH_MAGIC) != 0 || header->version != BINARY_MESH_VERSION
+        || header->file_size != st.st_size
+        || header->file_size != binary_mesh_size(header->num_elem, header->num_sides)) {
+        printf("\nERROR: %s is not a version %i binary mesh; regenerate it with meshconvert.\n", 
+                filename, BINARY_MESH_VERSION);
+        munmap(data, st.st_size);
+        return 1;
+    }
+
+    *num_elem  = header->num_elem;
+    *num_sides = header->num_sides;
+    *min_r     = header->min_r;
+
+    mesh_map      = data;
+    mesh_map_size = st.st_size;
+    data += sizeof(binary_mesh_header);
+
+    // point each array at its spot in the file
+    size = aligned_size(*num_elem * sizeof(double));
+    for (i = 0; i < NUM_ENTRIES(binary_elem_doubles); i++, data += size) {
+        *binary_elem_doubles[i] = (double *) data;
+    }
+    size = aligned_size(*num_elem * sizeof(int));
+    for (i = 0; i < NUM_ENTRIES(binary_elem_ints); i++, data += size) {
+        *binary_elem_ints[i] = (int *) data;
+    }
+    size = aligned_size(*num_sides * sizeof(double));
+    for (i = 0; i < NUM_ENTRIES(binary_side_doubles); i++, data += size) {
+        *binary_side_doubles[i] = (double *) data;
+    }
+    size = aligned_size(*num_sides * sizeof(int));
+    for (i = 0; i < NUM_ENTRIES(binary_side_ints); i++, data += size) {
+        *binary_side_ints[i] = (int *) data;
+    }
+
+    return 0;
+}
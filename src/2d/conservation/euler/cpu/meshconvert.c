@@ -0,0 +1,42 @@
+#include "euler.c"
+
+/* meshconvert.c
+ *
+ * converts a mesh into the binary format read by cpueuler. the connectivity
+ * and all of the geometric precomputations are done here once, so runs on
+ * the binary mesh only have to map the file.
+ *
+ * Usage: meshconvert [-r ORDERING] [MESH] [OUTFILE]
+ */
+int main(int argc, char *argv[]) {
+    int num_elem, num_sides;
+    double min_r;
+
+    // the binary mesh keeps the element ordering
+    if (argc == 5 && strcmp(argv[1], "-r") == 0) {
+        mesh_ordering = parse_ordering(argv[2]);
+    }
+
+    if ((argc != 3 && argc != 5) || mesh_ordering < 0) {
+        printf("\nUsage: meshconvert [-r ORDERING] [MESH] [OUTFILE]\n");
+        printf(" ORDERING is none, rcm, hilbert or morton.\n");
+        return 1;
+    }
+
+    if (read_mesh_file(argv[argc - 2], &num_elem, &num_sides, &min_r)) {
+        return 1;
+    }
+
+    if (write_binary_mesh(argv[argc - 1], num_elem, num_sides, min_r)) {
+        return 1;
+    }
+
+    printf("Wrote %s\n", argv[argc - 1]);
+    printf(" ? %i elements\n", num_elem);
+    printf(" ? %i sides\n", num_sides);
+    printf(" ? min radius = %lf\n", min_r);
+
+    free_gpu_mesh();
+
+    return 0;
+}
@@ -119,55 +119,382 @@ double quad_2d_degree10[75] = {0.333333333333333,0.333333333333333,0.09081799038
                            0.923655933587500,0.066803251012200,0.009421666963733,
                            0.923655933587500,0.009540815400299,0.009421666963733,
                            0.009540815400299,0.923655933587500,0.009421666963733};
-// put them together 
-double *quad_2d[10] = {quad_2d_degree1, quad_2d_degree2, quad_2d_degree3,
-                    quad_2d_degree4, quad_2d_degree5, quad_2d_degree6,
-                    quad_2d_degree7, quad_2d_degree8, quad_2d_degree9,
-                    quad_2d_degree10}; 
+// the rules past degree 10 are fully symmetric, with positive weights and all
+// their points inside, and as few points as the xiao-gimbutas rules. they
+// were found by levenberg-marquardt on the moment equations of the
+// orthonormal basis, dropping one orbit of points at a time while it still
+// solved.
+// 33 points
+double quad_2d_degree12[99] = {0.4397243922944603,0.1205512154110795,0.0436925445380384,
+                               0.1205512154110795,0.4397243922944603,0.0436925445380384,
+                               0.4397243922944603,0.4397243922944603,0.0436925445380384,
+                               0.2712103850121159,0.4575792299757682,0.0628582242178851,
+                               0.4575792299757682,0.2712103850121159,0.0628582242178851,
+                               0.2712103850121159,0.2712103850121159,0.0628582242178851,
+                               0.0213173504532104,0.9573652990935793,0.0061662610515590,
+                               0.9573652990935793,0.0213173504532104,0.0061662610515590,
+                               0.0213173504532104,0.0213173504532104,0.0061662610515590,
+                               0.0257340505483302,0.1162519159075972,0.0173162311086589,
+                               0.1162519159075972,0.0257340505483302,0.0173162311086589,
+                               0.8580140335440726,0.1162519159075972,0.0173162311086589,
+                               0.1162519159075972,0.8580140335440726,0.0173162311086589,
+                               0.8580140335440726,0.0257340505483302,0.0173162311086589,
+                               0.0257340505483302,0.8580140335440726,0.0173162311086589,
+                               0.0228383322222570,0.6958360867878034,0.0223567732023034,
+                               0.6958360867878034,0.0228383322222570,0.0223567732023034,
+                               0.2813255809899395,0.6958360867878034,0.0223567732023034,
+                               0.6958360867878034,0.2813255809899395,0.0223567732023034,
+                               0.2813255809899395,0.0228383322222570,0.0223567732023034,
+                               0.0228383322222570,0.2813255809899395,0.0223567732023034,
+                               0.6089432357797878,0.1153434945346979,0.0403715577663809,
+                               0.1153434945346979,0.6089432357797878,0.0403715577663809,
+                               0.2757132696855142,0.1153434945346979,0.0403715577663809,
+                               0.1153434945346979,0.2757132696855142,0.0403715577663809,
+                               0.2757132696855142,0.6089432357797878,0.0403715577663809,
+                               0.6089432357797878,0.2757132696855142,0.0403715577663809,
+                               0.4882173897738049,0.0235652204523903,0.0257310664404553,
+                               0.0235652204523903,0.4882173897738049,0.0257310664404553,
+                               0.4882173897738049,0.4882173897738049,0.0257310664404553,
+                               0.1275761455415859,0.7448477089168282,0.0347961129307090,
+                               0.7448477089168282,0.1275761455415859,0.0347961129307090,
+                               0.1275761455415859,0.1275761455415859,0.0347961129307090};
+// 42 points
+double quad_2d_degree14[126] = {0.1772055324125434,0.6455889351749131,0.0421625887369930,
+                                0.6455889351749131,0.1772055324125434,0.0421625887369930,
+                                0.1772055324125434,0.1772055324125434,0.0421625887369930,
+                                0.4176447193404539,0.1647105613190921,0.0327883535441253,
+                                0.1647105613190921,0.4176447193404539,0.0327883535441253,
+                                0.4176447193404539,0.4176447193404539,0.0327883535441253,
+                                0.0193909612487011,0.9612180775025978,0.0049234036024001,
+                                0.9612180775025978,0.0193909612487011,0.0049234036024001,
+                                0.0193909612487011,0.0193909612487011,0.0049234036024001,
+                                0.4889639103621786,0.0220721792756428,0.0218835813694289,
+                                0.0220721792756428,0.4889639103621786,0.0218835813694289,
+                                0.4889639103621786,0.4889639103621786,0.0218835813694289,
+                                0.2734775283088386,0.4530449433823227,0.0517741045072915,
+                                0.4530449433823227,0.2734775283088386,0.0517741045072915,
+                                0.2734775283088386,0.2734775283088386,0.0517741045072915,
+                                0.1722666878213556,0.0571247574036479,0.0246657532125637,
+                                0.0571247574036479,0.1722666878213556,0.0246657532125637,
+                                0.7706085547749965,0.0571247574036479,0.0246657532125637,
+                                0.0571247574036479,0.7706085547749965,0.0246657532125637,
+                                0.7706085547749965,0.1722666878213556,0.0246657532125637,
+                                0.1722666878213556,0.7706085547749965,0.0246657532125637,
+                                0.0012683309328720,0.1189744976969568,0.0050102288385007,
+                                0.1189744976969568,0.0012683309328720,0.0050102288385007,
+                                0.8797571713701712,0.1189744976969568,0.0050102288385007,
+                                0.1189744976969568,0.8797571713701712,0.0050102288385007,
+                                0.8797571713701712,0.0012683309328720,0.0050102288385007,
+                                0.0012683309328720,0.8797571713701712,0.0050102288385007,
+                                0.3368614597963450,0.0929162493569718,0.0385715107870607,
+                                0.0929162493569718,0.3368614597963450,0.0385715107870607,
+                                0.5702222908466832,0.0929162493569718,0.0385715107870607,
+                                0.0929162493569718,0.5702222908466832,0.0385715107870607,
+                                0.5702222908466832,0.3368614597963450,0.0385715107870607,
+                                0.3368614597963450,0.5702222908466832,0.0385715107870607,
+                                0.2983728821362577,0.6869801678080878,0.0144363081135338,
+                                0.6869801678080878,0.2983728821362577,0.0144363081135338,
+                                0.0146469500556544,0.6869801678080878,0.0144363081135338,
+                                0.6869801678080878,0.0146469500556544,0.0144363081135338,
+                                0.0146469500556544,0.2983728821362577,0.0144363081135338,
+                                0.2983728821362577,0.0146469500556544,0.0144363081135338,
+                                0.0617998830908726,0.8764002338182548,0.0144336996697767,
+                                0.8764002338182548,0.0617998830908726,0.0144336996697767,
+                                0.0617998830908726,0.0617998830908726,0.0144336996697767};
+// 55 points
+double quad_2d_degree16[165] = {0.3333333333333333,0.3333333333333333,0.0465701094101731,
+                                0.4922106085395552,0.0155787829208897,0.0139588405316429,
+                                0.0155787829208897,0.4922106085395552,0.0139588405316429,
+                                0.4922106085395552,0.4922106085395552,0.0139588405316429,
+                                0.1810780517373544,0.6378438965252913,0.0305407632358211,
+                                0.6378438965252913,0.1810780517373544,0.0305407632358211,
+                                0.1810780517373544,0.1810780517373544,0.0305407632358211,
+                                0.0062883330624729,0.9874233338750542,0.0010215475970554,
+                                0.9874233338750542,0.0062883330624729,0.0010215475970554,
+                                0.0062883330624729,0.0062883330624729,0.0010215475970554,
+                                0.2424754846360718,0.5150490307278563,0.0048542540860220,
+                                0.5150490307278563,0.2424754846360718,0.0048542540860220,
+                                0.2424754846360718,0.2424754846360718,0.0048542540860220,
+                                0.3204780809358336,0.0155727121940190,0.0130520568417326,
+                                0.0155727121940190,0.3204780809358336,0.0130520568417326,
+                                0.6639492068701474,0.0155727121940190,0.0130520568417326,
+                                0.0155727121940190,0.6639492068701474,0.0130520568417326,
+                                0.6639492068701474,0.3204780809358336,0.0130520568417326,
+                                0.3204780809358336,0.6639492068701474,0.0130520568417326,
+                                0.8141420501753343,0.0150893392523079,0.0101739846794349,
+                                0.0150893392523079,0.8141420501753343,0.0101739846794349,
+                                0.1707686105723578,0.0150893392523079,0.0101739846794349,
+                                0.0150893392523079,0.1707686105723578,0.0101739846794349,
+                                0.1707686105723578,0.8141420501753343,0.0101739846794349,
+                                0.8141420501753343,0.1707686105723578,0.0101739846794349,
+                                0.0801975236697966,0.5405909348018473,0.0281969704729221,
+                                0.5405909348018473,0.0801975236697966,0.0281969704729221,
+                                0.3792115415283561,0.5405909348018473,0.0281969704729221,
+                                0.5405909348018473,0.3792115415283561,0.0281969704729221,
+                                0.3792115415283561,0.0801975236697966,0.0281969704729221,
+                                0.0801975236697966,0.3792115415283561,0.0281969704729221,
+                                0.1119531316529028,0.0719935411468507,0.0127760801270976,
+                                0.0719935411468507,0.1119531316529028,0.0127760801270976,
+                                0.8160533272002466,0.0719935411468507,0.0127760801270976,
+                                0.0719935411468507,0.8160533272002466,0.0127760801270976,
+                                0.8160533272002466,0.1119531316529028,0.0127760801270976,
+                                0.1119531316529028,0.8160533272002466,0.0127760801270976,
+                                0.4838830701916146,0.1882497272734286,0.0384685428343230,
+                                0.1882497272734286,0.4838830701916146,0.0384685428343230,
+                                0.3278672025349568,0.1882497272734286,0.0384685428343230,
+                                0.1882497272734286,0.3278672025349568,0.0384685428343230,
+                                0.3278672025349568,0.4838830701916146,0.0384685428343230,
+                                0.4838830701916146,0.3278672025349568,0.0384685428343230,
+                                0.6926931744026875,0.0793265608192705,0.0242518912032503,
+                                0.0793265608192705,0.6926931744026875,0.0242518912032503,
+                                0.2279802647780420,0.0793265608192705,0.0242518912032503,
+                                0.0793265608192705,0.2279802647780420,0.0242518912032503,
+                                0.2279802647780420,0.6926931744026875,0.0242518912032503,
+                                0.6926931744026875,0.2279802647780420,0.0242518912032503,
+                                0.0611564390096041,0.0161170260023064,0.0067977528809401,
+                                0.0161170260023064,0.0611564390096041,0.0067977528809401,
+                                0.9227265349880895,0.0161170260023064,0.0067977528809401,
+                                0.0161170260023064,0.9227265349880895,0.0067977528809401,
+                                0.9227265349880895,0.0611564390096041,0.0067977528809401,
+                                0.0611564390096041,0.9227265349880895,0.0067977528809401};
+// 67 points
+double quad_2d_degree18[201] = {0.3333333333333333,0.3333333333333333,0.0363557353014266,
+                                0.0388302560886856,0.9223394878226289,0.0071293260197190,
+                                0.9223394878226289,0.0388302560886856,0.0071293260197190,
+                                0.0388302560886856,0.0388302560886856,0.0071293260197190,
+                                0.4618095064064492,0.0763809871871015,0.0189491715067788,
+                                0.0763809871871015,0.4618095064064492,0.0189491715067788,
+                                0.4618095064064492,0.4618095064064492,0.0189491715067788,
+                                0.4875803015748695,0.0248393968502609,0.0120466476339997,
+                                0.0248393968502609,0.4875803015748695,0.0120466476339997,
+                                0.4875803015748695,0.4875803015748695,0.0120466476339997,
+                                0.2422647025142720,0.5154705949714561,0.0364750894089436,
+                                0.5154705949714561,0.2422647025142720,0.0364750894089436,
+                                0.2422647025142720,0.2422647025142720,0.0364750894089436,
+                                0.1081957937910333,0.0134620167414450,0.0068401101196072,
+                                0.0134620167414450,0.1081957937910333,0.0068401101196072,
+                                0.8783421894675217,0.0134620167414450,0.0068401101196072,
+                                0.0134620167414450,0.8783421894675217,0.0068401101196072,
+                                0.8783421894675217,0.1081957937910333,0.0068401101196072,
+                                0.1081957937910333,0.8783421894675217,0.0068401101196072,
+                                0.2063492574338379,0.1226967573719275,0.0237819109001528,
+                                0.1226967573719275,0.2063492574338379,0.0237819109001528,
+                                0.6709539851942345,0.1226967573719275,0.0237819109001528,
+                                0.1226967573719275,0.6709539851942345,0.0237819109001528,
+                                0.6709539851942345,0.2063492574338379,0.0237819109001528,
+                                0.2063492574338379,0.6709539851942345,0.0237819109001528,
+                                0.6004189546342569,0.3956834343322697,0.0045305345022571,
+                                0.3956834343322697,0.6004189546342569,0.0045305345022571,
+                                0.0038976110334734,0.3956834343322697,0.0045305345022571,
+                                0.3956834343322697,0.0038976110334734,0.0045305345022571,
+                                0.0038976110334734,0.6004189546342569,0.0045305345022571,
+                                0.6004189546342569,0.0038976110334734,0.0045305345022571,
+                                0.1838227079254640,0.7703723762146752,0.0137596162349422,
+                                0.7703723762146752,0.1838227079254640,0.0137596162349422,
+                                0.0458049158598608,0.7703723762146752,0.0137596162349422,
+                                0.7703723762146752,0.0458049158598608,0.0137596162349422,
+                                0.0458049158598608,0.1838227079254640,0.0137596162349422,
+                                0.1838227079254640,0.0458049158598608,0.0137596162349422,
+                                0.0052983351866098,0.7589294798551985,0.0050106608745797,
+                                0.7589294798551985,0.0052983351866098,0.0050106608745797,
+                                0.2357721849581917,0.7589294798551985,0.0050106608745797,
+                                0.7589294798551985,0.2357721849581917,0.0050106608745797,
+                                0.2357721849581917,0.0052983351866098,0.0050106608745797,
+                                0.0052983351866098,0.2357721849581917,0.0050106608745797,
+                                0.6399880920047146,0.0402602834699081,0.0177474891020204,
+                                0.0402602834699081,0.6399880920047146,0.0177474891020204,
+                                0.3197516245253774,0.0402602834699081,0.0177474891020204,
+                                0.0402602834699081,0.3197516245253774,0.0177474891020204,
+                                0.3197516245253774,0.6399880920047146,0.0177474891020204,
+                                0.6399880920047146,0.3197516245253774,0.0177474891020204,
+                                0.1205876951639246,0.3334935294498808,0.0254821753118244,
+                                0.3334935294498808,0.1205876951639246,0.0254821753118244,
+                                0.5459187753861946,0.3334935294498808,0.0254821753118244,
+                                0.3334935294498808,0.5459187753861946,0.0254821753118244,
+                                0.5459187753861946,0.1205876951639246,0.0254821753118244,
+                                0.1205876951639246,0.5459187753861946,0.0254821753118244,
+                                0.0005483600420423,0.9723607289627957,0.0012229481269611,
+                                0.9723607289627957,0.0005483600420423,0.0012229481269611,
+                                0.0270909109951620,0.9723607289627957,0.0012229481269611,
+                                0.9723607289627957,0.0270909109951620,0.0012229481269611,
+                                0.0270909109951620,0.0005483600420423,0.0012229481269611,
+                                0.0005483600420423,0.0270909109951620,0.0012229481269611,
+                                0.0919477421216432,0.8161045157567136,0.0165591599520032,
+                                0.8161045157567136,0.0919477421216432,0.0165591599520032,
+                                0.0919477421216432,0.0919477421216432,0.0165591599520032,
+                                0.3999556280675762,0.2000887438648475,0.0333044700333901,
+                                0.2000887438648475,0.3999556280675762,0.0333044700333901,
+                                0.3999556280675762,0.3999556280675762,0.0333044700333901};
+// 79 points
+double quad_2d_degree20[237] = {0.3333333333333333,0.3333333333333333,0.0039993788997574,
+                                0.4910287328831523,0.0179425342336954,0.0070342069381512,
+                                0.0179425342336954,0.4910287328831523,0.0070342069381512,
+                                0.4910287328831523,0.4910287328831523,0.0070342069381512,
+                                0.1710730529450310,0.6578538941099380,0.0154946460218468,
+                                0.6578538941099380,0.1710730529450310,0.0154946460218468,
+                                0.1710730529450310,0.1710730529450310,0.0154946460218468,
+                                0.1128192981663095,0.7743614036673809,0.0155014631660827,
+                                0.7743614036673809,0.1128192981663095,0.0155014631660827,
+                                0.1128192981663095,0.1128192981663095,0.0155014631660827,
+                                0.3758864721601428,0.2482270556797144,0.0309681278298588,
+                                0.2482270556797144,0.3758864721601428,0.0309681278298588,
+                                0.3758864721601428,0.3758864721601428,0.0309681278298588,
+                                0.0098828346121805,0.9802343307756389,0.0013286347276868,
+                                0.9802343307756389,0.0098828346121805,0.0013286347276868,
+                                0.0098828346121805,0.0098828346121805,0.0013286347276868,
+                                0.0332146614704592,0.9335706770590816,0.0038049196326369,
+                                0.9335706770590816,0.0332146614704592,0.0038049196326369,
+                                0.0332146614704592,0.0332146614704592,0.0038049196326369,
+                                0.0092819436195845,0.8350769726039190,0.0050342527465695,
+                                0.8350769726039190,0.0092819436195845,0.0050342527465695,
+                                0.1556410837764965,0.8350769726039190,0.0050342527465695,
+                                0.8350769726039190,0.1556410837764965,0.0050342527465695,
+                                0.1556410837764965,0.0092819436195845,0.0050342527465695,
+                                0.0092819436195845,0.1556410837764965,0.0050342527465695,
+                                0.0047458687513117,0.9318928269893005,0.0022085910844951,
+                                0.9318928269893005,0.0047458687513117,0.0022085910844951,
+                                0.0633613042593877,0.9318928269893005,0.0022085910844951,
+                                0.9318928269893005,0.0633613042593877,0.0022085910844951,
+                                0.0633613042593877,0.0047458687513117,0.0022085910844951,
+                                0.0047458687513117,0.0633613042593877,0.0022085910844951,
+                                0.8639064859194009,0.0957988905360909,0.0085430097944927,
+                                0.0957988905360909,0.8639064859194009,0.0085430097944927,
+                                0.0402946235445081,0.0957988905360909,0.0085430097944927,
+                                0.0957988905360909,0.0402946235445081,0.0085430097944927,
+                                0.0402946235445081,0.8639064859194009,0.0085430097944927,
+                                0.8639064859194009,0.0402946235445081,0.0085430097944927,
+                                0.0114605125253120,0.7179341043875486,0.0072402681593866,
+                                0.7179341043875486,0.0114605125253120,0.0072402681593866,
+                                0.2706053830871394,0.7179341043875486,0.0072402681593866,
+                                0.7179341043875486,0.2706053830871394,0.0072402681593866,
+                                0.2706053830871394,0.0114605125253120,0.0072402681593866,
+                                0.0114605125253120,0.2706053830871394,0.0072402681593866,
+                                0.3377643630552566,0.6098418141205828,0.0169415979314218,
+                                0.6098418141205828,0.3377643630552566,0.0169415979314218,
+                                0.0523938228241606,0.6098418141205828,0.0169415979314218,
+                                0.6098418141205828,0.0523938228241606,0.0169415979314218,
+                                0.0523938228241606,0.3377643630552566,0.0169415979314218,
+                                0.3377643630552566,0.0523938228241606,0.0169415979314218,
+                                0.1977918201892165,0.7470951415375225,0.0146609648636202,
+                                0.7470951415375225,0.1977918201892165,0.0146609648636202,
+                                0.0551130382732609,0.7470951415375225,0.0146609648636202,
+                                0.7470951415375225,0.0551130382732609,0.0146609648636202,
+                                0.0551130382732609,0.1977918201892165,0.0146609648636202,
+                                0.1977918201892165,0.0551130382732609,0.0146609648636202,
+                                0.5907629255741086,0.0082338651399416,0.0056124329032372,
+                                0.0082338651399416,0.5907629255741086,0.0056124329032372,
+                                0.4010032092859498,0.0082338651399416,0.0056124329032372,
+                                0.0082338651399416,0.4010032092859498,0.0056124329032372,
+                                0.4010032092859498,0.5907629255741086,0.0056124329032372,
+                                0.5907629255741086,0.4010032092859498,0.0056124329032372,
+                                0.1429650603188573,0.3573982543349525,0.0258272665529482,
+                                0.3573982543349525,0.1429650603188573,0.0258272665529482,
+                                0.4996366853461902,0.3573982543349525,0.0258272665529482,
+                                0.3573982543349525,0.4996366853461902,0.0258272665529482,
+                                0.4996366853461902,0.1429650603188573,0.0258272665529482,
+                                0.1429650603188573,0.4996366853461902,0.0258272665529482,
+                                0.6316359260750860,0.1194800485728805,0.0185793468810719,
+                                0.1194800485728805,0.6316359260750860,0.0185793468810719,
+                                0.2488840253520334,0.1194800485728805,0.0185793468810719,
+                                0.1194800485728805,0.2488840253520334,0.0185793468810719,
+                                0.2488840253520334,0.6316359260750860,0.0185793468810719,
+                                0.6316359260750860,0.2488840253520334,0.0185793468810719,
+                                0.4665118645088276,0.0669762709823448,0.0183277560242875,
+                                0.0669762709823448,0.4665118645088276,0.0183277560242875,
+                                0.4665118645088276,0.4665118645088276,0.0183277560242875,
+                                0.2439444749706498,0.5121110500587005,0.0302449908583769,
+                                0.5121110500587005,0.2439444749706498,0.0302449908583769,
+                                0.2439444749706498,0.2439444749706498,0.0302449908583769};
+// put them together: the rule of degree 2n for order n, and its number of
+// points. benchmark_quadrature checks each is exact to that degree.
+double *quad_2d[MAX_ORDER + 1] = {quad_2d_degree1,  quad_2d_degree2,  quad_2d_degree4,
+                                  quad_2d_degree6,  quad_2d_degree8,  quad_2d_degree10,
+                                  quad_2d_degree12, quad_2d_degree14, quad_2d_degree16,
+                                  quad_2d_degree18, quad_2d_degree20};
+int quad_2d_points[MAX_ORDER + 1] = {1, 3, 6, 12, 16, 25, 33, 42, 55, 67, 79};
 
 ////////////////////////////////////////
-// 1D Quadrature Rules
+// Gauss-Jacobi Rules
 ////////////////////////////////////////
 
-// order goes (r1, w1, r2, w2, ...)
-double quad_1d_degree1[2] = {0.0,2.0};
-double quad_1d_degree2[4] = {-1./1.7320508075688772,1.,
-                             1./1.7320508075688772,1.};
-double quad_1d_degree3[9] = {-0.7745966692414834, 5./9, 
-                           0., 8./9,
-                           0.7745966692414834, 5./9};
+/* jacobi
+ *
+ * the jacobi polynomial P_n^(alpha, beta) at x, by the three term recurrence.
+ */
+double jacobi(int n, double alpha, double beta, double x) {
+    int k;
+    double p0, p1, p2, a1, a2, a3, a4;
 
-double quad_1d_degree4[12] = {-0.8611363115940526, 0.34785484513745385,
-                           -0.3399810435848563, 0.6521451548625462,
-                           0.3399810435848563  ,0.6521451548625462, 
-                           0.8611363115940526,  0.34785484513745385};
-double quad_1d_degree5[15] = {-0.906179845938664, 0.23692688505618908,
-                           -0.5384693101056831, 0.47862867049936647,
-                           0., 128./225,
-                           0.5384693101056831,0.47862867049936647,
-                           0.906179845938664, 0.23692688505618908};
-double quad_1d_degree6[18] = {-0.93246951, 0.17132449,
-                           -0.66120939, 0.36076157,
-                           -0.23861918, 0.46791393,
-                           0.23861918, 0.46791393,
-                           0.66120939, 0.36076157,
-                           0.93246951, 0.17132449};
-double quad_1d_degree7[21] = {-0.94910791, 0.12948497,
-                           -0.74153119, 0.27970539,
-                           -0.40584515, 0.38183005,
-                            0., 0.41795918,
-                           0.40584515, 0.38183005,
-                           0.74153119, 0.27970539,
-                           0.94910791, 0.12948497};
-double quad_1d_degree8[24] = {-0.18343464, 0.36268378,
-                           -0.96028986, 0.10122854,
-                           -0.79666648, 0.22238103,
-                           -0.52553241, 0.31370665,
-                           0.18343464, 0.36268378,
-                           0.52553241, 0.31370665,
-                           0.79666648, 0.22238103,
-                           0.96028986, 0.10122854};
+    p0 = 1.;
+    if (n == 0) {
+        return p0;
+    }
+    p1 = 0.5 * (alpha - beta + (alpha + beta + 2.) * x);
 
-double *quad_1d[8] = {quad_1d_degree1, quad_1d_degree2, quad_1d_degree3,
-                    quad_1d_degree4, quad_1d_degree5, quad_1d_degree6,
-                    quad_1d_degree7, quad_1d_degree8};
+    for (k = 1; k < n; k++) {
+        a1 = 2. * (k + 1) * (k + alpha + beta + 1) * (2 * k + alpha + beta);
+        a2 = (2 * k + alpha + beta + 1) * (alpha * alpha - beta * beta);
+        a3 = (2 * k + alpha + beta) * (2 * k + alpha + beta + 1) * (2 * k + alpha + beta + 2);
+        a4 = 2. * (k + alpha) * (k + beta) * (2 * k + alpha + beta + 2);
+
+        p2 = ((a2 + a3 * x) * p1 - a4 * p0) / a1;
+        p0 = p1;
+        p1 = p2;
+    }
+
+    return p1;
+}
+
+/* jacobi derivative
+ *
+ * the derivative of P_n^(alpha, beta) at x.
+ */
+double jacobi_deriv(int n, double alpha, double beta, double x) {
+    if (n == 0) {
+        return 0.;
+    }
+    return 0.5 * (n + alpha + beta + 1) * jacobi(n - 1, alpha + 1, beta + 1, x);
+}
+
+/* gauss jacobi
+ *
+ * the q point gauss rule on [-1, 1] for the weight (1 - x)^alpha (1 + x)^beta,
+ * with the points ascending. the points are the roots of P_q^(alpha, beta),
+ * found by newton's method with the roots already found divided out.
+ */
+void gauss_jacobi(int q, double alpha, double beta, double *x, double *w_local) {
+    int i, k, iter;
+    double r, s, p, dp, delta, c;
+
+    for (k = 0; k < q; k++) {
+        // start from the chebyshev points, pulled toward the last root
+        r = -cos((2. * k + 1.) * M_PI / (2. * q));
+        if (k > 0) {
+            r = 0.5 * (r + x[k - 1]);
+        }
+
+        for (iter = 0; iter < 100; iter++) {
+            s = 0.;
+            for (i = 0; i < k; i++) {
+                s += 1. / (r - x[i]);
+            }
+            p  = jacobi(q, alpha, beta, r);
+            dp = jacobi_deriv(q, alpha, beta, r);
+
+            delta = -p / (dp - s * p);
+            r += delta;
+            if (fabs(delta) < 1e-15) {
+                break;
+            }
+        }
+        x[k] = r;
+    }
+
+    c = exp((alpha + beta + 1) * log(2.) 
+            + lgamma(q + alpha + 1) + lgamma(q + beta + 1)
+            - lgamma(q + 1.) - lgamma(q + alpha + beta + 1));
+    for (k = 0; k < q; k++) {
+        dp = jacobi_deriv(q, alpha, beta, x[k]);
+        w_local[k] = c / ((1. - x[k] * x[k]) * dp * dp);
+    }
+}
@@ -0,0 +1,567 @@
+/* renumber.c
+ *
+ * renumbers the elements and sides of the mesh so that neighbors end up close
+ * together in memory. meshes come out of the mesh generator in whatever order
+ * it made them, so the gathers in eval_surface jump all over the coefficient
+ * arrays. the elements can be put in reverse cuthill-mckee order or along a
+ * hilbert or morton space-filling curve through their centroids; the sides
+ * are then numbered in the order the new elements first touch them.
+ *
+ * whatever the ordering, the sides always end up grouped by boundary type.
+ */
+
+#define ORDER_NONE    0
+#define ORDER_RCM     1
+#define ORDER_HILBERT 2
+#define ORDER_MORTON  3
+
+// the ordering to use after reading a text or gmsh mesh
+int mesh_ordering = ORDER_NONE;
+
+char *ordering_names[] = {"none", "rcm", "hilbert", "morton"};
+
+/* parse ordering
+ *
+ * returns the ordering with this name or -1 if there isn't one.
+ */
+int parse_ordering(char *name) {
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        if (strcmp(name, ordering_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* neighbor
+ *
+ * returns the element on the other side of side s from element idx, or a
+ * negative number for boundary sides.
+ */
+int neighbor(int idx, int s, int *left_elem, int *right_elem) {
+    return (left_elem[s] == idx) ? right_elem[s] : left_elem[s];
+}
+
+/* rcm bfs
+ *
+ * breadth first search from start, visiting the neighbors of each element in
+ * order of increasing degree. appends the elements to order starting at pos
+ * and returns the new end of order.
+ */
+int rcm_bfs(int start, int pos, int *order, char *visited, int *degree,
+            int *elem_s1, int *elem_s2, int *elem_s3,
+            int *left_elem, int *right_elem) {
+    int head, k, j, idx, nbr, count;
+    int nbrs[3];
+    int *elem_s[3] = {elem_s1, elem_s2, elem_s3};
+
+    order[pos++] = start;
+    visited[start] = 1;
+
+    for (head = pos - 1; head < pos; head++) {
+        idx = order[head];
+
+        count = 0;
+        for (k = 0; k < 3; k++) {
+            nbr = neighbor(idx, elem_s[k][idx], left_elem, right_elem);
+            if (nbr >= 0 && !visited[nbr]) {
+                // insertion sort on degree
+                for (j = count; j > 0 && degree[nbrs[j - 1]] > degree[nbr]; j--) {
+                    nbrs[j] = nbrs[j - 1];
+                }
+                nbrs[j] = nbr;
+                count++;
+            }
+        }
+
+        for (k = 0; k < count; k++) {
+            order[pos++] = nbrs[k];
+            visited[nbrs[k]] = 1;
+        }
+    }
+
+    return pos;
+}
+
+/* rcm order
+ *
+ * reverse cuthill-mckee ordering of the element graph. each connected piece
+ * of the mesh starts from a pseudo-peripheral element, found by searching
+ * once from the lowest degree element and taking the last element reached.
+ */
+void rcm_order(int num_elem, int *order,
+               int *elem_s1, int *elem_s2, int *elem_s3,
+               int *left_elem, int *right_elem) {
+    int i, k, tmp, start, end, pos;
+    int *degree  = (int *) malloc(num_elem * sizeof(int));
+    char *visited = (char *) malloc(num_elem * sizeof(char));
+    int *elem_s[3] = {elem_s1, elem_s2, elem_s3};
+
+    for (i = 0; i < num_elem; i++) {
+        degree[i] = 0;
+        visited[i] = 0;
+        for (k = 0; k < 3; k++) {
+            if (neighbor(i, elem_s[k][i], left_elem, right_elem) >= 0) {
+                degree[i]++;
+            }
+        }
+    }
+
+    pos = 0;
+    while (pos < num_elem) {
+        // lowest degree element we haven't reached yet
+        start = -1;
+        for (i = 0; i < num_elem; i++) {
+            if (!visited[i] && (start == -1 || degree[i] < degree[start])) {
+                start = i;
+            }
+        }
+
+        // the last element reached from it is far away from everything
+        end = rcm_bfs(start, pos, order, visited, degree,
+                      elem_s1, elem_s2, elem_s3, left_elem, right_elem);
+        start = order[end - 1];
+        for (i = pos; i < end; i++) {
+            visited[order[i]] = 0;
+        }
+
+        pos = rcm_bfs(start, pos, order, visited, degree,
+                      elem_s1, elem_s2, elem_s3, left_elem, right_elem);
+    }
+
+    // reverse it
+    for (i = 0; i < num_elem / 2; i++) {
+        tmp = order[i];
+        order[i] = order[num_elem - 1 - i];
+        order[num_elem - 1 - i] = tmp;
+    }
+
+    free(degree);
+    free(visited);
+}
+
+/* morton key
+ *
+ * interleaves the bits of x and y.
+ */
+unsigned long long morton_key(unsigned int x, unsigned int y) {
+    int b;
+    unsigned long long key = 0;
+
+    for (b = 0; b < 16; b++) {
+        key |= (unsigned long long) ((x >> b) & 1) << (2 * b);
+        key |= (unsigned long long) ((y >> b) & 1) << (2 * b + 1);
+    }
+
+    return key;
+}
+
+/* hilbert key
+ *
+ * distance along the hilbert curve filling the 2^16 x 2^16 grid.
+ */
+unsigned long long hilbert_key(unsigned int x, unsigned int y) {
+    unsigned int s, rx, ry, tmp;
+    unsigned long long key = 0;
+
+    for (s = 1 << 15; s > 0; s >>= 1) {
+        rx = (x & s) > 0;
+        ry = (y & s) > 0;
+        key += (unsigned long long) s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            tmp = x;
+            x = y;
+            y = tmp;
+        }
+    }
+
+    return key;
+}
+
+typedef struct {
+    unsigned long long key;
+    int idx;
+} curve_point;
+
+int compare_curve_points(const void *a, const void *b) {
+    const curve_point *p = (const curve_point *) a;
+    const curve_point *q = (const curve_point *) b;
+
+    if (p->key != q->key) {
+        return (p->key < q->key) ? -1 : 1;
+    }
+    return p->idx - q->idx;
+}
+
+/* curve order
+ *
+ * sorts the elements by the position of their centroid along a hilbert or
+ * morton curve over the bounding box of the mesh.
+ */
+void curve_order(int ordering, int num_elem, int *order,
+                 double *V1x, double *V1y,
+                 double *V2x, double *V2y,
+                 double *V3x, double *V3y) {
+    int i;
+    unsigned int qx, qy;
+    double x, y, min_x, min_y, max_x, max_y, scale;
+    curve_point *points = (curve_point *) malloc(num_elem * sizeof(curve_point));
+
+    min_x = max_x = V1x[0];
+    min_y = max_y = V1y[0];
+    for (i = 0; i < num_elem; i++) {
+        x = (V1x[i] + V2x[i] + V3x[i]) / 3.;
+        y = (V1y[i] + V2y[i] + V3y[i]) / 3.;
+        min_x = (x < min_x) ? x : min_x;
+        max_x = (x > max_x) ? x : max_x;
+        min_y = (y < min_y) ? y : min_y;
+        max_y = (y > max_y) ? y : max_y;
+    }
+
+    // keep the aspect ratio so the curve doesn't get stretched
+    scale = (max_x - min_x > max_y - min_y) ? max_x - min_x : max_y - min_y;
+    scale = (scale > 0) ? 65535. / scale : 0.;
+
+    for (i = 0; i < num_elem; i++) {
+        x = (V1x[i] + V2x[i] + V3x[i]) / 3.;
+        y = (V1y[i] + V2y[i] + V3y[i]) / 3.;
+        qx = (unsigned int) ((x - min_x) * scale);
+        qy = (unsigned int) ((y - min_y) * scale);
+
+        points[i].key = (ordering == ORDER_HILBERT) ? hilbert_key(qx, qy) : morton_key(qx, qy);
+        points[i].idx = i;
+    }
+
+    qsort(points, num_elem, sizeof(curve_point), compare_curve_points);
+
+    for (i = 0; i < num_elem; i++) {
+        order[i] = points[i].idx;
+    }
+
+    free(points);
+}
+
+/* permute
+ *
+ * a[i] = a[order[i]] for doubles and ints. tmp holds n entries.
+ */
+void permute_doubles(double *a, int *order, int n, void *tmp) {
+    int i;
+    double *b = (double *) tmp;
+
+    for (i = 0; i < n; i++) {
+        b[i] = a[order[i]];
+    }
+    memcpy(a, b, n * sizeof(double));
+}
+
+void permute_ints(int *a, int *order, int n, void *tmp) {
+    int i;
+    int *b = (int *) tmp;
+
+    for (i = 0; i < n; i++) {
+        b[i] = a[order[i]];
+    }
+    memcpy(a, b, n * sizeof(int));
+}
+
+/* permute sides
+ *
+ * moves side side_order[i] to i and updates the side numbers of the elements.
+ */
+void permute_sides(int num_elem, int num_sides, int *side_order,
+                   int *left_side_number, int *right_side_number,
+                   double *sides_x1, double *sides_y1,
+                   double *sides_x2, double *sides_y2,
+                   int *elem_s1, int *elem_s2, int *elem_s3,
+                   int *left_elem, int *right_elem) {
+    int i, k;
+    int *elem_s[3] = {elem_s1, elem_s2, elem_s3};
+    int *new_side = (int *) malloc(num_sides * sizeof(int));
+    void *tmp     = malloc(num_sides * sizeof(double));
+
+    for (i = 0; i < num_sides; i++) {
+        new_side[side_order[i]] = i;
+    }
+
+    permute_doubles(sides_x1, side_order, num_sides, tmp);
+    permute_doubles(sides_y1, side_order, num_sides, tmp);
+    permute_doubles(sides_x2, side_order, num_sides, tmp);
+    permute_doubles(sides_y2, side_order, num_sides, tmp);
+    permute_ints(left_side_number,  side_order, num_sides, tmp);
+    permute_ints(right_side_number, side_order, num_sides, tmp);
+    permute_ints(left_elem,  side_order, num_sides, tmp);
+    permute_ints(right_elem, side_order, num_sides, tmp);
+
+    for (i = 0; i < num_elem; i++) {
+        for (k = 0; k < 3; k++) {
+            elem_s[k][i] = new_side[elem_s[k][i]];
+        }
+    }
+
+    free(new_side);
+    free(tmp);
+}
+
+/* renumber mesh
+ *
+ * reorders the host mesh arrays made by read_mesh. element i of the new mesh
+ * is element order[i] of the old one, and the sides are numbered as the new
+ * elements first reach them. left and right stay the same, so every flux is
+ * computed exactly as before; only where it's stored changes.
+ */
+void renumber_mesh(int ordering, int num_elem, int num_sides,
+                   double *V1x, double *V1y,
+                   double *V2x, double *V2y,
+                   double *V3x, double *V3y,
+                   int *left_side_number, int *right_side_number,
+                   double *sides_x1, double *sides_y1,
+                   double *sides_x2, double *sides_y2,
+                   int *elem_s1, int *elem_s2, int *elem_s3,
+                   int *left_elem, int *right_elem) {
+    int i, k, s, num_new;
+    int *elem_s[3] = {elem_s1, elem_s2, elem_s3};
+
+    int *order      = (int *) malloc(num_elem * sizeof(int));
+    int *new_elem   = (int *) malloc(num_elem * sizeof(int));
+    int *side_order = (int *) malloc(num_sides * sizeof(int));
+    char *reached   = (char *) malloc(num_sides * sizeof(char));
+    void *tmp       = malloc(num_elem * sizeof(double));
+
+    switch (ordering) {
+        case ORDER_RCM:
+            rcm_order(num_elem, order, elem_s1, elem_s2, elem_s3, left_elem, right_elem);
+            break;
+        case ORDER_HILBERT:
+        case ORDER_MORTON:
+            curve_order(ordering, num_elem, order, V1x, V1y, V2x, V2y, V3x, V3y);
+            break;
+        default:
+            for (i = 0; i < num_elem; i++) {
+                order[i] = i;
+            }
+    }
+
+    for (i = 0; i < num_elem; i++) {
+        new_elem[order[i]] = i;
+    }
+
+    // move the elements
+    permute_doubles(V1x, order, num_elem, tmp);
+    permute_doubles(V1y, order, num_elem, tmp);
+    permute_doubles(V2x, order, num_elem, tmp);
+    permute_doubles(V2y, order, num_elem, tmp);
+    permute_doubles(V3x, order, num_elem, tmp);
+    permute_doubles(V3y, order, num_elem, tmp);
+    permute_ints(elem_s1, order, num_elem, tmp);
+    permute_ints(elem_s2, order, num_elem, tmp);
+    permute_ints(elem_s3, order, num_elem, tmp);
+
+    for (s = 0; s < num_sides; s++) {
+        left_elem[s] = new_elem[left_elem[s]];
+        if (right_elem[s] >= 0) {
+            right_elem[s] = new_elem[right_elem[s]];
+        }
+    }
+
+    // number the sides as the new elements reach them
+    memset(reached, 0, num_sides * sizeof(char));
+    num_new = 0;
+    for (i = 0; i < num_elem; i++) {
+        for (k = 0; k < 3; k++) {
+            s = elem_s[k][i];
+            if (!reached[s]) {
+                side_order[num_new++] = s;
+                reached[s] = 1;
+            }
+        }
+    }
+
+    permute_sides(num_elem, num_sides, side_order,
+                  left_side_number, right_side_number,
+                  sides_x1, sides_y1, sides_x2, sides_y2,
+                  elem_s1, elem_s2, elem_s3,
+                  left_elem, right_elem);
+
+    free(order);
+    free(new_elem);
+    free(side_order);
+    free(reached);
+    free(tmp);
+}
+
+/* side group
+ *
+ * the group a side is sorted into: 0 for interior sides, k for boundary
+ * type -k.
+ */
+int side_group(int right) {
+    return (right >= 0) ? 0 : -right;
+}
+
+/* color sides
+ *
+ * greedy coloring of the sides visited in the given order: each side gets
+ * the smallest color that none of the sides already colored in its group on
+ * its left or right element has. sides of one color in a group then never
+ * share an element, so a color can scatter into the element residual in
+ * parallel. an element has three sides, so a side shares an element with at
+ * most four others and five colors always do. visiting the sides in the
+ * order they already have after sorting by color gives back the same colors.
+ */
+void color_sides(int num_sides, int *order,
+                 int *elem_s1, int *elem_s2, int *elem_s3,
+                 int *left_elem, int *right_elem, int *color) {
+    int i, j, k, s, e, other, used;
+    int elem[2];
+
+    for (i = 0; i < num_sides; i++) {
+        color[i] = -1;
+    }
+
+    for (i = 0; i < num_sides; i++) {
+        s = order ? order[i] : i;
+        elem[0] = left_elem[s];
+        elem[1] = right_elem[s];
+
+        used = 0;
+        for (j = 0; j < 2; j++) {
+            e = elem[j];
+            if (e < 0) {
+                continue;
+            }
+            for (k = 0; k < 3; k++) {
+                other = (k == 0) ? elem_s1[e] : (k == 1) ? elem_s2[e] : elem_s3[e];
+                if (other != s && color[other] >= 0
+                    && side_group(right_elem[other]) == side_group(right_elem[s])) {
+                    used |= 1 << color[other];
+                }
+            }
+        }
+
+        for (k = 0; used & (1 << k); k++);
+        color[s] = k;
+    }
+}
+
+/* sort sides
+ *
+ * groups the sides into [interior | reflecting | outflow | inflow] without
+ * changing their order within each group, so eval_surface can run the
+ * interior sides without checking for boundaries. each group is then sorted
+ * by color (see color_sides), keeping the order within each color.
+ */
+void sort_sides(int num_elem, int num_sides,
+                int *left_side_number, int *right_side_number,
+                double *sides_x1, double *sides_y1,
+                double *sides_x2, double *sides_y2,
+                int *elem_s1, int *elem_s2, int *elem_s3,
+                int *left_elem, int *right_elem) {
+    int i, j, k, pos, start;
+    int *group_order = (int *) malloc(num_sides * sizeof(int));
+    int *side_order  = (int *) malloc(num_sides * sizeof(int));
+    int *color       = (int *) malloc(num_sides * sizeof(int));
+
+    pos = 0;
+    for (k = 0; k < 4; k++) {
+        for (i = 0; i < num_sides; i++) {
+            if ((k == 0 && right_elem[i] >= 0) || right_elem[i] == -k) {
+                group_order[pos++] = i;
+            }
+        }
+    }
+
+    color_sides(num_sides, group_order,
+                elem_s1, elem_s2, elem_s3,
+                left_elem, right_elem, color);
+
+    // stable sort of each group by color
+    pos = 0;
+    for (start = 0; start < num_sides; start = i) {
+        for (i = start; i < num_sides
+             && side_group(right_elem[group_order[i]]) == side_group(right_elem[group_order[start]]); i++);
+        for (k = 0; k < MAX_COLORS; k++) {
+            for (j = start; j < i; j++) {
+                if (color[group_order[j]] == k) {
+                    side_order[pos++] = group_order[j];
+                }
+            }
+        }
+    }
+
+    permute_sides(num_elem, num_sides, side_order,
+                  left_side_number, right_side_number,
+                  sides_x1, sides_y1, sides_x2, sides_y2,
+                  elem_s1, elem_s2, elem_s3,
+                  left_elem, right_elem);
+
+    free(group_order);
+    free(side_order);
+    free(color);
+}
+
+/* find side ranges
+ *
+ * sets side_ranges, num_colors and color_ranges from sides sorted by
+ * sort_sides. the colors are found again with color_sides, which gives the
+ * same colors for sides that are already sorted. returns 1 if they aren't
+ * sorted.
+ */
+int find_side_ranges(int num_sides,
+                     int *elem_s1, int *elem_s2, int *elem_s3,
+                     int *left_elem, int *right_elem) {
+    int i, j, k;
+    int *color;
+
+    side_ranges[0] = 0;
+    for (k = 1; k < 4; k++) {
+        // first side of type -k or later
+        for (i = side_ranges[k - 1]; i < num_sides && right_elem[i] > -k; i++);
+        side_ranges[k] = i;
+    }
+    side_ranges[4] = num_sides;
+
+    // everything left over should be an inflow side
+    for (k = 0; k < 4; k++) {
+        for (i = side_ranges[k]; i < side_ranges[k + 1]; i++) {
+            if ((k == 0) ? right_elem[i] < 0 : right_elem[i] != -k) {
+                return 1;
+            }
+        }
+    }
+
+    color = (int *) malloc(num_sides * sizeof(int));
+    color_sides(num_sides, NULL, elem_s1, elem_s2, elem_s3,
+                left_elem, right_elem, color);
+
+    // each group should run through its colors in order
+    for (k = 0; k < 4; k++) {
+        num_colors[k] = 0;
+        color_ranges[k][0] = side_ranges[k];
+        for (i = side_ranges[k]; i < side_ranges[k + 1]; i++) {
+            if (color[i] < num_colors[k] - 1 || color[i] >= MAX_COLORS) {
+                free(color);
+                return 1;
+            }
+            // start the colors up to this one here
+            for (j = num_colors[k]; j <= color[i]; j++) {
+                color_ranges[k][j] = i;
+            }
+            num_colors[k] = (color[i] + 1 > num_colors[k]) ? color[i] + 1 : num_colors[k];
+        }
+        color_ranges[k][num_colors[k]] = side_ranges[k + 1];
+    }
+
+    free(color);
+
+    return 0;
+}
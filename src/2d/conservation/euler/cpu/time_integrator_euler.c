@@ -8,6 +8,62 @@
 
 #define TOL 10e-15
 
+#define INTEGRATOR_RK4    0
+#define INTEGRATOR_LSRK3  1
+#define INTEGRATOR_LSRK4  2
+#define INTEGRATOR_RK2    3
+#define INTEGRATOR_SSPRK3 4
+#define INTEGRATOR_FE     5
+#define INTEGRATOR_LTS    6
+
+// the time integrator time_integrate runs. init_gpu only allocates the
+// stage storage this one needs.
+int time_integrator = INTEGRATOR_RK4;
+
+char *integrator_names[] = {"rk4", "lsrk3", "lsrk4", "rk2", "ssprk3", "fe", "lts"};
+
+/* parse integrator
+ *
+ * returns the time integrator with this name or -1 if there isn't one.
+ */
+int parse_integrator(char *name) {
+    int i;
+
+    for (i = 0; i < (int) (sizeof(integrator_names) / sizeof(char *)); i++) {
+        if (strcmp(name, integrator_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// how time_integrate_rk4 runs its threads: every kernel forking and joining
+// its own, or one team for the whole run (see THREAD TEAM in
+// euler_kernels.c). the other integrators always fork and join.
+#define THREADS_FORKJOIN 0
+#define THREADS_TEAM     1
+
+int thread_backend = THREADS_FORKJOIN;
+
+char *thread_backend_names[] = {"forkjoin", "team"};
+
+/* parse thread backend
+ *
+ * returns the thread backend with this name or -1 if there isn't one.
+ */
+int parse_thread_backend(char *name) {
+    int i;
+
+    for (i = 0; i < (int) (sizeof(thread_backend_names) / sizeof(char *)); i++) {
+        if (strcmp(name, thread_backend_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 /***********************
  * RK4 
  ***********************/
@@ -20,7 +76,8 @@ void rk4_tempstorage(double *c, double *kstar, double*k, double alpha, int n_p,
 
     int idx;
 
-    for (idx = 0; idx < 4 * n_p * num_elem; idx++) {
+    #pragma omp parallel for
+    for (idx = 0; idx < num_coeffs; idx++) {
         kstar[idx] = c[idx] + alpha * k[idx];
     }
 }
@@ -33,11 +90,135 @@ void rk4_tempstorage(double *c, double *kstar, double*k, double alpha, int n_p,
 void rk4(double *c, double *k1, double *k2, double *k3, double *k4, int n_p, int num_elem) {
     int idx;
 
-    for (idx = 0; idx < n_p * num_elem; idx++) {
-        c[num_elem * n_p * 0 + idx] += k1[num_elem * n_p * 0 + idx]/6. + k2[num_elem * n_p * 0 + idx]/3. + k3[num_elem * n_p * 0 + idx]/3. + k4[num_elem * n_p * 0 + idx]/6.;
-        c[num_elem * n_p * 1 + idx] += k1[num_elem * n_p * 1 + idx]/6. + k2[num_elem * n_p * 1 + idx]/3. + k3[num_elem * n_p * 1 + idx]/3. + k4[num_elem * n_p * 1 + idx]/6.;
-        c[num_elem * n_p * 2 + idx] += k1[num_elem * n_p * 2 + idx]/6. + k2[num_elem * n_p * 2 + idx]/3. + k3[num_elem * n_p * 2 + idx]/3. + k4[num_elem * n_p * 2 + idx]/6.;
-        c[num_elem * n_p * 3 + idx] += k1[num_elem * n_p * 3 + idx]/6. + k2[num_elem * n_p * 3 + idx]/3. + k3[num_elem * n_p * 3 + idx]/3. + k4[num_elem * n_p * 3 + idx]/6.;
+    #pragma omp parallel for
+    for (idx = 0; idx < num_coeffs; idx++) {
+        c[idx] += k1[idx]/6. + k2[idx]/3. + k3[idx]/3. + k4[idx]/6.;
+    }
+}
+
+/* fused rk4 stage
+ *
+ * does everything between the residual of one rk4 stage and the input to the
+ * next in a single pass over the elements. with k = dt / J * rhs,
+ *
+ *      stage 1:  kstar = c + k / 2    acc  = c + k / 6
+ *      stage 2:  kstar = c + k / 2    acc += k / 3
+ *      stage 3:  kstar = c + k        acc += k / 3
+ *      stage 4:  c     = acc + k / 6
+ *
+ * so the k_i are never stored: each stage reads rhs, c and acc and writes
+ * kstar and acc, instead of eval_rhs_rk4 writing k_i, rk4_tempstorage reading
+ * it back with c and rk4 reading all five arrays at the end.
+ *
+ * the elements are taken STAGE_TILE at a time and each coefficient is swept
+ * across the tile, so every array is read in contiguous runs rather than
+ * 4 * n_p strided streams per element.
+ *
+ * if min_dt isn't NULL, the last stage also returns the next step's cfl limit
+ * in it and the largest wave speed in max_l (see stage_cfl). rk4_stage_share
+ * does the tiles from first up to last and folds only theirs in; in the
+ * thread team, team_reduce combines them, so every thread gets the same
+ * limit.
+ * THREADS: num_elem / STAGE_TILE
+ */
+#define STAGE_TILE 64
+
+/* stage cfl
+ *
+ * folds the wave speeds of the elements tile to end, whose new coefficients
+ * the last stage of a step has just written to c, into min_dt and max_l like
+ * eval_global_cfl does. the tile's cell averages are still in cache, so the
+ * next step gets its dt without another pass over c.
+ */
+void stage_cfl(double *c, int *base, int tile, int end, int n_p,
+               double *min_dt, double *max_l) {
+    int idx;
+    double lambda;
+
+    for (idx = tile; idx < end; idx++) {
+        lambda  = wave_speed(c, base[idx - tile], n_p, idx);
+        *min_dt = (d_radius[idx] / lambda < *min_dt) ? d_radius[idx] / lambda : *min_dt;
+        *max_l  = (lambda > *max_l) ? lambda : *max_l;
+    }
+}
+
+void rk4_stage_share(double *c, double *kstar, double *acc, double *quad_rhs, double *J,
+                     double dt, int stage, int n_p, int num_elem, int first, int last,
+                     double *min_dt, double *max_l) {
+    int tile;
+
+    for (tile = first; tile < last; tile += STAGE_TILE) {
+        int end = (tile + STAGE_TILE < num_elem) ? tile + STAGE_TILE : num_elem;
+        int base[STAGE_TILE];
+        double scale[STAGE_TILE];
+        double k;
+        int idx, i, pos;
+
+        for (idx = tile; idx < end; idx++) {
+            base[idx - tile]  = coeff_base(idx, n_p);
+            scale[idx - tile] = 1. / J[idx] * dt;
+        }
+
+        for (i = 0; i < 4 * n_p; i++) {
+            for (idx = 0; idx < end - tile; idx++) {
+                pos = base[idx] + i * elem_block;
+                k   = scale[idx] * quad_rhs[pos];
+                switch (stage) {
+                    case 1:
+                        kstar[pos] = c[pos] + 0.5 * k;
+                        acc[pos]   = c[pos] + k / 6.;
+                        break;
+                    case 2:
+                        kstar[pos] = c[pos] + 0.5 * k;
+                        acc[pos]  += k / 3.;
+                        break;
+                    case 3:
+                        kstar[pos] = c[pos] + k;
+                        acc[pos]  += k / 3.;
+                        break;
+                    default:
+                        c[pos] = acc[pos] + k / 6.;
+                }
+            }
+        }
+
+        if (min_dt) {
+            stage_cfl(c, base, tile, end, n_p, min_dt, max_l);
+        }
+    }
+}
+
+void rk4_stage(double *c, double *kstar, double *acc, double *quad_rhs, double *J,
+               double dt, int stage, int n_p, int num_elem,
+               double *min_dt, double *max_l) {
+    double step_dt = HUGE_VAL;
+    double step_l  = 0.;
+    int first, last;
+
+    if (team_threads) {
+        thread_range(0, num_elem, STAGE_TILE, &first, &last);
+        rk4_stage_share(c, kstar, acc, quad_rhs, J, dt, stage, n_p, num_elem, first, last,
+                        min_dt ? &step_dt : NULL, &step_l);
+        if (min_dt) {
+            team_reduce(&step_dt, &step_l);
+        } else {
+            team_barrier();
+        }
+    } else {
+        #pragma omp parallel private(first, last) reduction(min:step_dt) reduction(max:step_l)
+        {
+            thread_range(0, num_elem, STAGE_TILE, &first, &last);
+            rk4_stage_share(c, kstar, acc, quad_rhs, J, dt, stage, n_p, num_elem, first, last,
+                            min_dt ? &step_dt : NULL, &step_l);
+        }
+    }
+
+    if (min_dt) {
+        *min_dt = step_dt;
+        *max_l  = step_l;
+        if (thread_rank() == 0) {
+            wave_speed_fused++;
+        }
     }
 }
 
@@ -47,10 +228,12 @@ void sanity_check(double *c, int num_elem, int n_p) {
     int idx;
 
     for (idx = 0; idx < num_elem; idx++) {
-        rho_avg = c[num_elem * n_p * 0 + idx] * 1.414213562373095E+00;
-        u_avg   = c[num_elem * n_p * 1 + idx] * 1.414213562373095E+00;
-        v_avg   = c[num_elem * n_p * 2 + idx] * 1.414213562373095E+00;
-        E_avg   = c[num_elem * n_p * 3 + idx] * 1.414213562373095E+00;
+        int base = coeff_base(idx, n_p);
+
+        rho_avg = c[base + 0 * n_p * elem_block] * 1.414213562373095E+00;
+        u_avg   = c[base + 1 * n_p * elem_block] * 1.414213562373095E+00;
+        v_avg   = c[base + 2 * n_p * elem_block] * 1.414213562373095E+00;
+        E_avg   = c[base + 3 * n_p * elem_block] * 1.414213562373095E+00;
 
         u_avg = u_avg / rho_avg;
         v_avg = v_avg / rho_avg;
@@ -61,205 +244,245 @@ void sanity_check(double *c, int num_elem, int n_p) {
 
 /* right hand side
  *
- * computes the sum of the quadrature and the riemann flux for the 
- * coefficients for each element
+ * scales the residual, which holds the quadrature and the riemann flux
+ * contributions, by dt / J for the coefficients for each element
  * THREADS: num_elem
  */
-void eval_rhs_rk4(double *c, double *quad_rhs, double *left_riemann_rhs, double *right_riemann_rhs, 
-                  int *elem_s1, int *elem_s2, int *elem_s3,
-                  int *left_elem, double *J, 
-                  double dt, int n_p, int num_sides, int num_elem) {
+void eval_rhs_rk4(double *c, double *quad_rhs, double *J, 
+                  double dt, int n_p, int num_elem) {
     int idx;
-
-    double s1_eqn1, s2_eqn1, s3_eqn1;
-    double s1_eqn2, s2_eqn2, s3_eqn2;
-    double s1_eqn3, s2_eqn3, s3_eqn3;
-    double s1_eqn4, s2_eqn4, s3_eqn4;
     double register_J;
-    int i, s1_idx, s2_idx, s3_idx;
+    int i;
 
+    #pragma omp parallel for private(i, register_J)
     for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
 
         register_J = J[idx];
 
-        // get the indicies for the riemann contributions for this element
-        s1_idx = elem_s1[idx];
-        s2_idx = elem_s2[idx];
-        s3_idx = elem_s3[idx];
-
-        for (i = 0; i < n_p; i++) {
-
-            // determine left or right pointing
-            if (idx == left_elem[s1_idx]) {
-                s1_eqn1 = left_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s1_idx];
-                s1_eqn2 = left_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s1_idx];
-                s1_eqn3 = left_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s1_idx];
-                s1_eqn4 = left_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s1_idx];
-            } else {
-                s1_eqn1 = right_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s1_idx];
-                s1_eqn2 = right_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s1_idx];
-                s1_eqn3 = right_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s1_idx];
-                s1_eqn4 = right_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s1_idx];
-            }
+        // calculate the coefficient c
+        for (i = 0; i < 4 * n_p; i++) {
+            c[base + i * elem_block] = 1. / register_J * dt * quad_rhs[base + i * elem_block];
+        }
+    }
+}
 
-            if (idx == left_elem[s2_idx]) {
-                s2_eqn1 = left_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s2_idx];
-                s2_eqn2 = left_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s2_idx];
-                s2_eqn3 = left_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s2_idx];
-                s2_eqn4 = left_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s2_idx];
-            } else {
-                s2_eqn1 = right_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s2_idx];
-                s2_eqn2 = right_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s2_idx];
-                s2_eqn3 = right_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s2_idx];
-                s2_eqn4 = right_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s2_idx];
-            }
+/***********************
+ * KERNEL DISPATCH
+ ***********************/
 
-            if (idx == left_elem[s3_idx]) {
-                s3_eqn1 = left_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s3_idx];
-                s3_eqn2 = left_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s3_idx];
-                s3_eqn3 = left_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s3_idx];
-                s3_eqn4 = left_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s3_idx];
-            } else {
-                s3_eqn1 = right_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s3_idx];
-                s3_eqn2 = right_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s3_idx];
-                s3_eqn3 = right_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s3_idx];
-                s3_eqn4 = right_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s3_idx];
-            }
+typedef void (*surface_ftn)(double*, double*,
+                            double*,
+                            double*, double*,
+                            double*, double*,
+                            double*, double*,
+                            int*, int*,
+                            int*, int*,
+                            double*, double*,
+                            int, int, int, int, int, double);
+
+typedef void (*volume_ftn)(double*, double*,
+                           double*, double*, double*, double*,
+                           int, int, int);
+
+// the kernels specialized for each order, indexed by n
+surface_ftn surface_ftns[] = {eval_surface_0, eval_surface_1, eval_surface_2,
+                              eval_surface_3, eval_surface_4, eval_surface_5};
+volume_ftn  volume_ftns[]  = {eval_volume_0, eval_volume_1, eval_volume_2,
+                              eval_volume_3, eval_volume_4, eval_volume_5};
+
+/* dispatch functions
+ *
+ * picks the kernels for order n: the specialized ones if there are any,
+ * otherwise the generic kernels. the volume and surface kernels are the
+ * vector ones for vector_isa instead, if that isn't scalar, and the gemm
+ * ones if kernel_form says so. for the tensor form the surface kernel is
+ * the dense vector one, which beats the scalar tensor one (the sums only
+ * factor on side 2), if there's a vector_isa.
+ */
+void dispatch_functions(surface_ftn *eval_surface_ftn,
+                        volume_ftn  *eval_volume_ftn, int n) {
+    if (n >= 0 && n < (int) (sizeof(surface_ftns) / sizeof(surface_ftn))) {
+        *eval_surface_ftn = surface_ftns[n];
+        *eval_volume_ftn  = volume_ftns[n];
+    } else {
+        *eval_surface_ftn = eval_surface;
+        *eval_volume_ftn  = eval_volume;
+    }
 
-            // calculate the coefficient c
-            c[num_elem * n_p * 0 + i * num_elem + idx] = 1. / register_J * dt * (quad_rhs[num_elem * n_p * 0 + i * num_elem + idx] + s1_eqn1 + s2_eqn1 + s3_eqn1);
-            c[num_elem * n_p * 1 + i * num_elem + idx] = 1. / register_J * dt * (quad_rhs[num_elem * n_p * 1 + i * num_elem + idx] + s1_eqn2 + s2_eqn2 + s3_eqn2);
-            c[num_elem * n_p * 2 + i * num_elem + idx] = 1. / register_J * dt * (quad_rhs[num_elem * n_p * 2 + i * num_elem + idx] + s1_eqn3 + s2_eqn3 + s3_eqn3);
-            c[num_elem * n_p * 3 + i * num_elem + idx] = 1. / register_J * dt * (quad_rhs[num_elem * n_p * 3 + i * num_elem + idx] + s1_eqn4 + s2_eqn4 + s3_eqn4);
-        }
+    if (vector_isa < 0) {
+        vector_isa = detect_isa();
+    }
+    // every branch below replaces the specialized kernels, so they only run
+    // with the loop form on a scalar vector_isa (-V scalar on a vector cpu)
+    if (vector_isa == ISA_AVX512 && kernel_form == FORM_TENSOR) {
+        *eval_surface_ftn = eval_surface_avx512;
+        *eval_volume_ftn  = eval_volume_tensor_avx512;
+    } else if (vector_isa == ISA_AVX2 && kernel_form == FORM_TENSOR) {
+        *eval_surface_ftn = eval_surface_avx2;
+        *eval_volume_ftn  = eval_volume_tensor_avx2;
+    } else if (kernel_form == FORM_TENSOR) {
+        *eval_surface_ftn = eval_surface_tensor;
+        *eval_volume_ftn  = eval_volume_tensor;
+    } else if (vector_isa == ISA_AVX512 && kernel_form == FORM_GEMM) {
+        *eval_surface_ftn = eval_surface_gemm_avx512;
+        *eval_volume_ftn  = eval_volume_gemm_avx512;
+    } else if (vector_isa == ISA_AVX512) {
+        *eval_surface_ftn = eval_surface_avx512;
+        *eval_volume_ftn  = eval_volume_avx512;
+    } else if (vector_isa == ISA_AVX2 && kernel_form == FORM_GEMM) {
+        *eval_surface_ftn = eval_surface_gemm_avx2;
+        *eval_volume_ftn  = eval_volume_gemm_avx2;
+    } else if (vector_isa == ISA_AVX2) {
+        *eval_surface_ftn = eval_surface_avx2;
+        *eval_volume_ftn  = eval_volume_avx2;
     }
 }
 
-void time_integrate_rk4(int n_quad, int n_quad1d, int n_p, int n, int num_elem, int num_sides,
-                        double endtime, double min_r) {
-    int n_threads = 128;
+/* order scale
+ *
+ * what the cfl limit of an element is divided by for order n. 2n + 1 is the
+ * step the solver has always taken. past order 7 it's no longer stable: rk4
+ * on the sv1 supersonic meshes went unphysical within a few dozen steps at
+ * n = 8 with every kernel form. the largest eigenvalues of the dg operator
+ * grow with n^2, so the step also shrinks by (n + 1)^2 / 64 there, which is
+ * 1 at n = 7 and keeps n = 8 to 10 running on those meshes.
+ *
+ * the cutoff at n = 7 is empirical, tuned on those runs. it's only there to
+ * keep the steps the lower orders have always taken; a single (n + 1)^2
+ * rule would shrink them all.
+ */
+#define ORDER_SCALE_CUTOFF 7
+
+double order_scale(int n) {
+    if (n > ORDER_SCALE_CUTOFF) {
+        return (2. * n + 1.) * (n + 1.) * (n + 1.)
+             / ((ORDER_SCALE_CUTOFF + 1.) * (ORDER_SCALE_CUTOFF + 1.));
+    }
+    return 2. * n + 1.;
+}
+
+/* find max lambda
+ *
+ * the largest wave speed eval_global_lambda left in lambda.
+ */
+double find_max_lambda(double *lambda, int num_elem) {
     int i;
-    double dt, t;
+    double max_l = lambda[0];
 
-    double max_l;
-    double *max_lambda = (double *) malloc(num_elem * sizeof(double));
-    double *c = (double *) malloc(num_elem * n_p * 4 * sizeof(double));
+    #pragma omp parallel for reduction(max:max_l)
+    for (i = 0; i < num_elem; i++) {
+        max_l = (lambda[i] > max_l) ? lambda[i] : max_l;
+    }
 
-    t = 0;
+    return max_l;
+}
+
+/* rk4 steps
+ *
+ * the time loop of time_integrate_rk4, from the cfl limit min_dt and the
+ * largest wave speed max_l of the initial condition. in the thread team
+ * every thread runs it with its own t and dt, which stay the same on all of
+ * them, since rk4_stage gives them all the same cfl limit.
+ */
+void rk4_steps(surface_ftn eval_surface_ftn, volume_ftn eval_volume_ftn,
+               int n_quad, int n_quad1d, int n_p, int n, int num_elem, int num_sides,
+               double endtime, double min_dt, double max_l) {
+    double dt = 0.;
+    double t  = 0.;
 
     double convergence = 1 + TOL;
 
     while (t < endtime && convergence > TOL) {
-        sanity_check(d_c, num_elem, n_p);
-        //printf("starting rk4...\n");
-        // compute all the lambda values over each cell
-        eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
-
-        // find the max value of lambda
-        memcpy(max_lambda, d_lambda, num_elem * sizeof(double));
-        max_l = max_lambda[0];
-        for (i = 0; i < num_elem; i++) {
-            max_l = (max_lambda[i] > max_l) ? max_lambda[i] : max_l;
+        if (thread_rank() == 0) {
+            sanity_check(d_c, num_elem, n_p);
         }
+        //printf("starting rk4...\n");
 
         // keep CFL condition
         if (t + dt > endtime) {
             dt = endtime - t;
             t = endtime;
         } else {
-            dt  = 0.7 * min_r / max_l /  (2. * n + 1.);
+            dt  = 0.7 * min_dt / order_scale(n);
             t += dt;
         }
 
-        printf(" > (%lf), t = %lf\n", max_l, t);
+        if (thread_rank() == 0) {
+            printf(" > (%lf), t = %lf\n", max_l, t);
+        }
 
         // stage 1
         //printf("stage 1 ...\n");
-        eval_surface(d_c, d_left_riemann_rhs, d_right_riemann_rhs, 
-                     d_s_length, 
-                     d_V1x, d_V1y,
-                     d_V2x, d_V2y,
-                     d_V3x, d_V3y,
-                     d_left_elem, d_right_elem,
-                     d_left_side_number, d_right_side_number,
-                     d_Nx, d_Ny, 
-                     n_quad1d, n_quad, n_p, num_sides, num_elem, t);
-
-        eval_volume(d_c, d_quad_rhs, 
-                    d_xr, d_yr, d_xs, d_ys,
-                    n_quad, n_p, num_elem);
-
-        eval_rhs_rk4(d_k1, d_quad_rhs, d_left_riemann_rhs, d_right_riemann_rhs, 
-                     d_elem_s1, d_elem_s2, d_elem_s3, 
-                     d_left_elem, d_J, dt, n_p, num_sides, num_elem);
-
-        rk4_tempstorage(d_c, d_kstar, d_k1, 0.5, n_p, num_elem);
+        eval_volume_ftn(d_c, d_quad_rhs, 
+                        d_xr, d_yr, d_xs, d_ys,
+                        n_quad, n_p, num_elem);
 
-        // stage 2
-        eval_surface(d_kstar, d_left_riemann_rhs, d_right_riemann_rhs, 
-                     d_s_length, 
-                     d_V1x, d_V1y,
-                     d_V2x, d_V2y,
-                     d_V3x, d_V3y,
-                     d_left_elem, d_right_elem,
-                     d_left_side_number, d_right_side_number,
-                     d_Nx, d_Ny, 
-                     n_quad1d, n_quad, n_p, num_sides, num_elem, t);
+        eval_surface_ftn(d_c, d_quad_rhs, 
+                         d_s_length,
+                         d_V1x, d_V1y,
+                         d_V2x, d_V2y,
+                         d_V3x, d_V3y,
+                         d_left_elem, d_right_elem,
+                         d_left_side_number, d_right_side_number,
+                         d_Nx, d_Ny,
+                         n_quad1d, n_quad, n_p, num_sides, num_elem, t);
+
+        rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, 1, n_p, num_elem, NULL, NULL);
 
-        eval_volume(d_kstar, d_quad_rhs, 
-                    d_xr, d_yr, d_xs, d_ys,
-                    n_quad, n_p, num_elem);
+        // stage 2
+        eval_volume_ftn(d_kstar, d_quad_rhs, 
+                        d_xr, d_yr, d_xs, d_ys,
+                        n_quad, n_p, num_elem);
 
-        eval_rhs_rk4(d_k2, d_quad_rhs, d_left_riemann_rhs, d_right_riemann_rhs,
-                     d_elem_s1, d_elem_s2, d_elem_s3, 
-                     d_left_elem, d_J, dt, n_p, num_sides, num_elem);
+        eval_surface_ftn(d_kstar, d_quad_rhs, 
+                         d_s_length,
+                         d_V1x, d_V1y,
+                         d_V2x, d_V2y,
+                         d_V3x, d_V3y,
+                         d_left_elem, d_right_elem,
+                         d_left_side_number, d_right_side_number,
+                         d_Nx, d_Ny,
+                         n_quad1d, n_quad, n_p, num_sides, num_elem, t);
 
-        rk4_tempstorage(d_c, d_kstar, d_k2, 0.5, n_p, num_elem);
+        rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, 2, n_p, num_elem, NULL, NULL);
 
 
         // stage 3
-        eval_surface(d_kstar, d_left_riemann_rhs, d_right_riemann_rhs, 
-                     d_s_length, 
-                     d_V1x, d_V1y,
-                     d_V2x, d_V2y,
-                     d_V3x, d_V3y,
-                     d_left_elem, d_right_elem,
-                     d_left_side_number, d_right_side_number,
-                     d_Nx, d_Ny, 
-                     n_quad1d, n_quad, n_p, num_sides, num_elem, t);
-
-        eval_volume(d_kstar, d_quad_rhs, 
-                    d_xr, d_yr, d_xs, d_ys,
-                    n_quad, n_p, num_elem);
+        eval_volume_ftn(d_kstar, d_quad_rhs, 
+                        d_xr, d_yr, d_xs, d_ys,
+                        n_quad, n_p, num_elem);
 
-        eval_rhs_rk4(d_k3, d_quad_rhs, d_left_riemann_rhs, d_right_riemann_rhs, 
-                     d_elem_s1, d_elem_s2, d_elem_s3, 
-                     d_left_elem, d_J, dt, n_p, num_sides, num_elem);
+        eval_surface_ftn(d_kstar, d_quad_rhs, 
+                         d_s_length,
+                         d_V1x, d_V1y,
+                         d_V2x, d_V2y,
+                         d_V3x, d_V3y,
+                         d_left_elem, d_right_elem,
+                         d_left_side_number, d_right_side_number,
+                         d_Nx, d_Ny,
+                         n_quad1d, n_quad, n_p, num_sides, num_elem, t);
 
-        rk4_tempstorage(d_c, d_kstar, d_k3, 1.0, n_p, num_elem);
+        rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, 3, n_p, num_elem, NULL, NULL);
 
 
         // stage 4
-        eval_surface(d_kstar, d_left_riemann_rhs, d_right_riemann_rhs, 
-                         d_s_length, 
+        eval_volume_ftn(d_kstar, d_quad_rhs, 
+                        d_xr, d_yr, d_xs, d_ys,
+                        n_quad, n_p, num_elem);
+
+        eval_surface_ftn(d_kstar, d_quad_rhs, 
+                         d_s_length,
                          d_V1x, d_V1y,
                          d_V2x, d_V2y,
                          d_V3x, d_V3y,
                          d_left_elem, d_right_elem,
                          d_left_side_number, d_right_side_number,
-                         d_Nx, d_Ny, 
+                         d_Nx, d_Ny,
                          n_quad1d, n_quad, n_p, num_sides, num_elem, t);
 
-        eval_volume(d_kstar, d_quad_rhs, 
-                    d_xr, d_yr, d_xs, d_ys,
-                    n_quad, n_p, num_elem);
-
-        eval_rhs_rk4(d_k4, d_quad_rhs, d_left_riemann_rhs, d_right_riemann_rhs, 
-                     d_elem_s1, d_elem_s2, d_elem_s3, 
-                     d_left_elem, d_J, dt, n_p, num_sides, num_elem);
-
-        // combine them all
-        rk4(d_c, d_k1, d_k2, d_k3, d_k4, n_p, num_elem);
+        // combine them all, and find the next step's cfl limit
+        rk4_stage(d_c, d_kstar, d_k1, d_quad_rhs, d_J, dt, 4, n_p, num_elem, &min_dt, &max_l);
 
         //if (t - dt > 0.) {
             //check_convergence(d_c_prev, d_c, num_elem, n_p);
@@ -277,113 +500,393 @@ void time_integrate_rk4(int n_quad, int n_quad1d, int n_p, int n, int num_elem,
 
         //memcpy(d_c_prev, d_c, num_elem * n_p * 4 * sizeof(double));
     }
+}
+
+void time_integrate_rk4(int n_quad, int n_quad1d, int n_p, int n, int num_elem, int num_sides,
+                        double endtime, double min_r) {
+    double max_l, min_dt;
+
+    surface_ftn eval_surface_ftn;
+    volume_ftn  eval_volume_ftn;
+
+    dispatch_functions(&eval_surface_ftn, &eval_volume_ftn, n);
 
-    free(c);
-    free(max_lambda);
+    // find the cfl limit of each cell and the max value of lambda. after the
+    // first step the last stage finds them for the next one.
+    min_dt = eval_global_cfl(d_c, d_radius, &max_l, n_p, num_elem);
+
+    if (thread_backend == THREADS_TEAM) {
+        #pragma omp parallel
+        {
+            cpu_set_t allowed;
+
+            team_start(&allowed);
+            rk4_steps(eval_surface_ftn, eval_volume_ftn,
+                      n_quad, n_quad1d, n_p, n, num_elem, num_sides,
+                      endtime, min_dt, max_l);
+            team_end(&allowed);
+        }
+    } else {
+        rk4_steps(eval_surface_ftn, eval_volume_ftn,
+                  n_quad, n_quad1d, n_p, n, num_elem, num_sides,
+                  endtime, min_dt, max_l);
+    }
+}
+
+/***********************
+ * LOW STORAGE RK
+ ***********************/
+
+/* 2N storage runge-kutta schemes in williamson's form. each stage is
+ *
+ *      du = a_s * du + dt * L(u)
+ *      u  = u + b_s * du
+ *
+ * at time t + c_s * dt, so only u and one register du are kept instead of
+ * u, k* and the running sum rk4 needs.
+ */
+typedef struct {
+    int stages;
+    double a[5];
+    double b[5];
+    double c[5];
+    double cfl; // relative to the rk4 timestep
+} lsrk_scheme;
+
+// williamson (1980), three stages, third order
+lsrk_scheme lsrk3 = {3,
+    {0., -5. / 9., -153. / 128.},
+    {1. / 3., 15. / 16., 8. / 15.},
+    {0., 1. / 3., 3. / 4.},
+    0.8};
+
+// carpenter and kennedy (1994), five stages, fourth order. its stability
+// region is big enough to take a longer step than rk4.
+lsrk_scheme lsrk4 = {5,
+    {0.,
+     -567301805773.  / 1357537059087.,
+     -2404267990393. / 2016746695238.,
+     -3550918686646. / 2091501179385.,
+     -1275806237668. / 842570457699.},
+    {1432997174477. / 9575080441755.,
+     5161836677717. / 13612068292357.,
+     1720146321549. / 2090206949498.,
+     3134564353537. / 4481467310338.,
+     2277821191437. / 14882151754819.},
+    {0.,
+     1432997174477. / 9575080441755.,
+     2526269341429. / 6820363183471.,
+     2006345519317. / 3224310063776.,
+     2802321613138. / 2924317926251.},
+    1.4};
+
+/* low storage stage
+ *
+ * du = a * du + dt / J * rhs, then c = c + b * du, swept over tiles of
+ * elements like rk4_stage, which also returns the next step's cfl limit in
+ * min_dt if it isn't NULL.
+ * THREADS: num_elem / STAGE_TILE
+ */
+void lsrk_stage(double *c, double *du, double *quad_rhs, double *J,
+                double dt, double a, double b, int n_p, int num_elem,
+                double *min_dt, double *max_l) {
+    double step_dt = HUGE_VAL;
+    double step_l  = 0.;
+    int tile;
+
+    #pragma omp parallel for reduction(min:step_dt) reduction(max:step_l)
+    for (tile = 0; tile < num_elem; tile += STAGE_TILE) {
+        int end = (tile + STAGE_TILE < num_elem) ? tile + STAGE_TILE : num_elem;
+        int base[STAGE_TILE];
+        double scale[STAGE_TILE];
+        int idx, i, pos;
+
+        for (idx = tile; idx < end; idx++) {
+            base[idx - tile]  = coeff_base(idx, n_p);
+            scale[idx - tile] = 1. / J[idx] * dt;
+        }
+
+        for (i = 0; i < 4 * n_p; i++) {
+            for (idx = 0; idx < end - tile; idx++) {
+                pos = base[idx] + i * elem_block;
+                du[pos] = a * du[pos] + scale[idx] * quad_rhs[pos];
+                c[pos] += b * du[pos];
+            }
+        }
+
+        if (min_dt) {
+            stage_cfl(c, base, tile, end, n_p, &step_dt, &step_l);
+        }
+    }
+
+    if (min_dt) {
+        *min_dt = step_dt;
+        *max_l  = step_l;
+        wave_speed_fused++;
+    }
+}
+
+void time_integrate_lsrk(lsrk_scheme *scheme,
+                         int n_quad, int n_quad1d, int n_p, int n, int num_elem, int num_sides,
+                         double endtime, double min_r) {
+    int s;
+    double dt, t, max_l, min_dt;
+
+    surface_ftn eval_surface_ftn;
+    volume_ftn  eval_volume_ftn;
+
+    dispatch_functions(&eval_surface_ftn, &eval_volume_ftn, n);
+
+    // find the cfl limit of each cell and the max value of lambda. after the
+    // first step the last stage finds them for the next one.
+    min_dt = eval_global_cfl(d_c, d_radius, &max_l, n_p, num_elem);
+
+    t = 0;
+    while (t < endtime) {
+        sanity_check(d_c, num_elem, n_p);
+
+        // keep CFL condition
+        dt = scheme->cfl * 0.7 * min_dt / order_scale(n);
+        if (t + dt > endtime) {
+            dt = endtime - t;
+        }
+
+        printf(" > (%lf), t = %lf\n", max_l, t + dt);
+
+        for (s = 0; s < scheme->stages; s++) {
+            eval_volume_ftn(d_c, d_quad_rhs, 
+                            d_xr, d_yr, d_xs, d_ys,
+                            n_quad, n_p, num_elem);
+
+            eval_surface_ftn(d_c, d_quad_rhs, 
+                             d_s_length, 
+                             d_V1x, d_V1y,
+                             d_V2x, d_V2y,
+                             d_V3x, d_V3y,
+                             d_left_elem, d_right_elem,
+                             d_left_side_number, d_right_side_number,
+                             d_Nx, d_Ny, 
+                             n_quad1d, n_quad, n_p, num_sides, num_elem,
+                             t + scheme->c[s] * dt);
+
+            lsrk_stage(d_c, d_du, d_quad_rhs, d_J, dt,
+                       scheme->a[s], scheme->b[s], n_p, num_elem,
+                       (s == scheme->stages - 1) ? &min_dt : NULL, &max_l);
+        }
+
+        t = (t + dt < endtime) ? t + dt : endtime;
+    }
+}
+
+/***********************
+ * RK2 AND SSP-RK3
+ ***********************/
+
+/* runge-kutta schemes in shu-osher form that only need one register u*
+ * besides c. stage s evaluates the residual at u_(s-1) (c for the first
+ * stage, u* after that) at time t + c_s * dt and sets
+ *
+ *      u_s = alpha_s * c + beta_s * u_(s-1) + gamma_s * dt * L(u_(s-1))
+ *
+ * into u*, or into c for the last stage.
+ */
+typedef struct {
+    int stages;
+    double alpha[3];
+    double beta[3];
+    double gamma[3];
+    double c[3];
+    double cfl; // relative to the rk4 timestep
+} shu_osher_scheme;
+
+// the midpoint method, as time_integrate_rk2 does it on the gpu
+shu_osher_scheme rk2 = {2,
+    {1., 1.},
+    {0., 0.},
+    {0.5, 1.},
+    {0., 0.5},
+    0.5};
+
+// shu and osher (1988), three stages, third order, strong stability
+// preserving
+shu_osher_scheme ssprk3 = {3,
+    {1., 3. / 4., 1. / 3.},
+    {0., 1. / 4., 2. / 3.},
+    {1., 1. / 4., 2. / 3.},
+    {0., 1., 0.5},
+    0.8};
+
+/* shu-osher stage
+ *
+ * out = alpha * c + beta * u + gamma * dt / J * rhs, swept over tiles of
+ * elements like rk4_stage. out may be c or u. if min_dt isn't NULL the cfl
+ * limit for out is returned in it, as rk4_stage does.
+ * THREADS: num_elem / STAGE_TILE
+ */
+void shu_osher_stage(double *out, double *c, double *u, double *quad_rhs, double *J,
+                     double dt, double alpha, double beta, double gamma,
+                     int n_p, int num_elem, double *min_dt, double *max_l) {
+    double step_dt = HUGE_VAL;
+    double step_l  = 0.;
+    int tile;
+
+    #pragma omp parallel for reduction(min:step_dt) reduction(max:step_l)
+    for (tile = 0; tile < num_elem; tile += STAGE_TILE) {
+        int end = (tile + STAGE_TILE < num_elem) ? tile + STAGE_TILE : num_elem;
+        int base[STAGE_TILE];
+        double scale[STAGE_TILE];
+        int idx, i, pos;
+
+        for (idx = tile; idx < end; idx++) {
+            base[idx - tile]  = coeff_base(idx, n_p);
+            scale[idx - tile] = gamma / J[idx] * dt;
+        }
+
+        for (i = 0; i < 4 * n_p; i++) {
+            for (idx = 0; idx < end - tile; idx++) {
+                pos = base[idx] + i * elem_block;
+                out[pos] = alpha * c[pos] + beta * u[pos] + scale[idx] * quad_rhs[pos];
+            }
+        }
+
+        if (min_dt) {
+            stage_cfl(out, base, tile, end, n_p, &step_dt, &step_l);
+        }
+    }
+
+    if (min_dt) {
+        *min_dt = step_dt;
+        *max_l  = step_l;
+        wave_speed_fused++;
+    }
+}
+
+void time_integrate_shu_osher(shu_osher_scheme *scheme,
+                              int n_quad, int n_quad1d, int n_p, int n, int num_elem, int num_sides,
+                              double endtime, double min_r) {
+    int s;
+    double dt, t, max_l, min_dt;
+    double *u;
+
+    surface_ftn eval_surface_ftn;
+    volume_ftn  eval_volume_ftn;
+
+    dispatch_functions(&eval_surface_ftn, &eval_volume_ftn, n);
+
+    // find the cfl limit of each cell and the max value of lambda. after the
+    // first step the last stage finds them for the next one.
+    min_dt = eval_global_cfl(d_c, d_radius, &max_l, n_p, num_elem);
+
+    t = 0;
+    while (t < endtime) {
+        sanity_check(d_c, num_elem, n_p);
+
+        // keep CFL condition
+        dt = scheme->cfl * 0.7 * min_dt / order_scale(n);
+        if (t + dt > endtime) {
+            dt = endtime - t;
+        }
+
+        printf(" > (%lf), t = %lf\n", max_l, t + dt);
+
+        for (s = 0; s < scheme->stages; s++) {
+            u = s ? d_kstar : d_c;
+
+            eval_volume_ftn(u, d_quad_rhs, 
+                            d_xr, d_yr, d_xs, d_ys,
+                            n_quad, n_p, num_elem);
+
+            eval_surface_ftn(u, d_quad_rhs, 
+                             d_s_length, 
+                             d_V1x, d_V1y,
+                             d_V2x, d_V2y,
+                             d_V3x, d_V3y,
+                             d_left_elem, d_right_elem,
+                             d_left_side_number, d_right_side_number,
+                             d_Nx, d_Ny, 
+                             n_quad1d, n_quad, n_p, num_sides, num_elem,
+                             t + scheme->c[s] * dt);
+
+            shu_osher_stage((s == scheme->stages - 1) ? d_c : d_kstar, d_c, u,
+                            d_quad_rhs, d_J, dt,
+                            scheme->alpha[s], scheme->beta[s], scheme->gamma[s],
+                            n_p, num_elem,
+                            (s == scheme->stages - 1) ? &min_dt : NULL, &max_l);
+        }
+
+        t = (t + dt < endtime) ? t + dt : endtime;
+    }
 }
 
 /***********************
  * FORWARD EULER
  ***********************/
 
-void eval_rhs_fe(double *c, double *quad_rhs, double *left_riemann_rhs, double *right_riemann_rhs, 
-                 int *elem_s1, int *elem_s2, int *elem_s3,
-                 int *left_elem, double *J, 
-                 double dt, int n_p, int num_sides, int num_elem) {
+/* forward euler update
+ *
+ * c = c + dt / J * rhs, also finding the next step's cfl limit like
+ * rk4_stage.
+ * THREADS: num_elem
+ */
+void eval_rhs_fe(double *c, double *quad_rhs, double *J, 
+                 double dt, int n_p, int num_elem, double *min_dt, double *max_l) {
     int idx;
-    double s1_eqn1, s2_eqn1, s3_eqn1;
-    double s1_eqn2, s2_eqn2, s3_eqn2;
-    double s1_eqn3, s2_eqn3, s3_eqn3;
-    double s1_eqn4, s2_eqn4, s3_eqn4;
     double register_J;
-    int i, s1_idx, s2_idx, s3_idx;
+    double step_dt = HUGE_VAL;
+    double step_l  = 0.;
+    int i;
 
+    #pragma omp parallel for private(i, register_J) reduction(min:step_dt) reduction(max:step_l)
     for (idx = 0; idx < num_elem; idx++) {
+        int base = coeff_base(idx, n_p);
 
         register_J = J[idx];
 
-        // get the indicies for the riemann contributions for this element
-        s1_idx = elem_s1[idx];
-        s2_idx = elem_s2[idx];
-        s3_idx = elem_s3[idx];
-
-        for (i = 0; i < n_p; i++) {
-
-            // determine left or right pointing
-            if (idx == left_elem[s1_idx]) {
-                s1_eqn1 = left_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s1_idx];
-                s1_eqn2 = left_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s1_idx];
-                s1_eqn3 = left_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s1_idx];
-                s1_eqn4 = left_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s1_idx];
-            } else {
-                s1_eqn1 = right_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s1_idx];
-                s1_eqn2 = right_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s1_idx];
-                s1_eqn3 = right_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s1_idx];
-                s1_eqn4 = right_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s1_idx];
-            }
-
-            if (idx == left_elem[s2_idx]) {
-                s2_eqn1 = left_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s2_idx];
-                s2_eqn2 = left_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s2_idx];
-                s2_eqn3 = left_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s2_idx];
-                s2_eqn4 = left_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s2_idx];
-            } else {
-                s2_eqn1 = right_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s2_idx];
-                s2_eqn2 = right_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s2_idx];
-                s2_eqn3 = right_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s2_idx];
-                s2_eqn4 = right_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s2_idx];
-            }
-
-            if (idx == left_elem[s3_idx]) {
-                s3_eqn1 = left_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s3_idx];
-                s3_eqn2 = left_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s3_idx];
-                s3_eqn3 = left_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s3_idx];
-                s3_eqn4 = left_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s3_idx];
-            } else {
-                s3_eqn1 = right_riemann_rhs[num_sides * n_p * 0 + i * num_sides + s3_idx];
-                s3_eqn2 = right_riemann_rhs[num_sides * n_p * 1 + i * num_sides + s3_idx];
-                s3_eqn3 = right_riemann_rhs[num_sides * n_p * 2 + i * num_sides + s3_idx];
-                s3_eqn4 = right_riemann_rhs[num_sides * n_p * 3 + i * num_sides + s3_idx];
-            }
-
-            // calculate the coefficient c
-            c[num_elem * n_p * 0 + i * num_elem + idx] += 1. / register_J * dt * (quad_rhs[num_elem * n_p * 0 + i * num_elem + idx] + s1_eqn1 + s2_eqn1 + s3_eqn1);
-            c[num_elem * n_p * 1 + i * num_elem + idx] += 1. / register_J * dt * (quad_rhs[num_elem * n_p * 1 + i * num_elem + idx] + s1_eqn2 + s2_eqn2 + s3_eqn2);
-            c[num_elem * n_p * 2 + i * num_elem + idx] += 1. / register_J * dt * (quad_rhs[num_elem * n_p * 2 + i * num_elem + idx] + s1_eqn3 + s2_eqn3 + s3_eqn3);
-            c[num_elem * n_p * 3 + i * num_elem + idx] += 1. / register_J * dt * (quad_rhs[num_elem * n_p * 3 + i * num_elem + idx] + s1_eqn4 + s2_eqn4 + s3_eqn4);
+        // calculate the coefficient c
+        for (i = 0; i < 4 * n_p; i++) {
+            c[base + i * elem_block] += 1. / register_J * dt * quad_rhs[base + i * elem_block];
         }
+
+        stage_cfl(c, &base, idx, idx + 1, n_p, &step_dt, &step_l);
     }
+
+    *min_dt = step_dt;
+    *max_l  = step_l;
+    wave_speed_fused++;
 }
 
 // forward eulers
 void time_integrate_fe(int n_quad, int n_quad1d, int n_p, int n, 
               int num_elem, int num_sides, double endtime, double min_r) {
-    int i;
     double t, dt;
-    double *max_lambda;
-    double max_l;
+    double max_l, min_dt;
 
-    t = 0;
-    while (t < endtime) {
-        eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
+    surface_ftn eval_surface_ftn;
+    volume_ftn  eval_volume_ftn;
 
-        // find the max value of lambda
-        max_lambda = (double *) malloc(num_elem * sizeof(double));
-        memcpy(max_lambda, d_lambda, num_elem * sizeof(double));
-        max_l = max_lambda[0];
-        for (i = 0; i < num_elem; i++) {
-            max_l = (max_lambda[i] > max_l) ? max_lambda[i] : max_l;
-        }
-        free(max_lambda);
+    dispatch_functions(&eval_surface_ftn, &eval_volume_ftn, n);
+
+    // find the cfl limit of each cell and the max value of lambda. after the
+    // first step eval_rhs_fe finds them for the next one.
+    min_dt = eval_global_cfl(d_c, d_radius, &max_l, n_p, num_elem);
 
+    t = 0;
+    while (t < endtime) {
         // keep CFL condition
-        dt  = 0.7 * min_r / max_l /  (2. * n + 1.);
+        dt  = 0.7 * min_dt / order_scale(n);
+        if (t + dt > endtime) {
+            dt = endtime - t;
+        }
 
         // add to total time
-        t += dt;
+        t = (t + dt < endtime) ? t + dt : endtime;
         printf(" > (%lf), t = %lf\n", max_l, t);
 
-        eval_surface(d_c, d_left_riemann_rhs, d_right_riemann_rhs, 
+        eval_volume_ftn(d_c, d_quad_rhs, 
+                        d_xr, d_yr, d_xs, d_ys,
+                        n_quad, n_p, num_elem);
+
+        eval_surface_ftn(d_c, d_quad_rhs, 
                          d_s_length, 
                          d_V1x, d_V1y,
                          d_V2x, d_V2y,
@@ -393,12 +896,509 @@ void time_integrate_fe(int n_quad, int n_quad1d, int n_p, int n,
                          d_Nx, d_Ny, 
                          n_quad1d, n_quad, n_p, num_sides, num_elem, t);
 
-        eval_volume(d_c, d_quad_rhs, 
-                        d_xr, d_yr, d_xs, d_ys,
-                        n_quad, n_p, num_elem);
+        eval_rhs_fe(d_c, d_quad_rhs, d_J, dt, n_p, num_elem, &min_dt, &max_l);
+    }
+}
+
+/***********************
+ * MULTIRATE LOCAL TIME STEPPING
+ ***********************/
+
+/* multirate adams-bashforth (gear and wells, 1984), third order in every
+ * class. each element gets a dt class k from its own inscribed radius and
+ * wave speed and steps with dt_k = 2^k * dt_0, so a macro step of
+ * 2^(K - 1) * dt_0 is 2^(K - 1 - k) steps of class k. the macro step is cut
+ * into micro steps of dt_0; at micro step m the classes whose step starts
+ * there (k up to the trailing zeros of m) are active and take their whole
+ * step at once:
+ *
+ *      L = rhs / J at t
+ *      c = c + integral from t to t + dt_k of the quadratic through the
+ *              class's last three L
+ *
+ * the residual of an active element reads its neighbors at t. a neighbor in
+ * the same or a finer class is at t already. a coarser neighbor has stepped
+ * past t, to the end of its step, so it's taken back along its own quadratic
+ *
+ *      u(t) = c - integral from t to the end of its step
+ *
+ * which is as accurate as the step itself. each side of a class interface
+ * integrates the flux through it with its own quadratic, so mass is only
+ * conserved there to the order of the scheme.
+ *
+ * the history is filled in by running ssprk3 at dt_0 through the first two
+ * macro steps and keeping L at each class's step times.
+ */
+#define MAX_CLASSES 16
+
+// the most dt classes time_integrate_lts sorts the elements into; with one
+// it's plain third order adams-bashforth
+int max_classes = 8;
+
+// adams-bashforth's stability region is much smaller than rk4's
+#define LTS_CFL 0.2
+
+typedef struct {
+    int num_classes;
+    int *elem_class;    // dt class of each element
+
+    // the elements sorted by class. elem_ends[L] elements have class L or
+    // lower: the ones a level L micro step updates.
+    int *elems;
+    int elem_ends[MAX_CLASSES];
+
+    // the elements sorted by the lowest class among themselves and their
+    // neighbors. needed_ends[L] of them are read by a level L residual.
+    int *needed;
+    int needed_ends[MAX_CLASSES];
+
+    // every side color sorted by the lower class of its two elements; a
+    // level L residual runs color j of group k up to side_ends[L][k][j]
+    int *sides;
+    int side_ends[MAX_CLASSES][4][MAX_COLORS];
+
+    // each class's history: the slot in d_hist of its newest L, how many
+    // are filled in, the times they were taken at (newest first) and the
+    // time the class's coefficients are at
+    int head[MAX_CLASSES];
+    int count[MAX_CLASSES];
+    double times[MAX_CLASSES][3];
+    double end[MAX_CLASSES];
+} lts_state;
+
+/* sort by class
+ *
+ * puts first through first + num - 1 into list by their key, keeping their
+ * order within a class so the list stays in mesh order, and the number with
+ * key L or lower into ends[L].
+ */
+void sort_by_class(int *key, int first, int num, int num_classes, int *list, int *ends) {
+    int i, k;
+    int next[MAX_CLASSES];
+
+    for (k = 0; k < num_classes; k++) {
+        ends[k] = 0;
+    }
+    for (i = first; i < first + num; i++) {
+        ends[key[i]]++;
+    }
+    for (k = 1; k < num_classes; k++) {
+        ends[k] += ends[k - 1];
+    }
+
+    for (k = 0; k < num_classes; k++) {
+        next[k] = k ? ends[k - 1] : 0;
+    }
+    for (i = first; i < first + num; i++) {
+        list[next[key[i]]++] = i;
+    }
+}
+
+/* init lts
+ *
+ * sorts the elements into dt classes by the wave speeds in lambda and builds
+ * the element and side lists for each level.
+ */
+void init_lts(lts_state *lts, double *lambda, int num_elem, int num_sides) {
+    int i, j, k, left, right, level;
+    int ends[MAX_CLASSES];
+    int *reach, *side_class;
+    double dt_min;
+
+    lts->elem_class = (int *) malloc(num_elem * sizeof(int));
+    lts->elems      = (int *) malloc(num_elem * sizeof(int));
+    lts->needed     = (int *) malloc(num_elem * sizeof(int));
+    lts->sides      = (int *) malloc(num_sides * sizeof(int));
+    reach      = (int *) malloc(num_elem * sizeof(int));
+    side_class = (int *) malloc(num_sides * sizeof(int));
+
+    // each element's own timestep, relative to the smallest
+    dt_min = d_radius[0] / lambda[0];
+    for (i = 1; i < num_elem; i++) {
+        dt_min = (d_radius[i] / lambda[i] < dt_min) ? d_radius[i] / lambda[i] : dt_min;
+    }
+
+    lts->num_classes = 1;
+    for (i = 0; i < num_elem; i++) {
+        k = (int) floor(log2(d_radius[i] / lambda[i] / dt_min));
+        k = (k < max_classes - 1) ? k : max_classes - 1;
+        lts->elem_class[i] = k;
+        lts->num_classes = (k + 1 > lts->num_classes) ? k + 1 : lts->num_classes;
+    }
+
+    // a side runs when either of its elements does, and an element is read
+    // when it or any of its neighbors does
+    for (i = 0; i < num_elem; i++) {
+        reach[i] = lts->elem_class[i];
+    }
+    for (i = 0; i < num_sides; i++) {
+        left  = d_left_elem[i];
+        right = d_right_elem[i];
+        side_class[i] = lts->elem_class[left];
+        if (right >= 0) {
+            side_class[i] = (lts->elem_class[right] < side_class[i]) ? lts->elem_class[right] : side_class[i];
+            reach[left]   = (lts->elem_class[right] < reach[left])   ? lts->elem_class[right] : reach[left];
+            reach[right]  = (lts->elem_class[left]  < reach[right])  ? lts->elem_class[left]  : reach[right];
+        }
+    }
+
+    sort_by_class(lts->elem_class, 0, num_elem, lts->num_classes, lts->elems, lts->elem_ends);
+    sort_by_class(reach, 0, num_elem, lts->num_classes, lts->needed, lts->needed_ends);
+
+    for (k = 0; k < 4; k++) {
+        for (j = 0; j < num_colors[k]; j++) {
+            sort_by_class(side_class, color_ranges[k][j],
+                          color_ranges[k][j + 1] - color_ranges[k][j], lts->num_classes,
+                          lts->sides + color_ranges[k][j], ends);
+            for (level = 0; level < lts->num_classes; level++) {
+                lts->side_ends[level][k][j] = color_ranges[k][j] + ends[level];
+            }
+        }
+    }
+
+    for (k = 0; k < lts->num_classes; k++) {
+        lts->head[k]  = 0;
+        lts->count[k] = 0;
+        lts->end[k]   = 0.;
+    }
+
+    free(reach);
+    free(side_class);
+}
+
+void free_lts(lts_state *lts) {
+    free(lts->elem_class);
+    free(lts->elems);
+    free(lts->needed);
+    free(lts->sides);
+}
+
+/* lts dt
+ *
+ * dt_0 for the wave speeds in lambda: the largest that keeps every element
+ * within the CFL condition at its class's timestep.
+ */
+double lts_dt(lts_state *lts, double *lambda, int n, int num_elem) {
+    int i;
+    double dt = d_radius[0] / lambda[0];
+
+    #pragma omp parallel for reduction(min:dt)
+    for (i = 0; i < num_elem; i++) {
+        double elem_dt = d_radius[i] / lambda[i] / (1 << lts->elem_class[i]);
+        dt = (elem_dt < dt) ? elem_dt : dt;
+    }
+
+    return LTS_CFL * 0.7 * dt / order_scale(n);
+}
+
+/* lts push
+ *
+ * starts a step of dt_k at time t for every class up to level: the new L
+ * goes in the oldest slot.
+ */
+void lts_push(lts_state *lts, int level, double t, double dt) {
+    int k;
+
+    for (k = 0; k <= level; k++) {
+        lts->head[k]     = (lts->head[k] + 1) % 3;
+        lts->count[k]    = (lts->count[k] < 3) ? lts->count[k] + 1 : 3;
+        lts->times[k][2] = lts->times[k][1];
+        lts->times[k][1] = lts->times[k][0];
+        lts->times[k][0] = t;
+        lts->end[k]      = t + (1 << k) * dt;
+    }
+}
+
+/* adams-bashforth weights
+ *
+ * the integrals from a to b of the lagrange polynomials through the count
+ * newest history times of class k, so that the sum of weight[k][j] times
+ * the L in slot[k][j] integrates the polynomial through them. two point
+ * gauss quadrature is exact for the quadratic. the weights of history that
+ * hasn't been filled in yet are zero.
+ */
+void lts_weights(lts_state *lts, int k, double a, double b,
+                 double weight[][3], int slot[][3]) {
+    int i, j, q;
+    double x, l;
+    double *times = lts->times[k];
+
+    for (j = 0; j < 3; j++) {
+        slot[k][j]   = (lts->head[k] + 3 - j) % 3;
+        weight[k][j] = 0.;
+        if (j >= lts->count[k]) {
+            continue;
+        }
+        for (q = -1; q <= 1; q += 2) {
+            x = (a + b) / 2. + q * (b - a) / 2. / sqrt(3.);
+            l = 1.;
+            for (i = 0; i < lts->count[k]; i++) {
+                if (i != j) {
+                    l *= (x - times[i]) / (times[j] - times[i]);
+                }
+            }
+            weight[k][j] += (b - a) / 2. * l;
+        }
+    }
+}
 
-        eval_rhs_fe(d_c, d_quad_rhs, d_left_riemann_rhs, d_right_riemann_rhs, 
-                    d_elem_s1, d_elem_s2, d_elem_s3, 
-                    d_left_elem, d_J, dt, n_p, num_sides, num_elem);
+/* lts update
+ *
+ * for the first num elements of elems: L = rhs / J into the newest slot of
+ * the element's class, then c += sum over j of weight[k][j] * L_j. with all
+ * the weights zero this just records L. swept over tiles of the list like
+ * rk4_stage.
+ * THREADS: num / STAGE_TILE
+ */
+void lts_update(double *c, double *quad_rhs, double *J, int *elem_class, int *elems,
+                int num, double weight[][3], int slot[][3], int n_p) {
+    int tile;
+
+    #pragma omp parallel for
+    for (tile = 0; tile < num; tile += STAGE_TILE) {
+        int end = (tile + STAGE_TILE < num) ? tile + STAGE_TILE : num;
+        int base[STAGE_TILE];
+        double scale[STAGE_TILE];
+        double *w[STAGE_TILE];
+        int *h[STAGE_TILE];
+        double l;
+        int e, i, k, pos;
+
+        for (e = tile; e < end; e++) {
+            k = elem_class[elems[e]];
+            base[e - tile]  = coeff_base(elems[e], n_p);
+            scale[e - tile] = 1. / J[elems[e]];
+            w[e - tile]     = weight[k];
+            h[e - tile]     = slot[k];
+        }
+
+        for (i = 0; i < 4 * n_p; i++) {
+            for (e = 0; e < end - tile; e++) {
+                pos = base[e] + i * elem_block;
+                l   = scale[e] * quad_rhs[pos];
+                d_hist[h[e][0]][pos] = l;
+                c[pos] += w[e][0] * l
+                        + w[e][1] * d_hist[h[e][1]][pos]
+                        + w[e][2] * d_hist[h[e][2]][pos];
+            }
+        }
+    }
+}
+
+/* lts interpolate
+ *
+ * the solution at the current micro step for the first num elements of
+ * needed: c itself for the classes up to level, which are there, and
+ * c - sum over j of weight[k][j] * L_j, back from the end of their step, for
+ * the coarser ones.
+ * THREADS: num / STAGE_TILE
+ */
+void lts_interpolate(double *u, double *c, int *elem_class, int *needed, int num, int level,
+                     double weight[][3], int slot[][3], int n_p) {
+    int tile;
+
+    #pragma omp parallel for
+    for (tile = 0; tile < num; tile += STAGE_TILE) {
+        int end = (tile + STAGE_TILE < num) ? tile + STAGE_TILE : num;
+        int base[STAGE_TILE];
+        double *w[STAGE_TILE];
+        int *h[STAGE_TILE];
+        double zero[3] = {0., 0., 0.};
+        int e, i, k, pos;
+
+        for (e = tile; e < end; e++) {
+            k = elem_class[needed[e]];
+            base[e - tile] = coeff_base(needed[e], n_p);
+            w[e - tile]    = (k <= level) ? zero : weight[k];
+            h[e - tile]    = slot[k];
+        }
+
+        for (i = 0; i < 4 * n_p; i++) {
+            for (e = 0; e < end - tile; e++) {
+                pos = base[e] + i * elem_block;
+                u[pos] = c[pos] - w[e][0] * d_hist[h[e][0]][pos]
+                                - w[e][1] * d_hist[h[e][1]][pos]
+                                - w[e][2] * d_hist[h[e][2]][pos];
+            }
+        }
+    }
+}
+
+/* lts level
+ *
+ * the coarsest class active at micro step m: the number of trailing zeros
+ * of m, and every class at the start of a macro step.
+ */
+int lts_level(int m, int num_classes) {
+    int level = 0;
+
+    if (m == 0) {
+        return num_classes - 1;
+    }
+    while (!(m & 1)) {
+        m >>= 1;
+        level++;
+    }
+    return level;
+}
+
+void time_integrate_lts(int n_quad, int n_quad1d, int n_p, int n, int num_elem, int num_sides,
+                        double endtime, double min_r) {
+    lts_state lts;
+    int k, m, s, level, micro_steps, macro_step;
+    double t, tm, dt, max_l;
+    double weight[MAX_CLASSES][3];
+    int slot[MAX_CLASSES][3];
+    double *u;
+
+    surface_ftn eval_surface_ftn;
+    volume_ftn  eval_volume_ftn;
+
+    dispatch_functions(&eval_surface_ftn, &eval_volume_ftn, n);
+
+    eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
+    init_lts(&lts, d_lambda, num_elem, num_sides);
+
+    for (k = 0; k < lts.num_classes; k++) {
+        printf(" ? dt class %i: %i elements\n", k,
+               lts.elem_ends[k] - (k ? lts.elem_ends[k - 1] : 0));
+    }
+
+    micro_steps = 1 << (lts.num_classes - 1);
+
+    t = 0;
+    macro_step = 0;
+    while (t < endtime) {
+        sanity_check(d_c, num_elem, n_p);
+
+        // find the max value of lambda
+        eval_global_lambda(d_c, d_lambda, n_quad, n_p, num_elem);
+        max_l = find_max_lambda(d_lambda, num_elem);
+
+        // keep CFL condition for every class
+        dt = lts_dt(&lts, d_lambda, n, num_elem);
+        if (t + micro_steps * dt > endtime) {
+            dt = (endtime - t) / micro_steps;
+        }
+
+        printf(" > (%lf), t = %lf\n", max_l, t + micro_steps * dt);
+
+        for (m = 0; m < micro_steps; m++) {
+            level = lts_level(m, lts.num_classes);
+            tm    = t + m * dt;
+
+            lts_push(&lts, level, tm, dt);
+
+            if (macro_step < 2) {
+                // startup: ssprk3 on every element, keeping L at the first
+                // stage for the classes that step here. the weights of the
+                // empty integral are zero, so lts_update only records L.
+                for (k = 0; k <= level; k++) {
+                    lts_weights(&lts, k, tm, tm, weight, slot);
+                }
+                for (s = 0; s < ssprk3.stages; s++) {
+                    u = s ? d_kstar : d_c;
+
+                    eval_volume_ftn(u, d_quad_rhs,
+                                    d_xr, d_yr, d_xs, d_ys,
+                                    n_quad, n_p, num_elem);
+
+                    eval_surface_ftn(u, d_quad_rhs,
+                                     d_s_length,
+                                     d_V1x, d_V1y,
+                                     d_V2x, d_V2y,
+                                     d_V3x, d_V3y,
+                                     d_left_elem, d_right_elem,
+                                     d_left_side_number, d_right_side_number,
+                                     d_Nx, d_Ny,
+                                     n_quad1d, n_quad, n_p, num_sides, num_elem,
+                                     tm + ssprk3.c[s] * dt);
+
+                    if (s == 0) {
+                        lts_update(d_c, d_quad_rhs, d_J, lts.elem_class, lts.elems,
+                                   lts.elem_ends[level], weight, slot, n_p);
+                    }
+
+                    shu_osher_stage((s == ssprk3.stages - 1) ? d_c : d_kstar, d_c, u,
+                                    d_quad_rhs, d_J, dt,
+                                    ssprk3.alpha[s], ssprk3.beta[s], ssprk3.gamma[s],
+                                    n_p, num_elem, NULL, NULL);
+                }
+                continue;
+            }
+
+            // the active classes integrate over their step, the coarser
+            // ones back from the end of theirs
+            for (k = 0; k < lts.num_classes; k++) {
+                lts_weights(&lts, k, tm, lts.end[k], weight, slot);
+            }
+
+            // every class is at tm at the start of a macro step
+            u = d_c;
+            if (level < lts.num_classes - 1) {
+                u = d_kstar;
+                lts_interpolate(u, d_c, lts.elem_class, lts.needed, lts.needed_ends[level],
+                                level, weight, slot, n_p);
+            }
+
+            d_elem_list = lts.elems;
+            d_side_list = lts.sides;
+            memcpy(color_ends, lts.side_ends[level], sizeof(color_ends));
+
+            eval_volume_ftn(u, d_quad_rhs,
+                            d_xr, d_yr, d_xs, d_ys,
+                            n_quad, n_p, lts.elem_ends[level]);
+
+            eval_surface_ftn(u, d_quad_rhs,
+                             d_s_length,
+                             d_V1x, d_V1y,
+                             d_V2x, d_V2y,
+                             d_V3x, d_V3y,
+                             d_left_elem, d_right_elem,
+                             d_left_side_number, d_right_side_number,
+                             d_Nx, d_Ny,
+                             n_quad1d, n_quad, n_p, num_sides, num_elem, tm);
+
+            d_elem_list = NULL;
+            d_side_list = NULL;
+
+            lts_update(d_c, d_quad_rhs, d_J, lts.elem_class, lts.elems,
+                       lts.elem_ends[level], weight, slot, n_p);
+        }
+
+        t = (t + micro_steps * dt < endtime) ? t + micro_steps * dt : endtime;
+        macro_step++;
+    }
+
+    free_lts(&lts);
+}
+
+/* time integrate
+ *
+ * runs the selected time integrator through endtime.
+ */
+void time_integrate(int n_quad, int n_quad1d, int n_p, int n, int num_elem, int num_sides,
+                    double endtime, double min_r) {
+    switch (time_integrator) {
+        case INTEGRATOR_LSRK3:
+            time_integrate_lsrk(&lsrk3, n_quad, n_quad1d, n_p, n, num_elem, num_sides, endtime, min_r);
+            break;
+        case INTEGRATOR_LSRK4:
+            time_integrate_lsrk(&lsrk4, n_quad, n_quad1d, n_p, n, num_elem, num_sides, endtime, min_r);
+            break;
+        case INTEGRATOR_RK2:
+            time_integrate_shu_osher(&rk2, n_quad, n_quad1d, n_p, n, num_elem, num_sides, endtime, min_r);
+            break;
+        case INTEGRATOR_SSPRK3:
+            time_integrate_shu_osher(&ssprk3, n_quad, n_quad1d, n_p, n, num_elem, num_sides, endtime, min_r);
+            break;
+        case INTEGRATOR_FE:
+            time_integrate_fe(n_quad, n_quad1d, n_p, n, num_elem, num_sides, endtime, min_r);
+            break;
+        case INTEGRATOR_LTS:
+            time_integrate_lts(n_quad, n_quad1d, n_p, n, num_elem, num_sides, endtime, min_r);
+            break;
+        default:
+            time_integrate_rk4(n_quad, n_quad1d, n_p, n, num_elem, num_sides, endtime, min_r);
     }
 }